@@ -33,6 +33,11 @@ public class Flow : ModuleRules
 				"MessageLog",
 				"UnrealEd"
 			});
+
+			PrivateDependencyModuleNames.AddRange(new[]
+			{
+				"DerivedDataCache"
+			});
 		}
 	}
 }
\ No newline at end of file
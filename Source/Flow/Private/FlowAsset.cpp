@@ -5,16 +5,31 @@
 #include "FlowMessageLog.h"
 #include "FlowModule.h"
 #include "FlowSettings.h"
+#include "FlowStats.h"
 #include "FlowSubsystem.h"
+#include "FlowTrace.h"
 
 #include "Nodes/FlowNode.h"
 #include "Nodes/Route/FlowNode_CustomInput.h"
+#include "Nodes/Route/FlowNode_CustomOutput.h"
+#include "Nodes/Route/FlowNode_Finish.h"
 #include "Nodes/Route/FlowNode_Start.h"
 #include "Nodes/Route/FlowNode_SubGraph.h"
 
 #include "Engine/World.h"
+#include "Misc/ScopeExit.h"
+#include "Misc/SecureHash.h"
 #include "Serialization/MemoryReader.h"
 #include "Serialization/MemoryWriter.h"
+#include "UObject/ObjectSaveContext.h"
+
+#if WITH_EDITOR
+#include "DerivedDataCacheInterface.h"
+#endif
+
+#if CSV_PROFILER
+static int32 GFlowDispatchDepth = 0;
+#endif
 
 #if WITH_EDITOR
 FString UFlowAsset::ValidationError_NodeClassNotAllowed = TEXT("Node class {0} is not allowed in this asset.");
@@ -23,13 +38,20 @@ FString UFlowAsset::ValidationError_NodeClassNotAllowed = TEXT("Node class {0} i
 UFlowAsset::UFlowAsset(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 	, bWorldBound(true)
+	, SharedInstanceScope(EFlowSharedInstanceScope::None)
 #if WITH_EDITOR
 	, FlowGraph(nullptr)
 #endif
 	, AllowedNodeClasses({UFlowNode::StaticClass()})
 	, AllowedInSubgraphNodeClasses({UFlowNode_SubGraph::StaticClass()})
 	, bStartNodePlacedAsGhostNode(false)
+	, bInlineOnCook(false)
+#if WITH_EDITORONLY_DATA
+	, bGenerateNativeCode(false)
+#endif
+	, NativeGraph(nullptr)
 	, TemplateAsset(nullptr)
+	, bSharedInstance(false)
 	, FinishPolicy(EFlowFinishPolicy::Keep)
 {
 	if (!AssetGuid.IsValid())
@@ -84,6 +106,18 @@ EDataValidationResult UFlowAsset::ValidateAsset(FFlowMessageLog& MessageLog)
 				MessageLog.Error(*ErrorMsg, Node.Value);
 			}
 			
+			for (const FFlowParameterBinding& Binding : Node.Value->GetParameterBindings())
+			{
+				if (FFlowParameter::Find(Parameters, Binding.ParameterName) == nullptr)
+				{
+					MessageLog.Error(*FString::Printf(TEXT("Property %s is bound to parameter %s, which isn't declared by the Flow Asset"), *Binding.PropertyName.ToString(), *Binding.ParameterName.ToString()), Node.Value);
+				}
+				if (Node.Value->GetClass()->FindPropertyByName(Binding.PropertyName) == nullptr)
+				{
+					MessageLog.Error(*FString::Printf(TEXT("Parameter %s is bound to property %s, which doesn't exist"), *Binding.ParameterName.ToString(), *Binding.PropertyName.ToString()), Node.Value);
+				}
+			}
+
 			Node.Value->ValidationLog.Messages.Empty();
 			if (Node.Value->ValidateNode() == EDataValidationResult::Invalid)
 			{
@@ -273,6 +307,12 @@ void UFlowAsset::HarvestNodeConnections()
 
 UFlowNode* UFlowAsset::GetDefaultEntryNode() const
 {
+	const FFlowCookedGraph& Graph = GetCookedGraph();
+	if (Graph.IsValid())
+	{
+		return Graph.NodeGuids.IsValidIndex(Graph.DefaultEntryNode) ? Nodes.FindRef(Graph.NodeGuids[Graph.DefaultEntryNode]) : nullptr;
+	}
+
 	UFlowNode* FirstStartNode = nullptr;
 
 	for (const TPair<FGuid, UFlowNode*>& Node : Nodes)
@@ -341,6 +381,376 @@ UFlowNode_CustomInput* UFlowAsset::TryFindCustomInputNodeByEventName(const FName
 	return nullptr;
 }
 
+#if WITH_EDITOR
+void UFlowAsset::PreSave(FObjectPreSaveContext SaveContext)
+{
+	Super::PreSave(SaveContext);
+
+	ClearCookedData();
+	if (SaveContext.IsCooking())
+	{
+		BuildCookedData();
+	}
+}
+
+void UFlowAsset::PostSave(FObjectPostSaveContext SaveContext)
+{
+	Super::PostSave(SaveContext);
+
+	// inlined nodes exist only in cooked data, editor keeps working on the original graph
+	if (SaveContext.IsCooking())
+	{
+		ClearCookedData();
+	}
+}
+
+void UFlowAsset::BuildCookedData()
+{
+	InlineSubGraphs();
+	BuildCookedGraph();
+}
+
+void UFlowAsset::ClearCookedData()
+{
+	ClearInlinedSubGraphs();
+	CookedGraph.Reset();
+}
+
+void UFlowAsset::InlineSubGraphs()
+{
+	for (const TPair<FGuid, UFlowNode*>& Node : Nodes)
+	{
+		const UFlowNode_SubGraph* SubGraphNode = Cast<UFlowNode_SubGraph>(Node.Value);
+		if (SubGraphNode && !SubGraphNode->Asset.IsNull())
+		{
+			const UFlowAsset* SubGraphAsset = SubGraphNode->Asset.LoadSynchronous();
+			if (SubGraphAsset && CanInlineSubGraph(SubGraphNode, SubGraphAsset))
+			{
+				InlineSubGraph(SubGraphNode, SubGraphAsset);
+			}
+		}
+	}
+}
+
+bool UFlowAsset::CanInlineSubGraph(const UFlowNode_SubGraph* SubGraphNode, const UFlowAsset* SubGraphAsset) const
+{
+	// inlined nodes are executed by this asset instance, so custom asset classes would lose their logic
+	if (!SubGraphAsset->bInlineOnCook || SubGraphAsset == this || SubGraphAsset->GetClass() != GetClass())
+	{
+		return false;
+	}
+
+	// inlined nodes would read parameters of this asset, instead of SubGraph defaults and overrides of the SubGraph node
+	if (SubGraphAsset->Parameters.Num() > 0 || SubGraphNode->Parameters.Num() > 0)
+	{
+		return false;
+	}
+
+	if (SubGraphAsset->Nodes.Num() > UFlowSettings::Get()->MaxInlinedSubGraphNodes)
+	{
+		return false;
+	}
+
+	for (const TPair<FGuid, UFlowNode*>& Node : SubGraphAsset->Nodes)
+	{
+		// nested SubGraphs stay separate instances, as their nodes would require another remapping of guids
+		if (Node.Value == nullptr || Node.Value->IsA<UFlowNode_SubGraph>() || Node.Value->GetParameterBindings().Num() > 0)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void UFlowAsset::InlineSubGraph(const UFlowNode_SubGraph* SubGraphNode, const UFlowAsset* SubGraphAsset)
+{
+	const FGuid SubGraphGuid = SubGraphNode->GetGuid();
+
+	FFlowInlinedSubGraph InlinedSubGraph;
+	InlinedSubGraph.SubGraphNodeGuid = SubGraphGuid;
+	InlinedSubGraph.Asset = SubGraphAsset;
+
+	// guids are combined with the SubGraph node guid, so every cook produces identical SaveGame records
+	// Custom Outputs and Finish nodes are replaced with connections of the SubGraph node output pins
+	auto ResolveConnection = [&](const FConnectedPin& Connection, FConnectedPin& OutConnection)
+	{
+		const UFlowNode* LinkedNode = SubGraphAsset->GetNode(Connection.NodeGuid);
+		if (LinkedNode == nullptr)
+		{
+			return false;
+		}
+
+		if (const UFlowNode_CustomOutput* CustomOutput = Cast<UFlowNode_CustomOutput>(LinkedNode))
+		{
+			const FConnectedPin* ParentConnection = SubGraphNode->Connections.Find(CustomOutput->GetEventName());
+			OutConnection = ParentConnection ? *ParentConnection : FConnectedPin();
+			return ParentConnection != nullptr;
+		}
+
+		if (LinkedNode->IsA<UFlowNode_Finish>())
+		{
+			const FConnectedPin* ParentConnection = SubGraphNode->Connections.Find(UFlowNode_SubGraph::FinishPin.PinName);
+			OutConnection = ParentConnection ? *ParentConnection : FConnectedPin();
+			return ParentConnection != nullptr;
+		}
+
+		OutConnection = FConnectedPin(FGuid::Combine(SubGraphGuid, Connection.NodeGuid), Connection.PinName);
+		return true;
+	};
+
+	auto AddEntry = [&](const FName& PinName, const UFlowNode* EntryNode)
+	{
+		for (const TPair<FName, FConnectedPin>& Connection : EntryNode->Connections)
+		{
+			FConnectedPin Entry;
+			if (ResolveConnection(Connection.Value, Entry))
+			{
+				InlinedSubGraph.Entries.Add(PinName, Entry);
+			}
+			break;
+		}
+	};
+
+	if (const UFlowNode* StartNode = SubGraphAsset->GetDefaultEntryNode())
+	{
+		AddEntry(UFlowNode_SubGraph::StartPin.PinName, StartNode);
+	}
+
+	for (const TPair<FGuid, UFlowNode*>& Node : SubGraphAsset->Nodes)
+	{
+		if (const UFlowNode_CustomInput* CustomInput = Cast<UFlowNode_CustomInput>(Node.Value))
+		{
+			if (!CustomInput->GetEventName().IsNone())
+			{
+				AddEntry(CustomInput->GetEventName(), CustomInput);
+			}
+			continue;
+		}
+
+		if (Node.Value->IsA<UFlowNode_Start>() || Node.Value->IsA<UFlowNode_CustomOutput>() || Node.Value->IsA<UFlowNode_Finish>())
+		{
+			continue;
+		}
+
+		const FGuid InlinedGuid = FGuid::Combine(SubGraphGuid, Node.Key);
+
+		UFlowNode* InlinedNode = DuplicateObject<UFlowNode>(Node.Value, this);
+		InlinedNode->SetGuid(InlinedGuid);
+		InlinedNode->GraphNode = nullptr;
+
+		TMap<FName, FConnectedPin> InlinedConnections;
+		for (const TPair<FName, FConnectedPin>& Connection : Node.Value->Connections)
+		{
+			FConnectedPin InlinedConnection;
+			if (ResolveConnection(Connection.Value, InlinedConnection))
+			{
+				InlinedConnections.Add(Connection.Key, InlinedConnection);
+			}
+		}
+		InlinedNode->SetConnections(InlinedConnections);
+
+		InlinedNodes.Add(InlinedGuid, InlinedNode);
+		InlinedSubGraph.NodeGuids.Add(InlinedGuid, Node.Key);
+	}
+
+	InlinedSubGraphs.Emplace(InlinedSubGraph);
+}
+
+void UFlowAsset::ClearInlinedSubGraphs()
+{
+	for (const TPair<FGuid, UFlowNode*>& InlinedNode : InlinedNodes)
+	{
+		if (InlinedNode.Value)
+		{
+			InlinedNode.Value->MarkAsGarbage();
+		}
+	}
+
+	InlinedNodes.Empty();
+	InlinedSubGraphs.Empty();
+}
+#endif
+
+bool UFlowAsset::ResolveInlinedConnection(FConnectedPin& Connection) const
+{
+	// SubGraph might be connected directly to another inlined SubGraph, depth is limited to avoid looping on cycles
+	for (int32 Depth = 0; Depth <= InlinedSubGraphs.Num(); Depth++)
+	{
+		const FGuid& LinkedGuid = Connection.NodeGuid;
+		const FFlowInlinedSubGraph* InlinedSubGraph = InlinedSubGraphs.FindByPredicate([&LinkedGuid](const FFlowInlinedSubGraph& Other)
+		{
+			return Other.SubGraphNodeGuid == LinkedGuid;
+		});
+
+		if (InlinedSubGraph == nullptr)
+		{
+			return true;
+		}
+
+		const FConnectedPin* Entry = InlinedSubGraph->Entries.Find(Connection.PinName);
+		if (Entry == nullptr)
+		{
+			return false;
+		}
+
+		Connection = *Entry;
+	}
+
+	return true;
+}
+
+void UFlowAsset::RedirectInlinedConnections(UFlowNode* Node) const
+{
+	for (auto ConnectionIt = Node->Connections.CreateIterator(); ConnectionIt; ++ConnectionIt)
+	{
+		if (!ResolveInlinedConnection(ConnectionIt->Value))
+		{
+			ConnectionIt.RemoveCurrent();
+		}
+	}
+}
+
+void UFlowAsset::Serialize(FArchive& Ar)
+{
+	Super::Serialize(Ar);
+
+	// compact graph is written only to cooked packages
+	if (Ar.IsPersistent() && Ar.IsFilterEditorOnly() && (Ar.IsSaving() || Ar.IsLoading()))
+	{
+		TArray<uint8> CookedGraphBlob;
+		if (Ar.IsSaving())
+		{
+			CookedGraph.SaveToBlob(CookedGraphBlob);
+		}
+
+		Ar << CookedGraphBlob;
+
+		if (Ar.IsLoading())
+		{
+			CookedGraph.LoadFromBlob(CookedGraphBlob);
+		}
+	}
+}
+
+void UFlowAsset::GetResourceSizeEx(FResourceSizeEx& CumulativeResourceSize)
+{
+	Super::GetResourceSizeEx(CumulativeResourceSize);
+
+	// nodes are separate objects, reporting their own size
+	CumulativeResourceSize.AddDedicatedSystemMemoryBytes(Nodes.GetAllocatedSize()
+		+ CustomInputs.GetAllocatedSize() + CustomOutputs.GetAllocatedSize()
+		+ InlinedNodes.GetAllocatedSize() + InlinedSubGraphs.GetAllocatedSize()
+		+ CookedGraph.GetAllocatedSize() + CookedGraphNodes.GetAllocatedSize()
+		+ ActiveInstances.GetAllocatedSize() + ActiveSubGraphs.GetAllocatedSize()
+		+ CustomInputNodes.GetAllocatedSize() + PreloadedNodes.GetAllocatedSize()
+		+ ActiveNodes.GetAllocatedSize() + RecordedNodes.GetAllocatedSize());
+}
+
+#if WITH_EDITOR
+void UFlowAsset::BuildCookedGraph()
+{
+	// topology of the cooked asset, SubGraph nodes inlined while cooking are replaced with copied nodes
+	TMap<FGuid, const UFlowNode*> CookedNodes;
+	for (const TPair<FGuid, UFlowNode*>& Node : Nodes)
+	{
+		if (Node.Value && !InlinedSubGraphs.ContainsByPredicate([&Node](const FFlowInlinedSubGraph& InlinedSubGraph)
+		{
+			return InlinedSubGraph.SubGraphNodeGuid == Node.Key;
+		}))
+		{
+			CookedNodes.Add(Node.Key, Node.Value);
+		}
+	}
+	for (const TPair<FGuid, UFlowNode*>& InlinedNode : InlinedNodes)
+	{
+		CookedNodes.Add(InlinedNode.Key, InlinedNode.Value);
+	}
+	CookedNodes.KeySort(TLess<FGuid>());
+
+	TMap<FGuid, TMap<FName, FConnectedPin>> CookedConnections;
+	FSHA1 HashState;
+
+	for (const TPair<FGuid, const UFlowNode*>& Node : CookedNodes)
+	{
+		TMap<FName, FConnectedPin>& Connections = CookedConnections.Add(Node.Key);
+		for (const TPair<FName, FConnectedPin>& Connection : Node.Value->Connections)
+		{
+			FConnectedPin ResolvedConnection = Connection.Value;
+			if (ResolveInlinedConnection(ResolvedConnection) && CookedNodes.Contains(ResolvedConnection.NodeGuid))
+			{
+				Connections.Add(Connection.Key, ResolvedConnection);
+			}
+		}
+		Connections.KeySort(FNameLexicalLess());
+
+		HashState.Update(reinterpret_cast<const uint8*>(&Node.Key), sizeof(FGuid));
+		const FString ClassPath = Node.Value->GetClass()->GetPathName();
+		HashState.UpdateWithString(*ClassPath, ClassPath.Len());
+
+		for (const TPair<FName, FConnectedPin>& Connection : Connections)
+		{
+			const FString PinNames = Connection.Key.ToString() + TEXT(">") + Connection.Value.PinName.ToString();
+			HashState.Update(reinterpret_cast<const uint8*>(&Connection.Value.NodeGuid), sizeof(FGuid));
+			HashState.UpdateWithString(*PinNames, PinNames.Len());
+		}
+
+		if (const UFlowNode_CustomInput* CustomInput = Cast<UFlowNode_CustomInput>(Node.Value))
+		{
+			const FString EventName = CustomInput->GetEventName().ToString();
+			HashState.UpdateWithString(*EventName, EventName.Len());
+		}
+	}
+
+	const UFlowNode* DefaultEntryNode = GetDefaultEntryNode();
+	const FGuid DefaultEntryGuid = DefaultEntryNode ? DefaultEntryNode->GetGuid() : FGuid();
+	HashState.Update(reinterpret_cast<const uint8*>(&DefaultEntryGuid), sizeof(FGuid));
+
+	HashState.Final();
+	FSHAHash Hash;
+	HashState.GetHash(Hash.Hash);
+
+	const FString CacheKey = FDerivedDataCacheInterface::BuildCacheKey(TEXT("FLOWGRAPH"), *FString::FromInt(FFlowCookedGraph::Version), *Hash.ToString());
+
+	TArray<uint8> CookedGraphBlob;
+	if (GetDerivedDataCacheRef().GetSynchronous(*CacheKey, CookedGraphBlob, GetPathName()) && CookedGraph.LoadFromBlob(CookedGraphBlob))
+	{
+		return;
+	}
+
+	CookedGraph.Reset();
+	CookedGraph.Hash = Hash;
+	CookedNodes.GenerateKeyArray(CookedGraph.NodeGuids);
+
+	for (const TPair<FGuid, const UFlowNode*>& Node : CookedNodes)
+	{
+		CookedGraph.FirstOutputs.Add(CookedGraph.Outputs.Num());
+		for (const TPair<FName, FConnectedPin>& Connection : CookedConnections[Node.Key])
+		{
+			FFlowCookedGraph::FOutput& Output = CookedGraph.Outputs.AddDefaulted_GetRef();
+			Output.PinName = Connection.Key;
+			Output.NodeIndex = CookedGraph.FindNode(Connection.Value.NodeGuid);
+			Output.InputPinName = Connection.Value.PinName;
+		}
+
+		if (const UFlowNode_CustomInput* CustomInput = Cast<UFlowNode_CustomInput>(Node.Value))
+		{
+			if (!CustomInput->GetEventName().IsNone())
+			{
+				FFlowCookedGraph::FEntry& Entry = CookedGraph.CustomInputs.AddDefaulted_GetRef();
+				Entry.EventName = CustomInput->GetEventName();
+				Entry.NodeIndex = CookedGraph.FindNode(Node.Key);
+			}
+		}
+	}
+	CookedGraph.FirstOutputs.Add(CookedGraph.Outputs.Num());
+	CookedGraph.DefaultEntryNode = CookedGraph.FindNode(DefaultEntryGuid);
+
+	CookedGraph.SaveToBlob(CookedGraphBlob);
+	GetDerivedDataCacheRef().Put(*CacheKey, CookedGraphBlob, GetPathName());
+}
+#endif
+
 TArray<UFlowNode*> UFlowAsset::GetNodesInExecutionOrder(UFlowNode* FirstIteratedNode, const TSubclassOf<UFlowNode> FlowNodeClass)
 {
 	TArray<UFlowNode*> FoundNodes;
@@ -374,9 +784,44 @@ int32 UFlowAsset::RemoveInstance(UFlowAsset* Instance)
 #endif
 
 	ActiveInstances.Remove(Instance);
+	if (ActiveInstances.Num() == 0)
+	{
+		ResolvedParameters.Empty();
+	}
+
 	return ActiveInstances.Num();
 }
 
+TSharedRef<const FFlowResolvedParameters> UFlowAsset::ResolveParameters(const TArray<FFlowParameter>& Overrides)
+{
+	for (const TSharedRef<const FFlowResolvedParameters>& Resolved : ResolvedParameters)
+	{
+		const TArray<FFlowParameter>& ResolvedOverrides = Resolved->GetOverrides();
+		if (ResolvedOverrides.Num() == Overrides.Num())
+		{
+			bool bSameOverrides = true;
+			for (int32 i = 0; i < Overrides.Num() && bSameOverrides; i++)
+			{
+				bSameOverrides = ResolvedOverrides[i].Name == Overrides[i].Name && ResolvedOverrides[i].Value == Overrides[i].Value;
+			}
+
+			if (bSameOverrides)
+			{
+				return Resolved;
+			}
+		}
+	}
+
+	// values unique per instance shouldn't grow the cache, oldest set is dropped instead
+	constexpr int32 MaxResolvedParameters = 16;
+	if (ResolvedParameters.Num() >= MaxResolvedParameters)
+	{
+		ResolvedParameters.RemoveAt(0);
+	}
+
+	return ResolvedParameters.Add_GetRef(MakeShared<const FFlowResolvedParameters>(*this, Overrides));
+}
+
 void UFlowAsset::ClearInstances()
 {
 #if WITH_EDITOR
@@ -395,6 +840,7 @@ void UFlowAsset::ClearInstances()
 	}
 
 	ActiveInstances.Empty();
+	ResolvedParameters.Empty();
 }
 
 #if WITH_EDITOR
@@ -443,28 +889,117 @@ void UFlowAsset::BroadcastRuntimeMessageAdded(const TSharedRef<FTokenizedMessage
 
 void UFlowAsset::InitializeInstance(const TWeakObjectPtr<UObject> InOwner, UFlowAsset* InTemplateAsset)
 {
+	SCOPE_CYCLE_COUNTER(STAT_FlowInitializeInstance);
+	INC_DWORD_STAT(STAT_FlowLiveInstances);
+	CSV_CUSTOM_STAT(Flow, InstancesCreated, 1, ECsvCustomStatOp::Accumulate);
+
 	Owner = InOwner;
 	TemplateAsset = InTemplateAsset;
 
+	if (UFlowSubsystem* FlowSubsystem = GetFlowSubsystem())
+	{
+		RandomStream.Initialize(FlowSubsystem->MakeInstanceSeed());
+	}
+
+	// nodes of SubGraphs inlined while cooking are executed as nodes of this graph
+	for (const FFlowInlinedSubGraph& InlinedSubGraph : InlinedSubGraphs)
+	{
+		Nodes.Remove(InlinedSubGraph.SubGraphNodeGuid);
+	}
+	Nodes.Append(InlinedNodes);
+
+	// instance doesn't need to keep references to template nodes
+	InlinedNodes.Empty();
+
+	const FFlowCookedGraph& Graph = GetCookedGraph();
+	CookedGraphNodes.SetNumZeroed(Graph.NodeGuids.Num());
+
+	// values are imported once per template and overrides, instances only copy them
+	const TSharedRef<const FFlowResolvedParameters> ResolvedValues = InTemplateAsset->ResolveParameters(ParameterOverrides);
+
 	for (TPair<FGuid, UFlowNode*>& Node : Nodes)
 	{
 		UFlowNode* NewNodeInstance = NewObject<UFlowNode>(this, Node.Value->GetClass(), NAME_None, RF_Transient, Node.Value, false, nullptr);
 		Node.Value = NewNodeInstance;
 
-		if (UFlowNode_CustomInput* CustomInput = Cast<UFlowNode_CustomInput>(NewNodeInstance))
+		if (Graph.IsValid())
 		{
-			if (!CustomInput->EventName.IsNone())
+			NewNodeInstance->CookedGraphIndex = Graph.FindNode(Node.Key);
+			if (CookedGraphNodes.IsValidIndex(NewNodeInstance->CookedGraphIndex))
 			{
-				CustomInputNodes.Emplace(CustomInput);
+				CookedGraphNodes[NewNodeInstance->CookedGraphIndex] = NewNodeInstance;
+			}
+		}
+		else // cooked graph already knows entry points
+		{
+			if (UFlowNode_CustomInput* CustomInput = Cast<UFlowNode_CustomInput>(NewNodeInstance))
+			{
+				if (!CustomInput->EventName.IsNone())
+				{
+					CustomInputNodes.Emplace(CustomInput);
+				}
 			}
 		}
 
+		if (InlinedSubGraphs.Num() > 0)
+		{
+			RedirectInlinedConnections(NewNodeInstance);
+		}
+
+		if (ResolvedValues->HasValues())
+		{
+			ResolvedValues->Apply(Node.Key, *NewNodeInstance);
+		}
+
+		NewNodeInstance->CacheContext();
 		NewNodeInstance->InitializeInstance();
 	}
+
+	for (const FFlowCookedGraph::FEntry& Entry : Graph.CustomInputs)
+	{
+		if (UFlowNode_CustomInput* CustomInput = Cast<UFlowNode_CustomInput>(Nodes.FindRef(Graph.NodeGuids[Entry.NodeIndex])))
+		{
+			CustomInputNodes.Emplace(CustomInput);
+		}
+	}
+
+	TRACE_FLOW_INSTANCE_CREATED(*this);
+}
+
+void UFlowAsset::ApplyParameters()
+{
+	const TSharedRef<const FFlowResolvedParameters> ResolvedValues = TemplateAsset->ResolveParameters(ParameterOverrides);
+	if (ResolvedValues->HasValues())
+	{
+		for (const TPair<FGuid, UFlowNode*>& Node : Nodes)
+		{
+			ResolvedValues->Apply(Node.Key, *Node.Value);
+		}
+	}
+}
+
+bool UFlowAsset::GetParameterValue(const FName& Name, FString& OutValue) const
+{
+	const FFlowParameter* Parameter = FFlowParameter::Find(ParameterOverrides, Name);
+	if (Parameter == nullptr)
+	{
+		// instance is created from the template, so it declares the same defaults
+		Parameter = FFlowParameter::Find(Parameters, Name);
+	}
+
+	if (Parameter)
+	{
+		OutValue = Parameter->Value;
+		return true;
+	}
+
+	return false;
 }
 
 void UFlowAsset::DeinitializeInstance()
 {
+	TRACE_FLOW_INSTANCE_FINISHED(*this);
+
 	for (const TPair<FGuid, UFlowNode*>& Node : Nodes)
 	{
 		if (IsValid(Node.Value))
@@ -473,6 +1008,15 @@ void UFlowAsset::DeinitializeInstance()
 		}
 	}
 
+	DEC_DWORD_STAT(STAT_FlowLiveInstances);
+	CSV_CUSTOM_STAT(Flow, InstancesFinished, 1, ECsvCustomStatOp::Accumulate);
+
+	// Root Flow might reach Finish on its own, subsystem shouldn't keep it afterwards
+	if (UFlowSubsystem* FlowSubsystem = GetFlowSubsystem())
+	{
+		FlowSubsystem->RemoveRootInstance(this);
+	}
+
 	if (TemplateAsset)
 	{
 		const int32 ActiveInstancesLeft = TemplateAsset->RemoveInstance(this);
@@ -521,6 +1065,7 @@ void UFlowAsset::FinishFlow(const EFlowFinishPolicy InFinishPolicy, const bool b
 	{
 		Node->Deactivate();
 	}
+	DEC_DWORD_STAT_BY(STAT_FlowActiveNodes, ActiveNodes.Num());
 	ActiveNodes.Empty();
 
 	// flush preloaded content
@@ -537,6 +1082,19 @@ void UFlowAsset::FinishFlow(const EFlowFinishPolicy InFinishPolicy, const bool b
 	}
 }
 
+UWorld* UFlowAsset::GetWorld() const
+{
+	if (const UObject* OwnerObject = Owner.Get())
+	{
+		if (UWorld* OwnerWorld = OwnerObject->GetWorld())
+		{
+			return OwnerWorld;
+		}
+	}
+
+	return Super::GetWorld();
+}
+
 bool UFlowAsset::HasStartedFlow() const
 {
 	return RecordedNodes.Num() > 0;
@@ -565,15 +1123,63 @@ void UFlowAsset::TriggerCustomInput_FromSubGraph(UFlowNode_SubGraph* Node, const
 	{
 		FlowInstance->TriggerCustomInput(EventName);
 	}
+	else if (UFlowSubsystem* FlowSubsystem = GetFlowSubsystem())
+	{
+		if (UFlowAsset* SharedInstance = FlowSubsystem->FindOrCreateSharedSubFlow(Node))
+		{
+			SharedInstance->ExecuteSharedInstance(Node, EventName);
+		}
+	}
+}
+
+void UFlowAsset::ExecuteSharedInstance(UFlowNode_SubGraph* Caller, const FName& EventName)
+{
+	// calls might be nested, if the caller graph is entered again by outputs of this instance
+	SharedInstanceCallers.Push(Caller);
+	ON_SCOPE_EXIT
+	{
+		SharedInstanceCallers.Pop(false);
+	};
+
+	if (EventName.IsNone())
+	{
+		if (UFlowNode* ConnectedEntryNode = GetDefaultEntryNode())
+		{
+			ConnectedEntryNode->TriggerFirstOutput(true);
+		}
+	}
+	else
+	{
+		TriggerCustomInput(EventName);
+	}
+}
+
+UFlowNode_SubGraph* UFlowAsset::GetSubGraphCaller() const
+{
+	return SharedInstanceCallers.Num() > 0 ? SharedInstanceCallers.Last() : NodeOwningThisAssetInstance.Get();
 }
 
 void UFlowAsset::TriggerCustomInput(const FName& EventName)
 {
+	// inputs triggered by SubGraph nodes are replayed by executing the parent graph
+	UFlowSubsystem* FlowSubsystem = GetFlowSubsystem();
+	if (FlowSubsystem && FlowSubsystem->IsRecording() && GetSubGraphCaller() == nullptr)
+	{
+		FFlowRecordedEvent Event;
+		Event.Type = EFlowRecordedEventType::CustomInput;
+		Event.Asset = TemplateAsset;
+		Event.Name = EventName;
+		FlowSubsystem->RecordEvent(MoveTemp(Event), GetOwner());
+	}
+
 	for (UFlowNode_CustomInput* CustomInput : CustomInputNodes)
 	{
 		if (CustomInput->EventName == EventName)
 		{
-			RecordedNodes.Add(CustomInput);
+			if (!bSharedInstance)
+			{
+				RecordedNodes.Add(CustomInput);
+			}
 			CustomInput->ExecuteInput(EventName);
 		}
 	}
@@ -581,9 +1187,13 @@ void UFlowAsset::TriggerCustomInput(const FName& EventName)
 
 void UFlowAsset::TriggerCustomOutput(const FName& EventName)
 {
-	if (NodeOwningThisAssetInstance.IsValid()) // it's a SubGraph
+	if (UFlowNode_SubGraph* Caller = GetSubGraphCaller()) // it's a SubGraph
 	{
-		NodeOwningThisAssetInstance->TriggerOutput(EventName);
+		Caller->TriggerOutput(EventName);
+	}
+	else if (bSharedInstance)
+	{
+		UE_LOG(LogFlow, Warning, TEXT("Shared instance %s triggered output %s outside of the SubGraph call, it shouldn't contain latent nodes"), *GetName(), *EventName.ToString());
 	}
 	else // it's a Root Flow, so the intention here might be to call event on the Flow Component
 	{
@@ -598,14 +1208,50 @@ void UFlowAsset::TriggerInput(const FGuid& NodeGuid, const FName& PinName)
 {
 	if (UFlowNode* Node = Nodes.FindRef(NodeGuid))
 	{
-		if (!ActiveNodes.Contains(Node))
+		TriggerInput(Node, PinName);
+	}
+}
+
+void UFlowAsset::TriggerInputByIndex(const int32 NodeIndex, const FName& PinName)
+{
+	if (CookedGraphNodes.IsValidIndex(NodeIndex) && CookedGraphNodes[NodeIndex])
+	{
+		TriggerInput(CookedGraphNodes[NodeIndex], PinName);
+	}
+}
+
+void UFlowAsset::TriggerInput(UFlowNode* Node, const FName& PinName)
+{
+	SCOPE_CYCLE_COUNTER(STAT_FlowTriggerInput);
+	INC_DWORD_STAT(STAT_FlowSignals);
+	CSV_CUSTOM_STAT(Flow, Signals, 1, ECsvCustomStatOp::Accumulate);
+
+#if CSV_PROFILER
+	// signals triggered by this one are part of its dispatch, only the outermost one is timed
+	TOptional<FScopedCsvStat> DispatchTiming;
+	if (GFlowDispatchDepth++ == 0)
+	{
+		DispatchTiming.Emplace("Dispatch", CSV_CATEGORY_INDEX(Flow));
+	}
+	ON_SCOPE_EXIT
+	{
+		GFlowDispatchDepth--;
+	};
+#endif
+
+	if (!ActiveNodes.Contains(Node))
+	{
+		ActiveNodes.Add(Node);
+		INC_DWORD_STAT(STAT_FlowActiveNodes);
+
+		// shared instance is executed by every caller until the world ends, its history would only grow
+		if (!bSharedInstance)
 		{
-			ActiveNodes.Add(Node);
 			RecordedNodes.Add(Node);
 		}
-
-		Node->TriggerInput(PinName);
 	}
+
+	Node->TriggerInput(PinName);
 }
 
 void UFlowAsset::FinishNode(UFlowNode* Node)
@@ -613,13 +1259,18 @@ void UFlowAsset::FinishNode(UFlowNode* Node)
 	if (ActiveNodes.Contains(Node))
 	{
 		ActiveNodes.Remove(Node);
+		DEC_DWORD_STAT(STAT_FlowActiveNodes);
 
 		// if graph reached Finish and this asset instance was created by SubGraph node
 		if (Node->CanFinishGraph())
 		{
-			if (NodeOwningThisAssetInstance.IsValid())
+			if (UFlowNode_SubGraph* Caller = GetSubGraphCaller())
 			{
-				NodeOwningThisAssetInstance.Get()->TriggerFirstOutput(true);
+				Caller->TriggerFirstOutput(true);
+			}
+			else if (bSharedInstance)
+			{
+				UE_LOG(LogFlow, Warning, TEXT("Shared instance %s finished outside of the SubGraph call, it shouldn't contain latent nodes"), *GetName());
 			}
 			else
 			{
@@ -710,6 +1361,12 @@ void UFlowAsset::LoadInstance(const FFlowAssetSaveData& AssetRecord)
 	FFlowArchive Ar(MemoryReader);
 	Serialize(Ar);
 
+	// overrides saved with the instance might differ from ones provided while creating it
+	if (ParameterOverrides.Num() > 0)
+	{
+		ApplyParameters();
+	}
+
 	PreStartFlow();
 
 	// iterate graph "from the end", backward to execution order
@@ -735,6 +1392,7 @@ void UFlowAsset::OnActivationStateLoaded(UFlowNode* Node)
 	if (Node->ActivationState == EFlowNodeState::Active)
 	{
 		ActiveNodes.Emplace(Node);
+		INC_DWORD_STAT(STAT_FlowActiveNodes);
 	}
 }
 
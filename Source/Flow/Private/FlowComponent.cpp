@@ -44,10 +44,11 @@ void UFlowComponent::BeginPlay()
 {
 	Super::BeginPlay();
 
-	if (UFlowSubsystem* FlowSubsystem = GetFlowSubsystem())
+	CachedFlowSubsystem = GetFlowSubsystem();
+	if (UFlowSubsystem* FlowSubsystem = CachedFlowSubsystem.Get())
 	{
 		bool bComponentLoadedFromSaveGame = false;
-		if (GetFlowSubsystem()->GetLoadedSaveGame())
+		if (FlowSubsystem->GetLoadedSaveGame())
 		{
 			bComponentLoadedFromSaveGame = LoadInstance();
 		}
@@ -75,6 +76,7 @@ void UFlowComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
 		FlowSubsystem->FinishAllRootFlows(this, EFlowFinishPolicy::Keep);
 		FlowSubsystem->UnregisterComponent(this);
 	}
+	CachedFlowSubsystem.Reset();
 
 	Super::EndPlay(EndPlayReason);
 }
@@ -176,7 +178,7 @@ void UFlowComponent::RemoveIdentityTags(FGameplayTagContainer Tags, const EFlowN
 		{
 			OnIdentityTagsRemoved.Broadcast(this, ValidatedTags);
 
-			if (UFlowSubsystem* FlowSubsystem = GetWorld()->GetGameInstance()->GetSubsystem<UFlowSubsystem>())
+			if (UFlowSubsystem* FlowSubsystem = GetFlowSubsystem())
 			{
 				FlowSubsystem->OnIdentityTagsRemoved(this, ValidatedTags);
 			}
@@ -205,7 +207,7 @@ void UFlowComponent::OnRep_RemovedIdentityTags()
 	IdentityTags.RemoveTags(RemovedIdentityTags);
 	OnIdentityTagsRemoved.Broadcast(this, RemovedIdentityTags);
 
-	if (UFlowSubsystem* FlowSubsystem = GetWorld()->GetGameInstance()->GetSubsystem<UFlowSubsystem>())
+	if (UFlowSubsystem* FlowSubsystem = GetFlowSubsystem())
 	{
 		FlowSubsystem->OnIdentityTagsRemoved(this, RemovedIdentityTags);
 	}
@@ -252,6 +254,8 @@ void UFlowComponent::NotifyGraph(const FGameplayTag NotifyTag, const EFlowNetMod
 {
 	if (IsFlowNetMode(NetMode) && NotifyTag.IsValid() && HasBegunPlay())
 	{
+		RecordNotify(EFlowRecordedEventType::NotifyGraph, FGameplayTagContainer(NotifyTag));
+
 		// save recently notify, this allow for the retroactive check in nodes
 		// if retroactive check wouldn't be performed, this is only used by the network replication
 		RecentlySentNotifyTags = FGameplayTagContainer(NotifyTag);
@@ -275,6 +279,8 @@ void UFlowComponent::BulkNotifyGraph(const FGameplayTagContainer NotifyTags, con
 
 		if (ValidatedTags.Num() > 0)
 		{
+			RecordNotify(EFlowRecordedEventType::NotifyGraph, ValidatedTags);
+
 			// save recently notify, this allow for the retroactive check in nodes
 			// if retroactive check wouldn't be performed, this is only used by the network replication
 			RecentlySentNotifyTags = ValidatedTags;
@@ -292,6 +298,18 @@ void UFlowComponent::OnRep_SentNotifyTags()
 	}
 }
 
+void UFlowComponent::RecordNotify(const EFlowRecordedEventType Type, const FGameplayTagContainer& Tags) const
+{
+	UFlowSubsystem* FlowSubsystem = GetFlowSubsystem();
+	if (FlowSubsystem && FlowSubsystem->IsRecording())
+	{
+		FFlowRecordedEvent Event;
+		Event.Type = Type;
+		Event.Tags = Tags;
+		FlowSubsystem->RecordEvent(MoveTemp(Event), this);
+	}
+}
+
 void UFlowComponent::NotifyFromGraph(const FGameplayTagContainer& NotifyTags, const EFlowNetMode NetMode /* = EFlowNetMode::Authority*/)
 {
 	if (IsFlowNetMode(NetMode) && NotifyTags.IsValid() && HasBegunPlay())
@@ -307,6 +325,8 @@ void UFlowComponent::NotifyFromGraph(const FGameplayTagContainer& NotifyTags, co
 
 		if (ValidatedTags.Num() > 0)
 		{
+			RecordNotify(EFlowRecordedEventType::NotifyFromGraph, ValidatedTags);
+
 			for (const FGameplayTag& ValidatedTag : ValidatedTags)
 			{
 				ReceiveNotify.Broadcast(nullptr, ValidatedTag);
@@ -334,7 +354,10 @@ void UFlowComponent::NotifyActor(const FGameplayTag ActorTag, const FGameplayTag
 	{
 		if (const UFlowSubsystem* FlowSubsystem = GetFlowSubsystem())
 		{
-			for (const TWeakObjectPtr<UFlowComponent>& Component : FlowSubsystem->GetComponents<UFlowComponent>(ActorTag))
+			// snapshot, as receivers might register components or change their tags
+			TArray<UFlowComponent*, TInlineAllocator<16>> Components;
+			FlowSubsystem->GetComponents(ActorTag, Components, true, GetWorld());
+			for (UFlowComponent* Component : Components)
 			{
 				Component->ReceiveNotify.Broadcast(this, NotifyTag);
 			}
@@ -354,7 +377,9 @@ void UFlowComponent::OnRep_NotifyTagsFromAnotherComponent()
 	{
 		for (const FNotifyTagReplication& Notify : NotifyTagsFromAnotherComponent)
 		{
-			for (const TWeakObjectPtr<UFlowComponent>& Component : FlowSubsystem->GetComponents<UFlowComponent>(Notify.ActorTag))
+			TArray<UFlowComponent*, TInlineAllocator<16>> Components;
+			FlowSubsystem->GetComponents(Notify.ActorTag, Components, true, GetWorld());
+			for (UFlowComponent* Component : Components)
 			{
 				Component->ReceiveNotify.Broadcast(this, Notify.NotifyTag);
 			}
@@ -370,7 +395,7 @@ void UFlowComponent::StartRootFlow()
 		{
 			VerifyIdentityTags();
 
-			FlowSubsystem->StartRootFlow(this, RootFlow, bAllowMultipleInstances);
+			FlowSubsystem->StartRootFlowWithParameters(this, RootFlow, RootFlowParameters, bAllowMultipleInstances);
 		}
 	}
 }
@@ -487,6 +512,11 @@ void UFlowComponent::OnLoad_Implementation()
 
 UFlowSubsystem* UFlowComponent::GetFlowSubsystem() const
 {
+	if (UFlowSubsystem* FlowSubsystem = CachedFlowSubsystem.Get())
+	{
+		return FlowSubsystem;
+	}
+
 	if (GetWorld() && GetWorld()->GetGameInstance())
 	{
 		return GetWorld()->GetGameInstance()->GetSubsystem<UFlowSubsystem>();
@@ -0,0 +1,298 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "FlowComponentRegistry.h"
+#include "FlowComponent.h"
+#include "FlowStats.h"
+
+void FFlowComponentRegistry::Add(const FGameplayTag& Tag, UFlowComponent* Component)
+{
+	if (Tag.IsValid())
+	{
+		Components.Emplace(Tag, Component);
+		AddToHierarchy(Tag, Component);
+
+		int32& BucketSize = BucketSizes.FindOrAdd(Tag);
+		ResizeBucket(BucketSize, BucketSize + 1);
+		BucketSize++;
+
+		LargestBucketSize = FMath::Max(LargestBucketSize, BucketSize);
+	}
+}
+
+void FFlowComponentRegistry::Add(const FGameplayTagContainer& Tags, UFlowComponent* Component)
+{
+	for (const FGameplayTag& Tag : Tags)
+	{
+		Add(Tag, Component);
+	}
+}
+
+void FFlowComponentRegistry::Remove(const FGameplayTag& Tag, UFlowComponent* Component)
+{
+	if (Tag.IsValid())
+	{
+		const TWeakObjectPtr<UFlowComponent> WeakComponent(Component);
+		const int32 Removed = Components.Remove(Tag, WeakComponent);
+		if (Removed == 0)
+		{
+			return;
+		}
+
+		for (int32 i = 0; i < Removed; i++)
+		{
+			RemoveFromHierarchy(Tag, WeakComponent);
+		}
+
+		int32& BucketSize = BucketSizes.FindChecked(Tag);
+		const int32 NewBucketSize = FMath::Max(0, BucketSize - Removed);
+		ResizeBucket(BucketSize, NewBucketSize);
+		if (NewBucketSize == 0)
+		{
+			BucketSizes.Remove(Tag);
+		}
+		else
+		{
+			BucketSize = NewBucketSize;
+		}
+
+		// largest size drops by no more than the number of removed entries, so this walk is paid by removals
+		while (LargestBucketSize > 0 && BucketSizeHistogram[LargestBucketSize] == 0)
+		{
+			LargestBucketSize--;
+		}
+	}
+}
+
+void FFlowComponentRegistry::Remove(const FGameplayTagContainer& Tags, UFlowComponent* Component)
+{
+	for (const FGameplayTag& Tag : Tags)
+	{
+		Remove(Tag, Component);
+	}
+}
+
+void FFlowComponentRegistry::FindComponents(const FGameplayTag& Tag, const bool bExactMatch, TArray<TWeakObjectPtr<UFlowComponent>>& OutComponents) const
+{
+	if (bExactMatch)
+	{
+		Components.MultiFind(Tag, OutComponents);
+	}
+	else if (const TMap<TWeakObjectPtr<UFlowComponent>, int32>* Bucket = HierarchicalComponents.Find(Tag))
+	{
+		OutComponents.Reserve(OutComponents.Num() + Bucket->Num());
+		for (const TPair<TWeakObjectPtr<UFlowComponent>, int32>& Component : *Bucket)
+		{
+			OutComponents.Emplace(Component.Key);
+		}
+	}
+}
+
+void FFlowComponentRegistry::FindComponents(const FGameplayTagContainer& Tags, const EGameplayContainerMatchType MatchType, const bool bExactMatch, TSet<TWeakObjectPtr<UFlowComponent>>& OutComponents) const
+{
+	ForEachComponent(Tags, MatchType, bExactMatch, [&OutComponents](UFlowComponent* Component)
+	{
+		OutComponents.Emplace(Component);
+		return true;
+	});
+}
+
+bool FFlowComponentRegistry::ForEachComponent(const FGameplayTag& Tag, const bool bExactMatch, TFunctionRef<bool(UFlowComponent*)> Visitor) const
+{
+	INC_DWORD_STAT_BY(STAT_FlowRegistryScannedEntries, GetBucketSize(Tag, bExactMatch));
+
+	if (bExactMatch)
+	{
+		for (TMultiMap<FGameplayTag, TWeakObjectPtr<UFlowComponent>>::TConstKeyIterator It(Components, Tag); It; ++It)
+		{
+			UFlowComponent* Component = It.Value().Get();
+			if (Component && !Visitor(Component))
+			{
+				return false;
+			}
+		}
+	}
+	else if (const TMap<TWeakObjectPtr<UFlowComponent>, int32>* Bucket = HierarchicalComponents.Find(Tag))
+	{
+		for (const TPair<TWeakObjectPtr<UFlowComponent>, int32>& Pair : *Bucket)
+		{
+			UFlowComponent* Component = Pair.Key.Get();
+			if (Component && !Visitor(Component))
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+bool FFlowComponentRegistry::ForEachComponent(const FGameplayTagContainer& Tags, const EGameplayContainerMatchType MatchType, const bool bExactMatch, TFunctionRef<bool(UFlowComponent*)> Visitor) const
+{
+	if (Tags.Num() == 0)
+	{
+		return true;
+	}
+
+	if (MatchType == EGameplayContainerMatchType::Any)
+	{
+		for (int32 TagIndex = 0; TagIndex < Tags.Num(); TagIndex++)
+		{
+			const bool bContinue = ForEachComponent(Tags.GetByIndex(TagIndex), bExactMatch, [&](UFlowComponent* Component)
+			{
+				// component matching any of preceding tags has been already visited
+				for (int32 PrecedingIndex = 0; PrecedingIndex < TagIndex; PrecedingIndex++)
+				{
+					const FGameplayTag& PrecedingTag = Tags.GetByIndex(PrecedingIndex);
+					if (bExactMatch ? Component->IdentityTags.HasTagExact(PrecedingTag) : Component->IdentityTags.HasTag(PrecedingTag))
+					{
+						return true;
+					}
+				}
+				return Visitor(Component);
+			});
+
+			if (!bContinue)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	// EGameplayContainerMatchType::All, every result is found in the bucket of each given tag
+	// so only the smallest bucket is scanned, and candidates are probed against remaining tags
+	const int32 SmallestIndex = FindSmallestBucket(Tags, bExactMatch);
+	if (SmallestIndex == INDEX_NONE)
+	{
+		return true;
+	}
+
+	return ForEachComponent(Tags.GetByIndex(SmallestIndex), bExactMatch, [&](UFlowComponent* Component)
+	{
+		const bool bHasAll = bExactMatch ? Component->IdentityTags.HasAllExact(Tags) : Component->IdentityTags.HasAll(Tags);
+		return !bHasAll || Visitor(Component);
+	});
+}
+
+void FFlowComponentRegistry::GetAllComponents(TSet<TWeakObjectPtr<UFlowComponent>>& OutComponents) const
+{
+	for (TMultiMap<FGameplayTag, TWeakObjectPtr<UFlowComponent>>::TConstIterator It(Components); It; ++It)
+	{
+		OutComponents.Emplace(It.Value());
+	}
+}
+
+int32 FFlowComponentRegistry::GetBucketSize(const FGameplayTag& Tag, const bool bExactMatch) const
+{
+	if (bExactMatch)
+	{
+		return BucketSizes.FindRef(Tag);
+	}
+
+	const TMap<TWeakObjectPtr<UFlowComponent>, int32>* Bucket = HierarchicalComponents.Find(Tag);
+	return Bucket ? Bucket->Num() : 0;
+}
+
+int32 FFlowComponentRegistry::FindSmallestBucket(const FGameplayTagContainer& Tags, const bool bExactMatch) const
+{
+	int32 SmallestIndex = INDEX_NONE;
+	int32 SmallestSize = MAX_int32;
+	for (int32 TagIndex = 0; TagIndex < Tags.Num(); TagIndex++)
+	{
+		const int32 BucketSize = GetBucketSize(Tags.GetByIndex(TagIndex), bExactMatch);
+		if (BucketSize == 0)
+		{
+			return INDEX_NONE;
+		}
+
+		if (BucketSize < SmallestSize)
+		{
+			SmallestIndex = TagIndex;
+			SmallestSize = BucketSize;
+		}
+	}
+
+	return SmallestIndex;
+}
+
+void FFlowComponentRegistry::GetLargestBuckets(const int32 MaxBuckets, TArray<TPair<FGameplayTag, int32>>& OutBuckets) const
+{
+	OutBuckets.Reset();
+	for (const TPair<FGameplayTag, int32>& Bucket : BucketSizes)
+	{
+		OutBuckets.Emplace(Bucket.Key, Bucket.Value);
+	}
+
+	OutBuckets.Sort([](const TPair<FGameplayTag, int32>& A, const TPair<FGameplayTag, int32>& B) { return A.Value > B.Value; });
+	if (OutBuckets.Num() > MaxBuckets)
+	{
+		OutBuckets.SetNum(MaxBuckets);
+	}
+}
+
+SIZE_T FFlowComponentRegistry::GetAllocatedSize() const
+{
+	SIZE_T Bytes = Components.GetAllocatedSize() + BucketSizes.GetAllocatedSize() + BucketSizeHistogram.GetAllocatedSize() + HierarchicalComponents.GetAllocatedSize();
+	for (const TPair<FGameplayTag, TMap<TWeakObjectPtr<UFlowComponent>, int32>>& Bucket : HierarchicalComponents)
+	{
+		Bytes += Bucket.Value.GetAllocatedSize();
+	}
+	return Bytes;
+}
+
+void FFlowComponentRegistry::Empty()
+{
+	Components.Empty();
+	BucketSizes.Empty();
+	BucketSizeHistogram.Empty();
+	LargestBucketSize = 0;
+	HierarchicalComponents.Empty();
+}
+
+void FFlowComponentRegistry::ResizeBucket(const int32 OldSize, const int32 NewSize)
+{
+	if (OldSize > 0)
+	{
+		BucketSizeHistogram[OldSize]--;
+	}
+
+	if (NewSize > 0)
+	{
+		if (BucketSizeHistogram.Num() <= NewSize)
+		{
+			BucketSizeHistogram.SetNumZeroed(NewSize + 1);
+		}
+		BucketSizeHistogram[NewSize]++;
+	}
+}
+
+void FFlowComponentRegistry::AddToHierarchy(const FGameplayTag& Tag, const TWeakObjectPtr<UFlowComponent>& Component)
+{
+	for (FGameplayTag ParentTag = Tag; ParentTag.IsValid(); ParentTag = ParentTag.RequestDirectParent())
+	{
+		HierarchicalComponents.FindOrAdd(ParentTag).FindOrAdd(Component)++;
+	}
+}
+
+void FFlowComponentRegistry::RemoveFromHierarchy(const FGameplayTag& Tag, const TWeakObjectPtr<UFlowComponent>& Component)
+{
+	for (FGameplayTag ParentTag = Tag; ParentTag.IsValid(); ParentTag = ParentTag.RequestDirectParent())
+	{
+		TMap<TWeakObjectPtr<UFlowComponent>, int32>* Bucket = HierarchicalComponents.Find(ParentTag);
+		if (Bucket == nullptr)
+		{
+			continue;
+		}
+
+		int32* Count = Bucket->Find(Component);
+		if (Count && --(*Count) <= 0)
+		{
+			Bucket->Remove(Component);
+			if (Bucket->Num() == 0)
+			{
+				HierarchicalComponents.Remove(ParentTag);
+			}
+		}
+	}
+}
@@ -0,0 +1,88 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "FlowCookedGraph.h"
+
+#include "Algo/BinarySearch.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+void FFlowCookedGraph::Reset()
+{
+	Hash = FSHAHash();
+	NodeGuids.Empty();
+	FirstOutputs.Empty();
+	Outputs.Empty();
+
+	DefaultEntryNode = INDEX_NONE;
+	CustomInputs.Empty();
+}
+
+SIZE_T FFlowCookedGraph::GetAllocatedSize() const
+{
+	return NodeGuids.GetAllocatedSize() + FirstOutputs.GetAllocatedSize() + Outputs.GetAllocatedSize() + CustomInputs.GetAllocatedSize();
+}
+
+int32 FFlowCookedGraph::FindNode(const FGuid& NodeGuid) const
+{
+	return Algo::BinarySearch(NodeGuids, NodeGuid);
+}
+
+TArrayView<const FFlowCookedGraph::FOutput> FFlowCookedGraph::GetOutputs(const int32 NodeIndex) const
+{
+	if (FirstOutputs.IsValidIndex(NodeIndex + 1))
+	{
+		return MakeArrayView(Outputs.GetData() + FirstOutputs[NodeIndex], FirstOutputs[NodeIndex + 1] - FirstOutputs[NodeIndex]);
+	}
+
+	return TArrayView<const FOutput>();
+}
+
+void FFlowCookedGraph::SaveToBlob(TArray<uint8>& OutBlob)
+{
+	OutBlob.Reset();
+
+	FMemoryWriter Writer(OutBlob, true);
+	int32 BlobVersion = Version;
+	Writer << BlobVersion;
+	Serialize(Writer);
+}
+
+bool FFlowCookedGraph::LoadFromBlob(const TArray<uint8>& Blob)
+{
+	Reset();
+
+	if (Blob.Num() == 0)
+	{
+		return false;
+	}
+
+	FMemoryReader Reader(Blob, true);
+	int32 BlobVersion = 0;
+	Reader << BlobVersion;
+
+	// blob built by another version of the plugin
+	if (BlobVersion != Version)
+	{
+		return false;
+	}
+
+	Serialize(Reader);
+
+	if (Reader.IsError() || FirstOutputs.Num() != NodeGuids.Num() + 1)
+	{
+		Reset();
+		return false;
+	}
+
+	return true;
+}
+
+void FFlowCookedGraph::Serialize(FArchive& Ar)
+{
+	Ar << Hash;
+	Ar << NodeGuids;
+	Ar << FirstOutputs;
+	Ar << Outputs;
+	Ar << DefaultEntryNode;
+	Ar << CustomInputs;
+}
@@ -1,6 +1,7 @@
 // Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
 
 #include "FlowModule.h"
+#include "FlowStats.h"
 
 #include "Modules/ModuleManager.h"
 
@@ -18,3 +19,27 @@ void FFlowModule::ShutdownModule()
 
 IMPLEMENT_MODULE(FFlowModule, Flow)
 DEFINE_LOG_CATEGORY(LogFlow);
+
+LLM_DEFINE_TAG(Flow);
+LLM_DEFINE_TAG(Flow_Instances);
+LLM_DEFINE_TAG(Flow_SaveGame);
+LLM_DEFINE_TAG(Flow_Registry);
+
+DEFINE_STAT(STAT_FlowCreateInstance);
+DEFINE_STAT(STAT_FlowInitializeInstance);
+DEFINE_STAT(STAT_FlowTriggerInput);
+DEFINE_STAT(STAT_FlowExecuteInput);
+DEFINE_STAT(STAT_FlowFindComponents);
+DEFINE_STAT(STAT_FlowSaveGame);
+DEFINE_STAT(STAT_FlowLoadRootFlow);
+DEFINE_STAT(STAT_FlowMovieSceneTrack);
+
+DEFINE_STAT(STAT_FlowLiveInstances);
+DEFINE_STAT(STAT_FlowActiveNodes);
+DEFINE_STAT(STAT_FlowSignals);
+DEFINE_STAT(STAT_FlowRegistrySize);
+DEFINE_STAT(STAT_FlowRegistryBuckets);
+DEFINE_STAT(STAT_FlowRegistryLargestBucket);
+DEFINE_STAT(STAT_FlowRegistryScannedEntries);
+
+CSV_DEFINE_CATEGORY_MODULE(FLOW_API, Flow, true);
@@ -0,0 +1,26 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "FlowNativeGraph.h"
+
+void FFlowNativeGraphRegistry::Register(const FName& AssetPath, const FSHAHash& Hash, const IFlowNativeGraph* NativeGraph)
+{
+	GetEntries().Add(AssetPath, {Hash, NativeGraph});
+}
+
+void FFlowNativeGraphRegistry::Unregister(const FName& AssetPath)
+{
+	GetEntries().Remove(AssetPath);
+}
+
+const IFlowNativeGraph* FFlowNativeGraphRegistry::Find(const FName& AssetPath, const FSHAHash& Hash)
+{
+	const FEntry* Entry = GetEntries().Find(AssetPath);
+	return Entry && Entry->Hash == Hash ? Entry->NativeGraph : nullptr;
+}
+
+TMap<FName, FFlowNativeGraphRegistry::FEntry>& FFlowNativeGraphRegistry::GetEntries()
+{
+	// function-local, so it's constructed before the first generated graph registers itself
+	static TMap<FName, FEntry> Entries;
+	return Entries;
+}
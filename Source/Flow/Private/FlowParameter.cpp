@@ -0,0 +1,103 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "FlowParameter.h"
+#include "FlowAsset.h"
+#include "FlowModule.h"
+#include "Nodes/FlowNode.h"
+
+FFlowResolvedParameters::FFlowResolvedParameters(const UFlowAsset& Template, const TArray<FFlowParameter>& InOverrides)
+	: Overrides(InOverrides)
+{
+	struct FPendingValue
+	{
+		const UFlowNode* Node;
+		const FString* Text;
+	};
+	TArray<FPendingValue> PendingValues;
+
+	// layout is computed first, so values are constructed in place and never moved
+	int32 BufferSize = 0;
+	for (const TPair<FGuid, UFlowNode*>& Node : Template.GetNodes())
+	{
+		if (Node.Value == nullptr || Node.Value->GetParameterBindings().Num() == 0)
+		{
+			continue;
+		}
+
+		const int32 FirstValue = Values.Num();
+		for (const FFlowParameterBinding& Binding : Node.Value->GetParameterBindings())
+		{
+			const FFlowParameter* Parameter = FFlowParameter::Find(Overrides, Binding.ParameterName);
+			if (Parameter == nullptr)
+			{
+				Parameter = FFlowParameter::Find(Template.Parameters, Binding.ParameterName);
+			}
+			if (Parameter == nullptr)
+			{
+				UE_LOG(LogFlow, Error, TEXT("%s: property %s is bound to parameter %s, which isn't declared by the Flow Asset"), *Node.Value->GetPathName(), *Binding.PropertyName.ToString(), *Binding.ParameterName.ToString());
+				continue;
+			}
+
+			const FProperty* Property = Node.Value->GetClass()->FindPropertyByName(Binding.PropertyName);
+			if (Property == nullptr)
+			{
+				UE_LOG(LogFlow, Error, TEXT("%s: parameter %s is bound to property %s, which doesn't exist"), *Node.Value->GetPathName(), *Binding.ParameterName.ToString(), *Binding.PropertyName.ToString());
+				continue;
+			}
+
+			const int32 Offset = Align(BufferSize, Property->GetMinAlignment());
+			BufferSize = Offset + Property->GetSize();
+
+			Values.Add({Property, Offset});
+			PendingValues.Add({Node.Value, &Parameter->Value});
+		}
+
+		if (Values.Num() > FirstValue)
+		{
+			NodeValues.Add(Node.Key, TPair<int32, int32>(FirstValue, Values.Num() - FirstValue));
+		}
+	}
+
+	Buffer.SetNumZeroed(BufferSize);
+
+	for (int32 Index = 0; Index < Values.Num(); Index++)
+	{
+		const FValue& Value = Values[Index];
+		const FPendingValue& PendingValue = PendingValues[Index];
+		void* ValuePtr = Buffer.GetData() + Value.Offset;
+
+		// text might describe the value partially, i.e. a few struct members, so the template value is the base
+		Value.Property->InitializeValue(ValuePtr);
+		Value.Property->CopyCompleteValue(ValuePtr, Value.Property->ContainerPtrToValuePtr<void>(PendingValue.Node));
+
+		if (Value.Property->ImportText_Direct(**PendingValue.Text, ValuePtr, const_cast<UFlowNode*>(PendingValue.Node), PPF_None) == nullptr)
+		{
+			UE_LOG(LogFlow, Error, TEXT("%s: value %s can't be imported to property %s"), *PendingValue.Node->GetPathName(), **PendingValue.Text, *Value.Property->GetName());
+		}
+	}
+}
+
+FFlowResolvedParameters::~FFlowResolvedParameters()
+{
+	for (const FValue& Value : Values)
+	{
+		Value.Property->DestroyValue(Buffer.GetData() + Value.Offset);
+	}
+}
+
+void FFlowResolvedParameters::Apply(const FGuid& NodeGuid, UFlowNode& Node) const
+{
+	if (const TPair<int32, int32>* Range = NodeValues.Find(NodeGuid))
+	{
+		for (int32 Index = Range->Key; Index < Range->Key + Range->Value; Index++)
+		{
+			const FValue& Value = Values[Index];
+			Value.Property->CopyCompleteValue(Value.Property->ContainerPtrToValuePtr<void>(&Node), Buffer.GetData() + Value.Offset);
+		}
+	}
+}
+
+SIZE_T FFlowResolvedParameters::GetAllocatedSize() const
+{
+	return Overrides.GetAllocatedSize() + NodeValues.GetAllocatedSize() + Values.GetAllocatedSize() + Buffer.GetAllocatedSize();
+}
@@ -0,0 +1,53 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "FlowRecording.h"
+#include "FlowModule.h"
+
+#include "Misc/FileHelper.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/ObjectAndNameAsStringProxyArchive.h"
+
+bool FFlowRecordedEvent::Matches(const FFlowRecordedEvent& Other) const
+{
+	return Type == Other.Type && Object == Other.Object && Asset == Other.Asset && NodeGuid == Other.NodeGuid
+		&& Name == Other.Name && Tags == Other.Tags && Value == Other.Value;
+}
+
+FString FFlowRecordedEvent::ToString() const
+{
+	const UEnum* TypeEnum = StaticEnum<EFlowRecordedEventType>();
+	return FString::Printf(TEXT("%.3f %s %s %s %s %s"), Time, *TypeEnum->GetNameStringByValue(static_cast<int64>(Type)), *Object, *Asset.ToString(), *Name.ToString(), *Tags.ToStringSimple());
+}
+
+bool FFlowRecording::SaveToFile(const FString& Filename)
+{
+	TArray<uint8> Data;
+	FMemoryWriter MemoryWriter(Data, true);
+	FObjectAndNameAsStringProxyArchive Ar(MemoryWriter, false);
+	StaticStruct()->SerializeItem(Ar, this, nullptr);
+
+	if (!FFileHelper::SaveArrayToFile(Data, *Filename))
+	{
+		UE_LOG(LogFlow, Error, TEXT("Failed to write Flow recording to %s"), *Filename);
+		return false;
+	}
+
+	return true;
+}
+
+bool FFlowRecording::LoadFromFile(const FString& Filename)
+{
+	TArray<uint8> Data;
+	if (!FFileHelper::LoadFileToArray(Data, *Filename))
+	{
+		UE_LOG(LogFlow, Error, TEXT("Failed to read Flow recording from %s"), *Filename);
+		return false;
+	}
+
+	FMemoryReader MemoryReader(Data, true);
+	FObjectAndNameAsStringProxyArchive Ar(MemoryReader, true);
+	StaticStruct()->SerializeItem(Ar, this, nullptr);
+
+	return !Ar.IsError();
+}
@@ -3,16 +3,23 @@
 #include "FlowSubsystem.h"
 
 #include "FlowAsset.h"
+#include "FlowAssetVariant.h"
 #include "FlowComponent.h"
 #include "FlowModule.h"
+#include "FlowNativeGraph.h"
 #include "FlowSave.h"
 #include "FlowSettings.h"
+#include "FlowStats.h"
+#include "FlowTrace.h"
 #include "Nodes/Route/FlowNode_SubGraph.h"
 
 #include "Engine/GameInstance.h"
 #include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
 #include "Logging/MessageLog.h"
 #include "Misc/Paths.h"
+#include "MovieSceneSequencePlayer.h"
+#include "TimerManager.h"
 #include "UObject/UObjectHash.h"
 
 #if WITH_EDITOR
@@ -24,9 +31,40 @@ FNativeFlowAssetEvent UFlowSubsystem::OnInstancedTemplateRemoved;
 
 UFlowSubsystem::UFlowSubsystem()
 	: UGameInstanceSubsystem()
+	, bShardedByWorld(false)
+	, VirtualTime(0.0)
+	, RecordingStartTime(0.0)
+	, RandomSeed(0)
+	, SeededInstances(0)
 {
 }
 
+void UFlowSubsystem::AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector)
+{
+	UFlowSubsystem* This = CastChecked<UFlowSubsystem>(InThis);
+
+	// instances are copied to locals, as collector might null a reference and map keys can't be modified in place
+	for (const TPair<UFlowAsset*, TWeakObjectPtr<UObject>>& RootInstance : This->RootInstances)
+	{
+		UFlowAsset* Instance = RootInstance.Key;
+		Collector.AddReferencedObject(Instance, This);
+	}
+
+	for (const TPair<UFlowNode_SubGraph*, UFlowAsset*>& SubFlow : This->InstancedSubFlows)
+	{
+		UFlowAsset* Instance = SubFlow.Value;
+		Collector.AddReferencedObject(Instance, This);
+	}
+
+	for (const TPair<TPair<UFlowAsset*, FObjectKey>, UFlowAsset*>& SharedSubFlow : This->SharedSubFlows)
+	{
+		UFlowAsset* Instance = SharedSubFlow.Value;
+		Collector.AddReferencedObject(Instance, This);
+	}
+
+	Super::AddReferencedObjects(InThis, Collector);
+}
+
 bool UFlowSubsystem::ShouldCreateSubsystem(UObject* Outer) const
 {
 	// Only create an instance if there is no override implementation defined elsewhere
@@ -48,11 +86,22 @@ bool UFlowSubsystem::ShouldCreateSubsystem(UObject* Outer) const
 
 void UFlowSubsystem::Initialize(FSubsystemCollectionBase& Collection)
 {
+	// every game is different, unless seed is set by the replay
+	SetRandomSeed(FPlatformTime::Cycles());
+
+	// read once, partitions can't be merged or split while they're in use
+	bShardedByWorld = UFlowSettings::Get()->bShardByWorld;
+	WorldCleanupHandle = FWorldDelegates::OnWorldCleanup.AddUObject(this, &UFlowSubsystem::OnWorldCleanup);
 }
 
 void UFlowSubsystem::Deinitialize()
 {
+	FWorldDelegates::OnWorldCleanup.Remove(WorldCleanupHandle);
+
 	AbortActiveFlows();
+
+	VirtualTimerManager.Reset();
+	VirtualTimeSequencePlayers.Empty();
 }
 
 void UFlowSubsystem::AbortActiveFlows()
@@ -70,15 +119,36 @@ void UFlowSubsystem::AbortActiveFlows()
 
 	InstancedTemplates.Empty();
 	InstancedSubFlows.Empty();
+	SharedSubFlows.Empty();
+	ReleasedRootFlows.Empty();
 
 	RootInstances.Empty();
+	for (TPair<TObjectKey<UWorld>, FFlowWorldShard>& WorldShard : WorldShards)
+	{
+		WorldShard.Value.RootInstances.Empty();
+	}
 }
 
 void UFlowSubsystem::StartRootFlow(UObject* Owner, UFlowAsset* FlowAsset, const bool bAllowMultipleInstances /* = true */)
+{
+	StartRootFlowWithParameters(Owner, FlowAsset, TArray<FFlowParameter>(), bAllowMultipleInstances);
+}
+
+void UFlowSubsystem::StartRootFlowWithParameters(UObject* Owner, UFlowAsset* FlowAsset, const TArray<FFlowParameter>& Parameters, const bool bAllowMultipleInstances /* = true */)
 {
 	if (FlowAsset)
 	{
-		if (UFlowAsset* NewFlow = CreateRootFlow(Owner, FlowAsset, bAllowMultipleInstances))
+		if (IsRecording())
+		{
+			FFlowRecordedEvent Event;
+			Event.Type = EFlowRecordedEventType::StartRootFlow;
+			Event.Asset = FlowAsset;
+			Event.Value = bAllowMultipleInstances;
+			Event.Parameters = Parameters;
+			RecordEvent(MoveTemp(Event), Owner);
+		}
+
+		if (UFlowAsset* NewFlow = CreateRootFlow(Owner, FlowAsset, bAllowMultipleInstances, Parameters))
 		{
 			NewFlow->StartFlow();
 		}
@@ -92,9 +162,24 @@ void UFlowSubsystem::StartRootFlow(UObject* Owner, UFlowAsset* FlowAsset, const
 #endif
 }
 
-UFlowAsset* UFlowSubsystem::CreateRootFlow(UObject* Owner, UFlowAsset* FlowAsset, const bool bAllowMultipleInstances)
+void UFlowSubsystem::StartRootFlowVariant(UObject* Owner, UFlowAssetVariant* Variant, const bool bAllowMultipleInstances /* = true */)
 {
-	for (const TPair<UFlowAsset*, TWeakObjectPtr<UObject>>& RootInstance : RootInstances)
+	if (Variant)
+	{
+		StartRootFlowWithParameters(Owner, Variant->BaseAsset, Variant->Parameters, bAllowMultipleInstances);
+	}
+#if WITH_EDITOR
+	else
+	{
+		FMessageLog("PIE").Error(LOCTEXT("StartRootFlowNullVariant", "Attempted to start Root Flow with a null asset variant."))
+		                  ->AddToken(FUObjectToken::Create(Owner));
+	}
+#endif
+}
+
+UFlowAsset* UFlowSubsystem::CreateRootFlow(UObject* Owner, UFlowAsset* FlowAsset, const bool bAllowMultipleInstances, const TArray<FFlowParameter>& Parameters)
+{
+	for (const TPair<UFlowAsset*, TWeakObjectPtr<UObject>>& RootInstance : GetRootInstancesInWorldOf(Owner))
 	{
 		if (Owner == RootInstance.Value.Get() && FlowAsset == RootInstance.Key->GetTemplateAsset())
 		{
@@ -109,10 +194,47 @@ UFlowAsset* UFlowSubsystem::CreateRootFlow(UObject* Owner, UFlowAsset* FlowAsset
 		return nullptr;
 	}
 
-	UFlowAsset* NewFlow = CreateFlowInstance(Owner, FlowAsset);
+	return CreateRootInstance(Owner, FlowAsset, Parameters);
+}
+
+UFlowAsset* UFlowSubsystem::CreateRootInstance(UObject* Owner, UFlowAsset* FlowAsset, const TArray<FFlowParameter>& Parameters, const FString& InstanceName)
+{
+	// finished instance keeps its name until garbage collected, while the owner might create the Flow under the same name again
+	if (!InstanceName.IsEmpty())
+	{
+		if (UFlowAsset* FinishedInstance = FindObjectFast<UFlowAsset>(this, *InstanceName))
+		{
+			if (RootInstances.Contains(FinishedInstance))
+			{
+				UE_LOG(LogFlow, Warning, TEXT("Attempted to start Root Flow under the name of running instance. Owner: %s. Instance: %s."), *Owner->GetName(), *InstanceName);
+				return nullptr;
+			}
+
+			const FName FinishedName = MakeUniqueObjectName(this, FinishedInstance->GetClass(), *FString::Printf(TEXT("%s_Finished"), *InstanceName));
+			FinishedInstance->Rename(*FinishedName.ToString(), nullptr, REN_DontCreateRedirectors | REN_NonTransactional);
+		}
+	}
+
+	UFlowAsset* NewFlow = CreateFlowInstance(Owner, FlowAsset, InstanceName, Parameters);
+	if (NewFlow)
+	{
+		AddRootInstance(NewFlow, Owner);
+	}
+
+	return NewFlow;
+}
+
+UFlowAsset* UFlowSubsystem::StartOwnedRootFlow(UObject* Owner, UFlowAsset* FlowAsset, const FString& InstanceName)
+{
+	if (Owner == nullptr || FlowAsset == nullptr)
+	{
+		return nullptr;
+	}
+
+	UFlowAsset* NewFlow = CreateRootInstance(Owner, FlowAsset, TArray<FFlowParameter>(), InstanceName);
 	if (NewFlow)
 	{
-		RootInstances.Add(NewFlow, Owner);
+		NewFlow->StartFlow();
 	}
 
 	return NewFlow;
@@ -120,9 +242,18 @@ UFlowAsset* UFlowSubsystem::CreateRootFlow(UObject* Owner, UFlowAsset* FlowAsset
 
 void UFlowSubsystem::FinishRootFlow(UObject* Owner, UFlowAsset* TemplateAsset, const EFlowFinishPolicy FinishPolicy)
 {
+	if (IsRecording())
+	{
+		FFlowRecordedEvent Event;
+		Event.Type = EFlowRecordedEventType::FinishRootFlow;
+		Event.Asset = TemplateAsset;
+		Event.Value = static_cast<int32>(FinishPolicy);
+		RecordEvent(MoveTemp(Event), Owner);
+	}
+
 	UFlowAsset* InstanceToFinish = nullptr;
 
-	for (TPair<UFlowAsset*, TWeakObjectPtr<UObject>>& RootInstance : RootInstances)
+	for (const TPair<UFlowAsset*, TWeakObjectPtr<UObject>>& RootInstance : GetRootInstancesInWorldOf(Owner))
 	{
 		if (Owner && Owner == RootInstance.Value.Get() && RootInstance.Key && RootInstance.Key->GetTemplateAsset() == TemplateAsset)
 		{
@@ -133,16 +264,35 @@ void UFlowSubsystem::FinishRootFlow(UObject* Owner, UFlowAsset* TemplateAsset, c
 
 	if (InstanceToFinish)
 	{
-		RootInstances.Remove(InstanceToFinish);
+		RemoveRootInstance(InstanceToFinish);
 		InstanceToFinish->FinishFlow(FinishPolicy);
 	}
 }
 
+void UFlowSubsystem::FinishRootInstance(UFlowAsset* Instance, const EFlowFinishPolicy FinishPolicy)
+{
+	// instance might have finished on its own already
+	if (Instance && RootInstances.Contains(Instance))
+	{
+		RemoveRootInstance(Instance);
+		Instance->FinishFlow(FinishPolicy);
+	}
+}
+
 void UFlowSubsystem::FinishAllRootFlows(UObject* Owner, const EFlowFinishPolicy FinishPolicy)
 {
+	// recorded without asset
+	if (IsRecording())
+	{
+		FFlowRecordedEvent Event;
+		Event.Type = EFlowRecordedEventType::FinishRootFlow;
+		Event.Value = static_cast<int32>(FinishPolicy);
+		RecordEvent(MoveTemp(Event), Owner);
+	}
+
 	TArray<UFlowAsset*> InstancesToFinish;
 
-	for (TPair<UFlowAsset*, TWeakObjectPtr<UObject>>& RootInstance : RootInstances)
+	for (const TPair<UFlowAsset*, TWeakObjectPtr<UObject>>& RootInstance : GetRootInstancesInWorldOf(Owner))
 	{
 		if (Owner && Owner == RootInstance.Value.Get() && RootInstance.Key)
 		{
@@ -152,19 +302,34 @@ void UFlowSubsystem::FinishAllRootFlows(UObject* Owner, const EFlowFinishPolicy
 
 	for (UFlowAsset* InstanceToFinish : InstancesToFinish)
 	{
-		RootInstances.Remove(InstanceToFinish);
+		RemoveRootInstance(InstanceToFinish);
 		InstanceToFinish->FinishFlow(FinishPolicy);
 	}
+
+	RemoveSharedSubFlows(Owner);
 }
 
 UFlowAsset* UFlowSubsystem::CreateSubFlow(UFlowNode_SubGraph* SubGraphNode, const FString SavedInstanceName, const bool bPreloading /* = false */)
 {
+	// SubGraph restored from SaveGame always gets own instance, shared instances aren't saved
+	if (SavedInstanceName.IsEmpty())
+	{
+		if (UFlowAsset* SharedInstance = FindOrCreateSharedSubFlow(SubGraphNode))
+		{
+			if (!bPreloading)
+			{
+				SharedInstance->ExecuteSharedInstance(SubGraphNode, NAME_None);
+			}
+			return SharedInstance;
+		}
+	}
+
 	UFlowAsset* NewInstance = nullptr;
 
 	if (!InstancedSubFlows.Contains(SubGraphNode))
 	{
 		const TWeakObjectPtr<UObject> Owner = SubGraphNode->GetFlowAsset() ? SubGraphNode->GetFlowAsset()->GetOwner() : nullptr;
-		NewInstance = CreateFlowInstance(Owner, SubGraphNode->Asset, SavedInstanceName);
+		NewInstance = CreateFlowInstance(Owner, SubGraphNode->Asset, SavedInstanceName, SubGraphNode->Parameters);
 
 		if (NewInstance)
 		{
@@ -209,8 +374,86 @@ void UFlowSubsystem::RemoveSubFlow(UFlowNode_SubGraph* SubGraphNode, const EFlow
 	}
 }
 
-UFlowAsset* UFlowSubsystem::CreateFlowInstance(const TWeakObjectPtr<UObject> Owner, TSoftObjectPtr<UFlowAsset> FlowAsset, FString NewInstanceName)
+UFlowAsset* UFlowSubsystem::FindOrCreateSharedSubFlow(UFlowNode_SubGraph* SubGraphNode)
 {
+	// SubGraph providing its own parameter values can't share the instance
+	UFlowAsset* SubGraphAsset = SubGraphNode->Asset.LoadSynchronous();
+	if (SubGraphAsset == nullptr || SubGraphAsset->SharedInstanceScope == EFlowSharedInstanceScope::None || SubGraphNode->Parameters.Num() > 0)
+	{
+		return nullptr;
+	}
+
+	UObject* RootOwner = SubGraphNode->GetFlowAsset() ? SubGraphNode->GetFlowAsset()->GetOwner() : nullptr;
+	UObject* Scope = nullptr;
+	switch (SubGraphAsset->SharedInstanceScope)
+	{
+		case EFlowSharedInstanceScope::Subsystem:
+			Scope = GetGameInstance();
+			break;
+		case EFlowSharedInstanceScope::World:
+			Scope = RootOwner && RootOwner->GetWorld() ? RootOwner->GetWorld() : GetWorld();
+			break;
+		case EFlowSharedInstanceScope::RootOwner:
+			Scope = RootOwner;
+			break;
+		default: ;
+	}
+
+	if (Scope == nullptr)
+	{
+		return nullptr;
+	}
+
+	const TPair<UFlowAsset*, FObjectKey> Key(SubGraphAsset, FObjectKey(Scope));
+	if (UFlowAsset* SharedInstance = SharedSubFlows.FindRef(Key))
+	{
+		return SharedInstance;
+	}
+
+	// good moment to release instances of scopes destroyed in the meantime
+	RemoveSharedSubFlows(nullptr);
+
+	UFlowAsset* NewInstance = CreateFlowInstance(Scope, SubGraphAsset);
+	if (NewInstance)
+	{
+		NewInstance->bSharedInstance = true;
+		NewInstance->PreStartFlow();
+		SharedSubFlows.Add(Key, NewInstance);
+	}
+
+	return NewInstance;
+}
+
+void UFlowSubsystem::RemoveSharedSubFlows(const UObject* Scope)
+{
+	if (SharedSubFlows.Num() == 0)
+	{
+		return;
+	}
+
+	const FObjectKey ScopeKey(Scope);
+	TArray<UFlowAsset*> InstancesToFinish;
+
+	for (auto It = SharedSubFlows.CreateIterator(); It; ++It)
+	{
+		if ((Scope && It.Key().Value == ScopeKey) || It.Key().Value.ResolveObjectPtr() == nullptr)
+		{
+			InstancesToFinish.Emplace(It.Value());
+			It.RemoveCurrent();
+		}
+	}
+
+	for (UFlowAsset* InstanceToFinish : InstancesToFinish)
+	{
+		InstanceToFinish->FinishFlow(EFlowFinishPolicy::Keep);
+	}
+}
+
+UFlowAsset* UFlowSubsystem::CreateFlowInstance(const TWeakObjectPtr<UObject> Owner, TSoftObjectPtr<UFlowAsset> FlowAsset, FString NewInstanceName, const TArray<FFlowParameter>& Parameters)
+{
+	SCOPE_CYCLE_COUNTER(STAT_FlowCreateInstance);
+	LLM_SCOPE_BYTAG(Flow_Instances);
+
 	UFlowAsset* LoadedFlowAsset = FlowAsset.LoadSynchronous();
 	if (LoadedFlowAsset == nullptr)
 	{
@@ -234,8 +477,26 @@ UFlowAsset* UFlowSubsystem::CreateFlowInstance(const TWeakObjectPtr<UObject> Own
 	}
 
 	UFlowAsset* NewInstance = NewObject<UFlowAsset>(this, LoadedFlowAsset->GetClass(), *NewInstanceName, RF_Transient, LoadedFlowAsset, false, nullptr);
+
+	// instance keeps only values differing from template defaults
+	for (const FFlowParameter& Parameter : Parameters)
+	{
+		const FFlowParameter* Default = FFlowParameter::Find(LoadedFlowAsset->Parameters, Parameter.Name);
+		if (Default == nullptr || Default->Value != Parameter.Value)
+		{
+			NewInstance->ParameterOverrides.Add(Parameter);
+		}
+	}
+
 	NewInstance->InitializeInstance(Owner, LoadedFlowAsset);
 
+	// generated code is valid only for the exact topology it was generated from
+	const FFlowCookedGraph& CookedGraph = LoadedFlowAsset->GetCookedGraph();
+	if (CookedGraph.IsValid())
+	{
+		NewInstance->NativeGraph = FFlowNativeGraphRegistry::Find(LoadedFlowAsset->GetPackage()->GetFName(), CookedGraph.Hash);
+	}
+
 	LoadedFlowAsset->AddInstance(NewInstance);
 
 	return NewInstance;
@@ -264,6 +525,86 @@ void UFlowSubsystem::RemoveInstancedTemplate(UFlowAsset* Template)
 	InstancedTemplates.Remove(Template);
 }
 
+void UFlowSubsystem::AddRootInstance(UFlowAsset* Instance, UObject* Owner)
+{
+	RootInstances.Add(Instance, Owner);
+
+	if (bShardedByWorld)
+	{
+		WorldShards.FindOrAdd(TObjectKey<UWorld>(GetOwnerWorld(Owner))).RootInstances.Add(Instance, Owner);
+	}
+}
+
+void UFlowSubsystem::RemoveRootInstance(UFlowAsset* Instance)
+{
+	// instance finishing itself is removed here, one finished by its owner has been removed already
+	if (RootInstances.Remove(Instance) == 0)
+	{
+		return;
+	}
+
+	if (bShardedByWorld)
+	{
+		FFlowWorldShard* WorldShard = WorldShards.Find(TObjectKey<UWorld>(GetOwnerWorld(Instance->GetOwner())));
+		if (WorldShard && WorldShard->RootInstances.Remove(Instance) > 0)
+		{
+			return;
+		}
+
+		// owner is already gone, so its world is unknown
+		for (TPair<TObjectKey<UWorld>, FFlowWorldShard>& Shard : WorldShards)
+		{
+			if (Shard.Value.RootInstances.Remove(Instance) > 0)
+			{
+				return;
+			}
+		}
+	}
+}
+
+const TMap<UFlowAsset*, TWeakObjectPtr<UObject>>& UFlowSubsystem::GetRootInstancesInWorldOf(const UObject* Owner) const
+{
+	if (bShardedByWorld)
+	{
+		static const TMap<UFlowAsset*, TWeakObjectPtr<UObject>> NoInstances;
+
+		const FFlowWorldShard* WorldShard = WorldShards.Find(TObjectKey<UWorld>(GetOwnerWorld(Owner)));
+		return WorldShard ? WorldShard->RootInstances : NoInstances;
+	}
+
+	return RootInstances;
+}
+
+UWorld* UFlowSubsystem::GetOwnerWorld(const UObject* Owner) const
+{
+	UWorld* OwnerWorld = Owner ? Owner->GetWorld() : nullptr;
+	return OwnerWorld ? OwnerWorld : GetWorld();
+}
+
+void UFlowSubsystem::OnWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources)
+{
+	RemoveSharedSubFlows(World);
+
+	// without sharding, Root Flows are finished by their owners as before
+	if (!bShardedByWorld)
+	{
+		return;
+	}
+
+	if (FFlowWorldShard* WorldShard = WorldShards.Find(TObjectKey<UWorld>(World)))
+	{
+		TArray<UFlowAsset*> InstancesToFinish;
+		WorldShard->RootInstances.GenerateKeyArray(InstancesToFinish);
+		WorldShards.Remove(TObjectKey<UWorld>(World));
+
+		for (UFlowAsset* InstanceToFinish : InstancesToFinish)
+		{
+			RootInstances.Remove(InstanceToFinish);
+			InstanceToFinish->FinishFlow(EFlowFinishPolicy::Abort);
+		}
+	}
+}
+
 TMap<UObject*, UFlowAsset*> UFlowSubsystem::GetRootInstances() const
 {
 	TMap<UObject*, UFlowAsset*> Result;
@@ -277,7 +618,7 @@ TMap<UObject*, UFlowAsset*> UFlowSubsystem::GetRootInstances() const
 TSet<UFlowAsset*> UFlowSubsystem::GetRootInstancesByOwner(const UObject* Owner) const
 {
 	TSet<UFlowAsset*> Result;
-	for (const TPair<UFlowAsset*, TWeakObjectPtr<UObject>>& RootInstance : RootInstances)
+	for (const TPair<UFlowAsset*, TWeakObjectPtr<UObject>>& RootInstance : GetRootInstancesInWorldOf(Owner))
 	{
 		if (Owner && RootInstance.Value == Owner)
 		{
@@ -303,18 +644,295 @@ UWorld* UFlowSubsystem::GetWorld() const
 	return GetGameInstance()->GetWorld();
 }
 
+void UFlowSubsystem::SetVirtualTimeEnabled(const bool bEnabled)
+{
+	if (bEnabled == IsVirtualTimeEnabled())
+	{
+		return;
+	}
+
+	// timers pending on one clock wouldn't ever fire on the other one
+	if (InstancedTemplates.Num() > 0)
+	{
+		UE_LOG(LogFlow, Warning, TEXT("Virtual time can't be toggled while any Flow instance is running, as running nodes might wait on the current clock."));
+		return;
+	}
+
+	if (bEnabled)
+	{
+		VirtualTimerManager = MakeShared<FTimerManager>(GetGameInstance());
+		VirtualTime = 0.0;
+	}
+	else
+	{
+		VirtualTimerManager.Reset();
+		VirtualTimeSequencePlayers.Empty();
+	}
+}
+
+void UFlowSubsystem::AdvanceVirtualTime(const float DeltaSeconds)
+{
+	if (!VirtualTimerManager.IsValid() || DeltaSeconds <= 0.0f)
+	{
+		return;
+	}
+
+	VirtualTime += DeltaSeconds;
+	VirtualTimerManager->Tick(DeltaSeconds);
+
+	// finishing playback might start another one, so iterate over a copy
+	const TArray<TWeakObjectPtr<UMovieSceneSequencePlayer>> SequencePlayers = VirtualTimeSequencePlayers;
+	for (const TWeakObjectPtr<UMovieSceneSequencePlayer>& SequencePlayer : SequencePlayers)
+	{
+		if (SequencePlayer.IsValid() && SequencePlayer->IsPlaying())
+		{
+			SequencePlayer->Update(DeltaSeconds);
+		}
+	}
+
+	VirtualTimeSequencePlayers.RemoveAllSwap([](const TWeakObjectPtr<UMovieSceneSequencePlayer>& SequencePlayer)
+	{
+		return !SequencePlayer.IsValid() || !(SequencePlayer->IsPlaying() || SequencePlayer->IsPaused());
+	});
+}
+
+FTimerManager* UFlowSubsystem::GetTimerManager() const
+{
+	return VirtualTimerManager.Get();
+}
+
+void UFlowSubsystem::RegisterSequencePlayer(UMovieSceneSequencePlayer* SequencePlayer)
+{
+	if (VirtualTimerManager.IsValid() && SequencePlayer)
+	{
+		VirtualTimeSequencePlayers.AddUnique(SequencePlayer);
+	}
+}
+
+void UFlowSubsystem::StartRecording()
+{
+	Recording = MakeShared<FFlowRecording>();
+	Recording->RandomSeed = RandomSeed;
+	Recording->bVirtualTime = IsVirtualTimeEnabled();
+
+	RecordingStartTime = IsVirtualTimeEnabled() ? VirtualTime : GetWorld()->GetTimeSeconds();
+
+	// instances created from now on are seeded in the same order by the replay
+	SeededInstances = 0;
+}
+
+bool UFlowSubsystem::StopRecording(const FString& Filename)
+{
+	const TSharedPtr<FFlowRecording> FinishedRecording = FinishRecording();
+	return FinishedRecording.IsValid() && FinishedRecording->SaveToFile(Filename);
+}
+
+TSharedPtr<FFlowRecording> UFlowSubsystem::FinishRecording()
+{
+	if (Recording.IsValid())
+	{
+		Recording->Duration = (IsVirtualTimeEnabled() ? VirtualTime : GetWorld()->GetTimeSeconds()) - RecordingStartTime;
+	}
+
+	TSharedPtr<FFlowRecording> FinishedRecording = Recording;
+	Recording.Reset();
+	return FinishedRecording;
+}
+
+void UFlowSubsystem::RecordEvent(FFlowRecordedEvent&& Event, const UObject* Object)
+{
+	if (Recording.IsValid())
+	{
+		Event.Time = (IsVirtualTimeEnabled() ? VirtualTime : GetWorld()->GetTimeSeconds()) - RecordingStartTime;
+		Event.Object = GetRecordedObjectName(Object);
+		Recording->Events.Emplace(MoveTemp(Event));
+	}
+}
+
+FString UFlowSubsystem::GetRecordedObjectName(const UObject* Object) const
+{
+	return Object ? Object->GetPathName(GetWorld()) : FString();
+}
+
+void UFlowSubsystem::SetRandomSeed(const int32 NewSeed)
+{
+	RandomSeed = NewSeed;
+	SeededInstances = 0;
+}
+
+int32 UFlowSubsystem::MakeInstanceSeed()
+{
+	return static_cast<int32>(HashCombine(GetTypeHash(RandomSeed), GetTypeHash(SeededInstances++)));
+}
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice FlowMemReportCommand(
+	TEXT("Flow.MemReport"),
+	TEXT("Lists memory used by Flow Graph instances, nodes, component registry and loaded SaveGame"),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+	{
+		UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+		if (UFlowSubsystem* FlowSubsystem = GameInstance ? GameInstance->GetSubsystem<UFlowSubsystem>() : nullptr)
+		{
+			FlowSubsystem->DumpMemoryReport(Ar);
+		}
+	}));
+
+void UFlowSubsystem::DumpMemoryReport(FOutputDevice& Ar)
+{
+	struct FMemoryGroup
+	{
+		int32 Count = 0;
+		int32 NodeCount = 0;
+		SIZE_T Bytes = 0;
+	};
+
+	// object itself and the memory it allocates, without objects it references
+	auto GetObjectSize = [](UObject* Object) -> SIZE_T
+	{
+		return Object->GetClass()->GetStructureSize() + Object->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+	};
+
+	TMap<FString, FMemoryGroup> Templates;
+	TMap<FString, FMemoryGroup> NodeClasses;
+	SIZE_T TotalBytes = 0;
+
+	for (UFlowAsset* Template : InstancedTemplates)
+	{
+		FMemoryGroup& TemplateGroup = Templates.FindOrAdd(Template->GetPathName());
+		for (UFlowAsset* Instance : Template->ActiveInstances)
+		{
+			TemplateGroup.Count++;
+			TemplateGroup.Bytes += GetObjectSize(Instance);
+
+			for (const TPair<FGuid, UFlowNode*>& Node : Instance->Nodes)
+			{
+				if (Node.Value)
+				{
+					const SIZE_T NodeBytes = GetObjectSize(Node.Value);
+					TemplateGroup.NodeCount++;
+					TemplateGroup.Bytes += NodeBytes;
+
+					FMemoryGroup& ClassGroup = NodeClasses.FindOrAdd(Node.Value->GetClass()->GetName());
+					ClassGroup.Count++;
+					ClassGroup.Bytes += NodeBytes;
+				}
+			}
+		}
+		TotalBytes += TemplateGroup.Bytes;
+	}
+
+	auto SortBySize = [](const FMemoryGroup& A, const FMemoryGroup& B) { return A.Bytes > B.Bytes; };
+	Templates.ValueSort(SortBySize);
+	NodeClasses.ValueSort(SortBySize);
+
+	Ar.Logf(TEXT("Flow instances: %d templates, %.2f KB"), Templates.Num(), TotalBytes / 1024.0f);
+	Ar.Logf(TEXT("%10s %10s %12s  %s"), TEXT("Instances"), TEXT("Nodes"), TEXT("KB"), TEXT("Template"));
+	for (const TPair<FString, FMemoryGroup>& Template : Templates)
+	{
+		Ar.Logf(TEXT("%10d %10d %12.2f  %s"), Template.Value.Count, Template.Value.NodeCount, Template.Value.Bytes / 1024.0f, *Template.Key);
+	}
+
+	Ar.Logf(TEXT(""));
+	Ar.Logf(TEXT("Flow nodes by class:"));
+	Ar.Logf(TEXT("%10s %12s  %s"), TEXT("Count"), TEXT("KB"), TEXT("Class"));
+	for (const TPair<FString, FMemoryGroup>& NodeClass : NodeClasses)
+	{
+		Ar.Logf(TEXT("%10d %12.2f  %s"), NodeClass.Value.Count, NodeClass.Value.Bytes / 1024.0f, *NodeClass.Key);
+	}
+
+	Ar.Logf(TEXT(""));
+	int32 RegistryEntries = FlowComponentRegistry.Num();
+	SIZE_T RegistryBytes = FlowComponentRegistry.GetAllocatedSize();
+	for (const TPair<TObjectKey<UWorld>, FFlowWorldShard>& WorldShard : WorldShards)
+	{
+		RegistryEntries += WorldShard.Value.ComponentRegistry.Num();
+		RegistryBytes += WorldShard.Value.ComponentRegistry.GetAllocatedSize() + WorldShard.Value.RootInstances.GetAllocatedSize();
+	}
+	Ar.Logf(TEXT("Flow Component Registry: %d entries, %d worlds, %.2f KB"), RegistryEntries, FMath::Max(1, WorldShards.Num()), RegistryBytes / 1024.0f);
+
+	// buckets of the most common Identity Tags bound the cost of registry queries
+	constexpr int32 MaxReportedBuckets = 10;
+	TArray<TPair<FGameplayTag, int32>> LargestBuckets;
+	FlowComponentRegistry.GetLargestBuckets(MaxReportedBuckets, LargestBuckets);
+	for (const TPair<TObjectKey<UWorld>, FFlowWorldShard>& WorldShard : WorldShards)
+	{
+		TArray<TPair<FGameplayTag, int32>> ShardBuckets;
+		WorldShard.Value.ComponentRegistry.GetLargestBuckets(MaxReportedBuckets, ShardBuckets);
+		LargestBuckets.Append(ShardBuckets);
+	}
+	LargestBuckets.Sort([](const TPair<FGameplayTag, int32>& A, const TPair<FGameplayTag, int32>& B) { return A.Value > B.Value; });
+
+	Ar.Logf(TEXT("%10s  %s"), TEXT("Components"), TEXT("Identity Tag"));
+	for (int32 i = 0; i < FMath::Min(MaxReportedBuckets, LargestBuckets.Num()); i++)
+	{
+		Ar.Logf(TEXT("%10d  %s"), LargestBuckets[i].Value, *LargestBuckets[i].Key.ToString());
+	}
+
+	if (ReleasedRootFlows.Num() > 0)
+	{
+		int32 ReleasedInstances = 0;
+		SIZE_T ReleasedBytes = ReleasedRootFlows.GetAllocatedSize();
+		for (const TPair<FString, TArray<FFlowAssetSaveData>>& ReleasedRootFlow : ReleasedRootFlows)
+		{
+			ReleasedInstances += ReleasedRootFlow.Value.Num();
+			ReleasedBytes += ReleasedRootFlow.Key.GetAllocatedSize() + ReleasedRootFlow.Value.GetAllocatedSize();
+			for (const FFlowAssetSaveData& AssetRecord : ReleasedRootFlow.Value)
+			{
+				ReleasedBytes += AssetRecord.AssetData.GetAllocatedSize() + AssetRecord.NodeRecords.GetAllocatedSize();
+			}
+		}
+		Ar.Logf(TEXT("Flow released Root Flows: %d root, %d instances, %.2f KB"), ReleasedRootFlows.Num(), ReleasedInstances, ReleasedBytes / 1024.0f);
+	}
+
+	if (LoadedSaveGame)
+	{
+		SIZE_T SaveGameBytes = LoadedSaveGame->FlowInstances.GetAllocatedSize() + LoadedSaveGame->FlowComponents.GetAllocatedSize();
+		for (const FFlowAssetSaveData& AssetRecord : LoadedSaveGame->FlowInstances)
+		{
+			SaveGameBytes += AssetRecord.AssetData.GetAllocatedSize() + AssetRecord.NodeRecords.GetAllocatedSize();
+			for (const FFlowNodeSaveData& NodeRecord : AssetRecord.NodeRecords)
+			{
+				SaveGameBytes += NodeRecord.NodeData.GetAllocatedSize();
+			}
+		}
+		for (const FFlowComponentSaveData& ComponentRecord : LoadedSaveGame->FlowComponents)
+		{
+			SaveGameBytes += ComponentRecord.ComponentData.GetAllocatedSize();
+		}
+
+		Ar.Logf(TEXT("Flow SaveGame buffers: %d assets, %d components, %.2f KB"), LoadedSaveGame->FlowInstances.Num(), LoadedSaveGame->FlowComponents.Num(), SaveGameBytes / 1024.0f);
+	}
+}
+
 void UFlowSubsystem::OnGameSaved(UFlowSaveGame* SaveGame)
 {
+	SCOPE_CYCLE_COUNTER(STAT_FlowSaveGame);
+	TRACE_FLOW_SPAN_SCOPE(SaveGame);
+	CSV_SCOPED_TIMING_STAT(Flow, SaveGame);
+	LLM_SCOPE_BYTAG(Flow_SaveGame);
+
 	// clear existing data, in case we received reused SaveGame instance
 	// we only remove data for the current world + global Flow Graph instances (i.e. not bound to any world if created by UGameInstanceSubsystem)
 	// we keep data bound to other worlds
+	// if the subsystem is sharded, every world with its own partition is saved
+	TSet<FString> WorldNames;
 	if (GetWorld())
 	{
-		const FString& WorldName = GetWorld()->GetName();
+		WorldNames.Add(GetWorld()->GetName());
+	}
+	for (const TPair<TObjectKey<UWorld>, FFlowWorldShard>& WorldShard : WorldShards)
+	{
+		if (const UWorld* ShardWorld = WorldShard.Key.ResolveObjectPtr())
+		{
+			WorldNames.Add(ShardWorld->GetName());
+		}
+	}
 
+	if (WorldNames.Num() > 0)
+	{
 		for (int32 i = SaveGame->FlowInstances.Num() - 1; i >= 0; i--)
 		{
-			if (SaveGame->FlowInstances[i].WorldName.IsEmpty() || SaveGame->FlowInstances[i].WorldName == WorldName)
+			if (SaveGame->FlowInstances[i].WorldName.IsEmpty() || WorldNames.Contains(SaveGame->FlowInstances[i].WorldName))
 			{
 				SaveGame->FlowInstances.RemoveAt(i);
 			}
@@ -322,11 +940,19 @@ void UFlowSubsystem::OnGameSaved(UFlowSaveGame* SaveGame)
 
 		for (int32 i = SaveGame->FlowComponents.Num() - 1; i >= 0; i--)
 		{
-			if (SaveGame->FlowComponents[i].WorldName.IsEmpty() || SaveGame->FlowComponents[i].WorldName == WorldName)
+			if (SaveGame->FlowComponents[i].WorldName.IsEmpty() || WorldNames.Contains(SaveGame->FlowComponents[i].WorldName))
 			{
 				SaveGame->FlowComponents.RemoveAt(i);
 			}
 		}
+
+		for (int32 i = SaveGame->ReleasedRootFlows.Num() - 1; i >= 0; i--)
+		{
+			if (SaveGame->ReleasedRootFlows[i].WorldName.IsEmpty() || WorldNames.Contains(SaveGame->ReleasedRootFlows[i].WorldName))
+			{
+				SaveGame->ReleasedRootFlows.RemoveAt(i);
+			}
+		}
 	}
 
 	// save Flow Graphs
@@ -345,14 +971,29 @@ void UFlowSubsystem::OnGameSaved(UFlowSaveGame* SaveGame)
 		}
 	}
 
-	// save Flow Components
+	// save Root Flows released by their owners, i.e. Flows of streaming levels hidden at this moment
+	for (const TPair<FString, TArray<FFlowAssetSaveData>>& ReleasedRootFlow : ReleasedRootFlows)
 	{
-		// retrieve all registered components
-		TArray<TWeakObjectPtr<UFlowComponent>> ComponentsArray;
-		FlowComponentRegistry.GenerateValueArray(ComponentsArray);
+		FFlowReleasedRootFlowSaveData& ReleasedRecord = SaveGame->ReleasedRootFlows.AddDefaulted_GetRef();
+		ReleasedRecord.InstanceName = ReleasedRootFlow.Key;
+		ReleasedRecord.FlowInstances = ReleasedRootFlow.Value;
 
-		// ensure uniqueness of entries
-		const TSet<TWeakObjectPtr<UFlowComponent>> RegisteredComponents = TSet<TWeakObjectPtr<UFlowComponent>>(ComponentsArray);
+		// root instance is saved after its sub-flows
+		if (ReleasedRootFlow.Value.Num() > 0)
+		{
+			ReleasedRecord.WorldName = ReleasedRootFlow.Value.Last().WorldName;
+		}
+	}
+
+	// save Flow Components
+	{
+		// retrieve all registered components, every component once
+		TSet<TWeakObjectPtr<UFlowComponent>> RegisteredComponents;
+		FlowComponentRegistry.GetAllComponents(RegisteredComponents);
+		for (const TPair<TObjectKey<UWorld>, FFlowWorldShard>& WorldShard : WorldShards)
+		{
+			WorldShard.Value.ComponentRegistry.GetAllComponents(RegisteredComponents);
+		}
 
 		// write archives to SaveGame
 		for (const TWeakObjectPtr<UFlowComponent> RegisteredComponent : RegisteredComponents)
@@ -364,6 +1005,8 @@ void UFlowSubsystem::OnGameSaved(UFlowSaveGame* SaveGame)
 
 void UFlowSubsystem::OnGameLoaded(UFlowSaveGame* SaveGame)
 {
+	LLM_SCOPE_BYTAG(Flow_SaveGame);
+
 	LoadedSaveGame = SaveGame;
 
 	// here's opportunity to apply loaded data to custom systems
@@ -377,10 +1020,15 @@ void UFlowSubsystem::LoadRootFlow(UObject* Owner, UFlowAsset* FlowAsset, const F
 		return;
 	}
 
+	SCOPE_CYCLE_COUNTER(STAT_FlowLoadRootFlow);
+	TRACE_FLOW_SPAN_SCOPE(LoadGame);
+	CSV_SCOPED_TIMING_STAT(Flow, LoadGame);
+	LLM_SCOPE_BYTAG(Flow_SaveGame);
+
 	for (const FFlowAssetSaveData& AssetRecord : LoadedSaveGame->FlowInstances)
 	{
 		if (AssetRecord.InstanceName == SavedAssetInstanceName
-			&& (FlowAsset->IsBoundToWorld() == false || AssetRecord.WorldName == GetWorld()->GetName()))
+			&& (FlowAsset->IsBoundToWorld() == false || AssetRecord.WorldName == GetOwnerWorld(Owner)->GetName()))
 		{
 			UFlowAsset* LoadedInstance = CreateRootFlow(Owner, FlowAsset, false);
 			if (LoadedInstance)
@@ -399,12 +1047,26 @@ void UFlowSubsystem::LoadSubFlow(UFlowNode_SubGraph* SubGraphNode, const FString
 		return;
 	}
 
+	TRACE_FLOW_SPAN_SCOPE(LoadGame);
+	CSV_SCOPED_TIMING_STAT(Flow, LoadGame);
+	LLM_SCOPE_BYTAG(Flow_SaveGame);
+
+	// sub-flow of the instance being restored after ReleaseRootFlow
+	if (const FFlowAssetSaveData* ReleasedRecord = FindReleasedInstance(SavedAssetInstanceName))
+	{
+		if (UFlowAsset* LoadedInstance = CreateSubFlow(SubGraphNode, SavedAssetInstanceName))
+		{
+			LoadedInstance->LoadInstance(*ReleasedRecord);
+		}
+		return;
+	}
+
 	UFlowAsset* SubGraphAsset = SubGraphNode->Asset.LoadSynchronous();
 
 	for (const FFlowAssetSaveData& AssetRecord : LoadedSaveGame->FlowInstances)
 	{
 		if (AssetRecord.InstanceName == SavedAssetInstanceName
-			&& ((SubGraphAsset && SubGraphAsset->IsBoundToWorld() == false) || AssetRecord.WorldName == GetWorld()->GetName()))
+			&& ((SubGraphAsset && SubGraphAsset->IsBoundToWorld() == false) || AssetRecord.WorldName == GetOwnerWorld(SubGraphNode->GetFlowAsset())->GetName()))
 		{
 			UFlowAsset* LoadedInstance = CreateSubFlow(SubGraphNode, SavedAssetInstanceName);
 			if (LoadedInstance)
@@ -416,22 +1078,170 @@ void UFlowSubsystem::LoadSubFlow(UFlowNode_SubGraph* SubGraphNode, const FString
 	}
 }
 
-void UFlowSubsystem::RegisterComponent(UFlowComponent* Component)
+FString UFlowSubsystem::ReleaseRootFlow(UFlowAsset* RootInstance)
+{
+	if (RootInstance == nullptr || !RootInstances.Contains(RootInstance))
+	{
+		return FString();
+	}
+
+	LLM_SCOPE_BYTAG(Flow_SaveGame);
+
+	TArray<FFlowAssetSaveData> SavedFlowInstances;
+	const FString InstanceName = RootInstance->SaveInstance(SavedFlowInstances).InstanceName;
+
+	// restored sub-flows are created under their saved names, so the released objects can't keep these names
+	TArray<UFlowAsset*> ReleasedInstances;
+	for (const FFlowAssetSaveData& AssetRecord : SavedFlowInstances)
+	{
+		if (UFlowAsset* ReleasedInstance = FindObjectFast<UFlowAsset>(this, *AssetRecord.InstanceName))
+		{
+			ReleasedInstances.Emplace(ReleasedInstance);
+		}
+	}
+
+	ReleasedRootFlows.Emplace(InstanceName, MoveTemp(SavedFlowInstances));
+	FinishRootInstance(RootInstance, EFlowFinishPolicy::Keep);
+
+	for (UFlowAsset* ReleasedInstance : ReleasedInstances)
+	{
+		const FName ReleasedName = MakeUniqueObjectName(this, ReleasedInstance->GetClass(), *FString::Printf(TEXT("%s_Released"), *ReleasedInstance->GetName()));
+		ReleasedInstance->Rename(*ReleasedName.ToString(), nullptr, REN_DontCreateRedirectors | REN_NonTransactional);
+		ReleasedInstance->MarkAsGarbage();
+	}
+
+	return InstanceName;
+}
+
+UFlowAsset* UFlowSubsystem::RestoreRootFlow(UObject* Owner, UFlowAsset* FlowAsset, const FString& ReleasedInstanceName)
+{
+	const FFlowAssetSaveData* AssetRecord = FindReleasedInstance(ReleasedInstanceName);
+	if (Owner == nullptr || FlowAsset == nullptr || AssetRecord == nullptr)
+	{
+		return nullptr;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_FlowLoadRootFlow);
+	TRACE_FLOW_SPAN_SCOPE(LoadGame);
+	CSV_SCOPED_TIMING_STAT(Flow, LoadGame);
+	LLM_SCOPE_BYTAG(Flow_SaveGame);
+
+	// owner might have released many instances of the same asset, each one is restored separately
+	// released objects were renamed, so the instance takes back its name and it's saved under the same name again
+	UFlowAsset* RestoredInstance = CreateRootInstance(Owner, FlowAsset, TArray<FFlowParameter>(), ReleasedInstanceName);
+	if (RestoredInstance)
+	{
+		// sub-flows find their records while loading the root instance
+		RestoredInstance->LoadInstance(*AssetRecord);
+	}
+
+	ReleasedRootFlows.Remove(ReleasedInstanceName);
+	return RestoredInstance;
+}
+
+void UFlowSubsystem::DiscardReleasedRootFlow(const FString& ReleasedInstanceName)
+{
+	ReleasedRootFlows.Remove(ReleasedInstanceName);
+}
+
+UFlowAsset* UFlowSubsystem::LoadOwnedRootFlow(UObject* Owner, UFlowAsset* FlowAsset, const FString& SavedAssetInstanceName)
+{
+	if (Owner == nullptr || FlowAsset == nullptr || SavedAssetInstanceName.IsEmpty() || LoadedSaveGame == nullptr)
+	{
+		return nullptr;
+	}
+
+	const FString WorldName = GetOwnerWorld(Owner)->GetName();
+
+	for (const FFlowAssetSaveData& AssetRecord : LoadedSaveGame->FlowInstances)
+	{
+		if (AssetRecord.InstanceName == SavedAssetInstanceName
+			&& (FlowAsset->IsBoundToWorld() == false || AssetRecord.WorldName == WorldName))
+		{
+			SCOPE_CYCLE_COUNTER(STAT_FlowLoadRootFlow);
+			TRACE_FLOW_SPAN_SCOPE(LoadGame);
+			CSV_SCOPED_TIMING_STAT(Flow, LoadGame);
+			LLM_SCOPE_BYTAG(Flow_SaveGame);
+
+			UFlowAsset* LoadedInstance = CreateRootInstance(Owner, FlowAsset, TArray<FFlowParameter>(), SavedAssetInstanceName);
+			if (LoadedInstance)
+			{
+				LoadedInstance->LoadInstance(AssetRecord);
+			}
+			return LoadedInstance;
+		}
+	}
+
+	for (const FFlowReleasedRootFlowSaveData& ReleasedRecord : LoadedSaveGame->ReleasedRootFlows)
+	{
+		if (ReleasedRecord.InstanceName == SavedAssetInstanceName
+			&& (FlowAsset->IsBoundToWorld() == false || ReleasedRecord.WorldName == WorldName))
+		{
+			// released records are kept by the subsystem until restored, the same as after ReleaseRootFlow
+			ReleasedRootFlows.Emplace(SavedAssetInstanceName, ReleasedRecord.FlowInstances);
+			return RestoreRootFlow(Owner, FlowAsset, SavedAssetInstanceName);
+		}
+	}
+
+	return nullptr;
+}
+
+const FFlowAssetSaveData* UFlowSubsystem::FindReleasedInstance(const FString& InstanceName) const
 {
-	for (const FGameplayTag& Tag : Component->IdentityTags)
+	for (const TPair<FString, TArray<FFlowAssetSaveData>>& ReleasedRootFlow : ReleasedRootFlows)
 	{
-		if (Tag.IsValid())
+		for (const FFlowAssetSaveData& AssetRecord : ReleasedRootFlow.Value)
 		{
-			FlowComponentRegistry.Emplace(Tag, Component);
+			if (AssetRecord.InstanceName == InstanceName)
+			{
+				return &AssetRecord;
+			}
 		}
 	}
 
+	return nullptr;
+}
+
+void UFlowSubsystem::RegisterComponent(UFlowComponent* Component)
+{
+	LLM_SCOPE_BYTAG(Flow_Registry);
+
+	FFlowComponentRegistry& Registry = GetComponentRegistry(Component->GetWorld());
+	Registry.Add(Component->IdentityTags, Component);
+
+	SET_DWORD_STAT(STAT_FlowRegistrySize, Registry.Num());
+	SET_DWORD_STAT(STAT_FlowRegistryBuckets, Registry.NumBuckets());
+	SET_DWORD_STAT(STAT_FlowRegistryLargestBucket, Registry.GetLargestBucketSize());
+
+	if (IsRecording())
+	{
+		FFlowRecordedEvent Event;
+		Event.Type = EFlowRecordedEventType::ComponentRegistered;
+		Event.Tags = Component->IdentityTags;
+		RecordEvent(MoveTemp(Event), Component);
+	}
+
 	OnComponentRegistered.Broadcast(Component);
 }
 
 void UFlowSubsystem::OnIdentityTagAdded(UFlowComponent* Component, const FGameplayTag& AddedTag)
 {
-	FlowComponentRegistry.Emplace(AddedTag, Component);
+	LLM_SCOPE_BYTAG(Flow_Registry);
+
+	FFlowComponentRegistry& Registry = GetComponentRegistry(Component->GetWorld());
+	Registry.Add(AddedTag, Component);
+
+	SET_DWORD_STAT(STAT_FlowRegistrySize, Registry.Num());
+	SET_DWORD_STAT(STAT_FlowRegistryBuckets, Registry.NumBuckets());
+	SET_DWORD_STAT(STAT_FlowRegistryLargestBucket, Registry.GetLargestBucketSize());
+
+	if (IsRecording())
+	{
+		FFlowRecordedEvent Event;
+		Event.Type = EFlowRecordedEventType::IdentityTagsAdded;
+		Event.Tags = FGameplayTagContainer(AddedTag);
+		RecordEvent(MoveTemp(Event), Component);
+	}
 
 	// broadcast OnComponentRegistered only if this component wasn't present in the registry previously
 	if (Component->IdentityTags.Num() > 1)
@@ -446,9 +1256,21 @@ void UFlowSubsystem::OnIdentityTagAdded(UFlowComponent* Component, const FGamepl
 
 void UFlowSubsystem::OnIdentityTagsAdded(UFlowComponent* Component, const FGameplayTagContainer& AddedTags)
 {
-	for (const FGameplayTag& Tag : AddedTags)
+	LLM_SCOPE_BYTAG(Flow_Registry);
+
+	FFlowComponentRegistry& Registry = GetComponentRegistry(Component->GetWorld());
+	Registry.Add(AddedTags, Component);
+
+	SET_DWORD_STAT(STAT_FlowRegistrySize, Registry.Num());
+	SET_DWORD_STAT(STAT_FlowRegistryBuckets, Registry.NumBuckets());
+	SET_DWORD_STAT(STAT_FlowRegistryLargestBucket, Registry.GetLargestBucketSize());
+
+	if (IsRecording())
 	{
-		FlowComponentRegistry.Emplace(Tag, Component);
+		FFlowRecordedEvent Event;
+		Event.Type = EFlowRecordedEventType::IdentityTagsAdded;
+		Event.Tags = AddedTags;
+		RecordEvent(MoveTemp(Event), Component);
 	}
 
 	// broadcast OnComponentRegistered only if this component wasn't present in the registry previously
@@ -464,12 +1286,20 @@ void UFlowSubsystem::OnIdentityTagsAdded(UFlowComponent* Component, const FGamep
 
 void UFlowSubsystem::UnregisterComponent(UFlowComponent* Component)
 {
-	for (const FGameplayTag& Tag : Component->IdentityTags)
+	// registry of the world might be already dropped by the world cleanup
+	if (FFlowComponentRegistry* Registry = FindComponentRegistry(Component->GetWorld()))
 	{
-		if (Tag.IsValid())
-		{
-			FlowComponentRegistry.Remove(Tag, Component);
-		}
+		Registry->Remove(Component->IdentityTags, Component);
+		SET_DWORD_STAT(STAT_FlowRegistrySize, Registry->Num());
+		SET_DWORD_STAT(STAT_FlowRegistryBuckets, Registry->NumBuckets());
+		SET_DWORD_STAT(STAT_FlowRegistryLargestBucket, Registry->GetLargestBucketSize());
+	}
+
+	if (IsRecording())
+	{
+		FFlowRecordedEvent Event;
+		Event.Type = EFlowRecordedEventType::ComponentUnregistered;
+		RecordEvent(MoveTemp(Event), Component);
 	}
 
 	OnComponentUnregistered.Broadcast(Component);
@@ -477,7 +1307,21 @@ void UFlowSubsystem::UnregisterComponent(UFlowComponent* Component)
 
 void UFlowSubsystem::OnIdentityTagRemoved(UFlowComponent* Component, const FGameplayTag& RemovedTag)
 {
-	FlowComponentRegistry.Remove(RemovedTag, Component);
+	if (FFlowComponentRegistry* Registry = FindComponentRegistry(Component->GetWorld()))
+	{
+		Registry->Remove(RemovedTag, Component);
+		SET_DWORD_STAT(STAT_FlowRegistrySize, Registry->Num());
+		SET_DWORD_STAT(STAT_FlowRegistryBuckets, Registry->NumBuckets());
+		SET_DWORD_STAT(STAT_FlowRegistryLargestBucket, Registry->GetLargestBucketSize());
+	}
+
+	if (IsRecording())
+	{
+		FFlowRecordedEvent Event;
+		Event.Type = EFlowRecordedEventType::IdentityTagsRemoved;
+		Event.Tags = FGameplayTagContainer(RemovedTag);
+		RecordEvent(MoveTemp(Event), Component);
+	}
 
 	// broadcast OnComponentUnregistered only if this component isn't present in the registry anymore
 	if (Component->IdentityTags.Num() > 0)
@@ -492,9 +1336,20 @@ void UFlowSubsystem::OnIdentityTagRemoved(UFlowComponent* Component, const FGame
 
 void UFlowSubsystem::OnIdentityTagsRemoved(UFlowComponent* Component, const FGameplayTagContainer& RemovedTags)
 {
-	for (const FGameplayTag& Tag : RemovedTags)
+	if (FFlowComponentRegistry* Registry = FindComponentRegistry(Component->GetWorld()))
+	{
+		Registry->Remove(RemovedTags, Component);
+		SET_DWORD_STAT(STAT_FlowRegistrySize, Registry->Num());
+		SET_DWORD_STAT(STAT_FlowRegistryBuckets, Registry->NumBuckets());
+		SET_DWORD_STAT(STAT_FlowRegistryLargestBucket, Registry->GetLargestBucketSize());
+	}
+
+	if (IsRecording())
 	{
-		FlowComponentRegistry.Remove(Tag, Component);
+		FFlowRecordedEvent Event;
+		Event.Type = EFlowRecordedEventType::IdentityTagsRemoved;
+		Event.Tags = RemovedTags;
+		RecordEvent(MoveTemp(Event), Component);
 	}
 
 	// broadcast OnComponentUnregistered only if this component isn't present in the registry anymore
@@ -508,155 +1363,193 @@ void UFlowSubsystem::OnIdentityTagsRemoved(UFlowComponent* Component, const FGam
 	}
 }
 
-TSet<UFlowComponent*> UFlowSubsystem::GetFlowComponentsByTag(const FGameplayTag Tag, const TSubclassOf<UFlowComponent> ComponentClass, const bool bExactMatch) const
+TSet<UFlowComponent*> UFlowSubsystem::GetFlowComponentsByTagInWorld(const UObject* WorldContextObject, const FGameplayTag Tag, const TSubclassOf<UFlowComponent> ComponentClass, const bool bExactMatch) const
 {
-	TArray<TWeakObjectPtr<UFlowComponent>> FoundComponents;
-	FindComponents(Tag, bExactMatch, FoundComponents);
-
 	TSet<UFlowComponent*> Result;
-	for (const TWeakObjectPtr<UFlowComponent>& Component : FoundComponents)
+	VisitComponents(Tag, bExactMatch, [&](UFlowComponent* Component)
 	{
-		if (Component.IsValid() && Component->GetClass()->IsChildOf(ComponentClass))
+		if (Component->GetClass()->IsChildOf(ComponentClass))
 		{
-			Result.Emplace(Component.Get());
+			Result.Emplace(Component);
 		}
-	}
+		return true;
+	}, GetOwnerWorld(WorldContextObject));
 
 	return Result;
 }
 
-TSet<UFlowComponent*> UFlowSubsystem::GetFlowComponentsByTags(const FGameplayTagContainer Tags, const EGameplayContainerMatchType MatchType, const TSubclassOf<UFlowComponent> ComponentClass, const bool bExactMatch) const
+TSet<UFlowComponent*> UFlowSubsystem::GetFlowComponentsByTagsInWorld(const UObject* WorldContextObject, const FGameplayTagContainer Tags, const EGameplayContainerMatchType MatchType, const TSubclassOf<UFlowComponent> ComponentClass, const bool bExactMatch) const
 {
-	TSet<TWeakObjectPtr<UFlowComponent>> FoundComponents;
-	FindComponents(Tags, MatchType, bExactMatch, FoundComponents);
-
 	TSet<UFlowComponent*> Result;
-	for (const TWeakObjectPtr<UFlowComponent>& Component : FoundComponents)
+	VisitComponents(Tags, MatchType, bExactMatch, [&](UFlowComponent* Component)
 	{
-		if (Component.IsValid() && Component->GetClass()->IsChildOf(ComponentClass))
+		if (Component->GetClass()->IsChildOf(ComponentClass))
 		{
-			Result.Emplace(Component.Get());
+			Result.Emplace(Component);
 		}
-	}
+		return true;
+	}, GetOwnerWorld(WorldContextObject));
 
 	return Result;
 }
 
-TSet<AActor*> UFlowSubsystem::GetFlowActorsByTag(const FGameplayTag Tag, const TSubclassOf<AActor> ActorClass, const bool bExactMatch) const
+TSet<AActor*> UFlowSubsystem::GetFlowActorsByTagInWorld(const UObject* WorldContextObject, const FGameplayTag Tag, const TSubclassOf<AActor> ActorClass, const bool bExactMatch) const
 {
-	TArray<TWeakObjectPtr<UFlowComponent>> FoundComponents;
-	FindComponents(Tag, bExactMatch, FoundComponents);
-
 	TSet<AActor*> Result;
-	for (const TWeakObjectPtr<UFlowComponent>& Component : FoundComponents)
+	VisitComponents(Tag, bExactMatch, [&](UFlowComponent* Component)
 	{
-		if (Component.IsValid() && Component->GetOwner()->GetClass()->IsChildOf(ActorClass))
+		if (Component->GetOwner()->GetClass()->IsChildOf(ActorClass))
 		{
 			Result.Emplace(Component->GetOwner());
 		}
-	}
+		return true;
+	}, GetOwnerWorld(WorldContextObject));
 
 	return Result;
 }
 
-TSet<AActor*> UFlowSubsystem::GetFlowActorsByTags(const FGameplayTagContainer Tags, const EGameplayContainerMatchType MatchType, const TSubclassOf<AActor> ActorClass, const bool bExactMatch) const
+TSet<AActor*> UFlowSubsystem::GetFlowActorsByTagsInWorld(const UObject* WorldContextObject, const FGameplayTagContainer Tags, const EGameplayContainerMatchType MatchType, const TSubclassOf<AActor> ActorClass, const bool bExactMatch) const
 {
-	TSet<TWeakObjectPtr<UFlowComponent>> FoundComponents;
-	FindComponents(Tags, MatchType, bExactMatch, FoundComponents);
-
 	TSet<AActor*> Result;
-	for (const TWeakObjectPtr<UFlowComponent>& Component : FoundComponents)
+	VisitComponents(Tags, MatchType, bExactMatch, [&](UFlowComponent* Component)
 	{
-		if (Component.IsValid() && Component->GetOwner()->GetClass()->IsChildOf(ActorClass))
+		if (Component->GetOwner()->GetClass()->IsChildOf(ActorClass))
 		{
 			Result.Emplace(Component->GetOwner());
 		}
-	}
+		return true;
+	}, GetOwnerWorld(WorldContextObject));
 
 	return Result;
 }
 
-TMap<AActor*, UFlowComponent*> UFlowSubsystem::GetFlowActorsAndComponentsByTag(const FGameplayTag Tag, const TSubclassOf<AActor> ActorClass, const bool bExactMatch) const
+TMap<AActor*, UFlowComponent*> UFlowSubsystem::GetFlowActorsAndComponentsByTagInWorld(const UObject* WorldContextObject, const FGameplayTag Tag, const TSubclassOf<AActor> ActorClass, const bool bExactMatch) const
 {
-	TArray<TWeakObjectPtr<UFlowComponent>> FoundComponents;
-	FindComponents(Tag, bExactMatch, FoundComponents);
-
 	TMap<AActor*, UFlowComponent*> Result;
-	for (const TWeakObjectPtr<UFlowComponent>& Component : FoundComponents)
+	VisitComponents(Tag, bExactMatch, [&](UFlowComponent* Component)
 	{
-		if (Component.IsValid() && Component->GetOwner()->GetClass()->IsChildOf(ActorClass))
+		if (Component->GetOwner()->GetClass()->IsChildOf(ActorClass))
 		{
-			Result.Emplace(Component->GetOwner(), Component.Get());
+			Result.Emplace(Component->GetOwner(), Component);
 		}
-	}
+		return true;
+	}, GetOwnerWorld(WorldContextObject));
 
 	return Result;
 }
 
-TMap<AActor*, UFlowComponent*> UFlowSubsystem::GetFlowActorsAndComponentsByTags(const FGameplayTagContainer Tags, const EGameplayContainerMatchType MatchType, const TSubclassOf<AActor> ActorClass, const bool bExactMatch) const
+TMap<AActor*, UFlowComponent*> UFlowSubsystem::GetFlowActorsAndComponentsByTagsInWorld(const UObject* WorldContextObject, const FGameplayTagContainer Tags, const EGameplayContainerMatchType MatchType, const TSubclassOf<AActor> ActorClass, const bool bExactMatch) const
 {
-	TSet<TWeakObjectPtr<UFlowComponent>> FoundComponents;
-	FindComponents(Tags, MatchType, bExactMatch, FoundComponents);
-
 	TMap<AActor*, UFlowComponent*> Result;
-	for (const TWeakObjectPtr<UFlowComponent>& Component : FoundComponents)
+	VisitComponents(Tags, MatchType, bExactMatch, [&](UFlowComponent* Component)
 	{
-		if (Component.IsValid() && Component->GetOwner()->GetClass()->IsChildOf(ActorClass))
+		if (Component->GetOwner()->GetClass()->IsChildOf(ActorClass))
 		{
-			Result.Emplace(Component->GetOwner(), Component.Get());
+			Result.Emplace(Component->GetOwner(), Component);
 		}
-	}
+		return true;
+	}, GetOwnerWorld(WorldContextObject));
 
 	return Result;
 }
 
-void UFlowSubsystem::FindComponents(const FGameplayTag& Tag, const bool bExactMatch, TArray<TWeakObjectPtr<UFlowComponent>>& OutComponents) const
+PRAGMA_DISABLE_DEPRECATION_WARNINGS
+TSet<UFlowComponent*> UFlowSubsystem::GetFlowComponentsByTag(const FGameplayTag Tag, const TSubclassOf<UFlowComponent> ComponentClass, const bool bExactMatch) const
 {
-	if (bExactMatch)
-	{
-		FlowComponentRegistry.MultiFind(Tag, OutComponents);
-	}
-	else
+	return GetFlowComponentsByTagInWorld(GetWorld(), Tag, ComponentClass, bExactMatch);
+}
+
+TSet<UFlowComponent*> UFlowSubsystem::GetFlowComponentsByTags(const FGameplayTagContainer Tags, const EGameplayContainerMatchType MatchType, const TSubclassOf<UFlowComponent> ComponentClass, const bool bExactMatch) const
+{
+	return GetFlowComponentsByTagsInWorld(GetWorld(), Tags, MatchType, ComponentClass, bExactMatch);
+}
+
+TSet<AActor*> UFlowSubsystem::GetFlowActorsByTag(const FGameplayTag Tag, const TSubclassOf<AActor> ActorClass, const bool bExactMatch) const
+{
+	return GetFlowActorsByTagInWorld(GetWorld(), Tag, ActorClass, bExactMatch);
+}
+
+TSet<AActor*> UFlowSubsystem::GetFlowActorsByTags(const FGameplayTagContainer Tags, const EGameplayContainerMatchType MatchType, const TSubclassOf<AActor> ActorClass, const bool bExactMatch) const
+{
+	return GetFlowActorsByTagsInWorld(GetWorld(), Tags, MatchType, ActorClass, bExactMatch);
+}
+
+TMap<AActor*, UFlowComponent*> UFlowSubsystem::GetFlowActorsAndComponentsByTag(const FGameplayTag Tag, const TSubclassOf<AActor> ActorClass, const bool bExactMatch) const
+{
+	return GetFlowActorsAndComponentsByTagInWorld(GetWorld(), Tag, ActorClass, bExactMatch);
+}
+
+TMap<AActor*, UFlowComponent*> UFlowSubsystem::GetFlowActorsAndComponentsByTags(const FGameplayTagContainer Tags, const EGameplayContainerMatchType MatchType, const TSubclassOf<AActor> ActorClass, const bool bExactMatch) const
+{
+	return GetFlowActorsAndComponentsByTagsInWorld(GetWorld(), Tags, MatchType, ActorClass, bExactMatch);
+}
+PRAGMA_ENABLE_DEPRECATION_WARNINGS
+
+FFlowComponentRegistry& UFlowSubsystem::GetComponentRegistry(const UWorld* World)
+{
+	if (bShardedByWorld && World)
 	{
-		for (TMultiMap<FGameplayTag, TWeakObjectPtr<UFlowComponent>>::TConstIterator It(FlowComponentRegistry); It; ++It)
-		{
-			if (It.Key().MatchesTag(Tag))
-			{
-				OutComponents.Emplace(It.Value());
-			}
-		}
+		return WorldShards.FindOrAdd(TObjectKey<UWorld>(World)).ComponentRegistry;
 	}
+
+	return FlowComponentRegistry;
+}
+
+FFlowComponentRegistry* UFlowSubsystem::FindComponentRegistry(const UWorld* World)
+{
+	return const_cast<FFlowComponentRegistry*>(static_cast<const UFlowSubsystem*>(this)->FindComponentRegistry(World));
 }
 
-void UFlowSubsystem::FindComponents(const FGameplayTagContainer& Tags, const EGameplayContainerMatchType MatchType, const bool bExactMatch, TSet<TWeakObjectPtr<UFlowComponent>>& OutComponents) const
+const FFlowComponentRegistry* UFlowSubsystem::FindComponentRegistry(const UWorld* World) const
 {
-	if (MatchType == EGameplayContainerMatchType::Any)
+	if (bShardedByWorld && World)
 	{
-		for (const FGameplayTag& Tag : Tags)
-		{
-			TArray<TWeakObjectPtr<UFlowComponent>> ComponentsPerTag;
-			FindComponents(Tag, bExactMatch, ComponentsPerTag);
-			OutComponents.Append(ComponentsPerTag);
-		}
+		const FFlowWorldShard* WorldShard = WorldShards.Find(TObjectKey<UWorld>(World));
+		return WorldShard ? &WorldShard->ComponentRegistry : nullptr;
 	}
-	else // EGameplayContainerMatchType::All
+
+	return &FlowComponentRegistry;
+}
+
+bool UFlowSubsystem::VisitComponents(const FGameplayTag& Tag, const bool bExactMatch, TFunctionRef<bool(UFlowComponent*)> Visitor, const UWorld* World) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_FlowFindComponents);
+	CSV_CUSTOM_STAT(Flow, RegistryQueries, 1, ECsvCustomStatOp::Accumulate);
+
+	const FFlowComponentRegistry* Registry = FindComponentRegistry(World ? World : GetWorld());
+	return Registry == nullptr || Registry->ForEachComponent(Tag, bExactMatch, Visitor);
+}
+
+bool UFlowSubsystem::VisitComponents(const FGameplayTagContainer& Tags, const EGameplayContainerMatchType MatchType, const bool bExactMatch, TFunctionRef<bool(UFlowComponent*)> Visitor, const UWorld* World) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_FlowFindComponents);
+	CSV_CUSTOM_STAT(Flow, RegistryQueries, 1, ECsvCustomStatOp::Accumulate);
+
+	const FFlowComponentRegistry* Registry = FindComponentRegistry(World ? World : GetWorld());
+	return Registry == nullptr || Registry->ForEachComponent(Tags, MatchType, bExactMatch, Visitor);
+}
+
+bool UFlowSubsystem::AnyComponentWithTag(const FGameplayTag& Tag, const bool bExactMatch, const UWorld* World) const
+{
+	// visitor stops at the first component
+	return !VisitComponents(Tag, bExactMatch, [](UFlowComponent*) { return false; }, World);
+}
+
+int32 UFlowSubsystem::CountComponentsWithTag(const FGameplayTag& Tag, const bool bExactMatch, const UWorld* World) const
+{
+	int32 Count = 0;
+	VisitComponents(Tag, bExactMatch, [&Count](UFlowComponent*)
 	{
-		TSet<TWeakObjectPtr<UFlowComponent>> ComponentsWithAnyTag;
-		for (const FGameplayTag& Tag : Tags)
-		{
-			TArray<TWeakObjectPtr<UFlowComponent>> ComponentsPerTag;
-			FindComponents(Tag, bExactMatch, ComponentsPerTag);
-			ComponentsWithAnyTag.Append(ComponentsPerTag);
-		}
+		Count++;
+		return true;
+	}, World);
+	return Count;
+}
 
-		for (const TWeakObjectPtr<UFlowComponent>& Component : ComponentsWithAnyTag)
-		{
-			if (Component.IsValid() && Component->IdentityTags.HasAllExact(Tags))
-			{
-				OutComponents.Emplace(Component);
-			}
-		}
-	}
+int32 UFlowSubsystem::GetBucketSize(const FGameplayTag& Tag, const bool bExactMatch, const UWorld* World) const
+{
+	const FFlowComponentRegistry* Registry = FindComponentRegistry(World ? World : GetWorld());
+	return Registry ? Registry->GetBucketSize(Tag, bExactMatch) : 0;
 }
 
 #undef LOCTEXT_NAMESPACE
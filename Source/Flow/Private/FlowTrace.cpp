@@ -0,0 +1,139 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "FlowTrace.h"
+
+#if FLOW_TRACE_ENABLED
+
+#include "FlowAsset.h"
+#include "Nodes/FlowNode.h"
+
+#include "HAL/PlatformTime.h"
+
+UE_TRACE_CHANNEL_DEFINE(FlowChannel)
+
+UE_TRACE_EVENT_BEGIN(Flow, InstanceCreated)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint32, InstanceId)
+	UE_TRACE_EVENT_FIELD(UE::Trace::WideString, InstanceName)
+	UE_TRACE_EVENT_FIELD(UE::Trace::WideString, TemplatePath)
+	UE_TRACE_EVENT_FIELD(UE::Trace::WideString, OwnerName)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(Flow, InstanceFinished)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint32, InstanceId)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(Flow, NodeActivated)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint32, InstanceId)
+	UE_TRACE_EVENT_FIELD(uint32[], NodeGuid)
+	UE_TRACE_EVENT_FIELD(UE::Trace::WideString, NodeClass)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(Flow, NodeFinished)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint32, InstanceId)
+	UE_TRACE_EVENT_FIELD(uint32[], NodeGuid)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(Flow, PinTriggered)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint32, InstanceId)
+	UE_TRACE_EVENT_FIELD(uint32[], NodeGuid)
+	UE_TRACE_EVENT_FIELD(UE::Trace::WideString, PinName)
+	UE_TRACE_EVENT_FIELD(bool, bOutput)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(Flow, SpanBegin)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint8, Span)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(Flow, SpanEnd)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint8, Span)
+UE_TRACE_EVENT_END()
+
+namespace FlowTrace
+{
+	uint32 GetInstanceId(const UFlowNode& Node)
+	{
+		const UFlowAsset* FlowAsset = Node.GetFlowAsset();
+		return FlowAsset ? FlowAsset->GetUniqueID() : 0;
+	}
+}
+
+void FFlowTrace::OutputInstanceCreated(const UFlowAsset& Instance)
+{
+	const FString InstanceName = Instance.GetName();
+	const FString TemplatePath = Instance.GetTemplateAsset() ? Instance.GetTemplateAsset()->GetPathName() : FString();
+	const FString OwnerName = Instance.GetOwner() ? Instance.GetOwner()->GetName() : FString();
+
+	UE_TRACE_LOG(Flow, InstanceCreated, FlowChannel)
+		<< InstanceCreated.Cycle(FPlatformTime::Cycles64())
+		<< InstanceCreated.InstanceId(Instance.GetUniqueID())
+		<< InstanceCreated.InstanceName(*InstanceName, InstanceName.Len())
+		<< InstanceCreated.TemplatePath(*TemplatePath, TemplatePath.Len())
+		<< InstanceCreated.OwnerName(*OwnerName, OwnerName.Len());
+}
+
+void FFlowTrace::OutputInstanceFinished(const UFlowAsset& Instance)
+{
+	UE_TRACE_LOG(Flow, InstanceFinished, FlowChannel)
+		<< InstanceFinished.Cycle(FPlatformTime::Cycles64())
+		<< InstanceFinished.InstanceId(Instance.GetUniqueID());
+}
+
+void FFlowTrace::OutputNodeActivated(const UFlowNode& Node)
+{
+	const FGuid NodeGuid = Node.GetGuid();
+	TCHAR NodeClassBuffer[NAME_SIZE];
+	const uint32 NodeClassLength = Node.GetClass()->GetFName().ToString(NodeClassBuffer);
+
+	UE_TRACE_LOG(Flow, NodeActivated, FlowChannel)
+		<< NodeActivated.Cycle(FPlatformTime::Cycles64())
+		<< NodeActivated.InstanceId(FlowTrace::GetInstanceId(Node))
+		<< NodeActivated.NodeGuid(&NodeGuid.A, 4)
+		<< NodeActivated.NodeClass(NodeClassBuffer, NodeClassLength);
+}
+
+void FFlowTrace::OutputNodeFinished(const UFlowNode& Node)
+{
+	const FGuid NodeGuid = Node.GetGuid();
+
+	UE_TRACE_LOG(Flow, NodeFinished, FlowChannel)
+		<< NodeFinished.Cycle(FPlatformTime::Cycles64())
+		<< NodeFinished.InstanceId(FlowTrace::GetInstanceId(Node))
+		<< NodeFinished.NodeGuid(&NodeGuid.A, 4);
+}
+
+void FFlowTrace::OutputPinTriggered(const UFlowNode& Node, const FName& PinName, const bool bOutput)
+{
+	const FGuid NodeGuid = Node.GetGuid();
+	TCHAR PinNameBuffer[NAME_SIZE];
+	const uint32 PinNameLength = PinName.ToString(PinNameBuffer);
+
+	UE_TRACE_LOG(Flow, PinTriggered, FlowChannel)
+		<< PinTriggered.Cycle(FPlatformTime::Cycles64())
+		<< PinTriggered.InstanceId(FlowTrace::GetInstanceId(Node))
+		<< PinTriggered.NodeGuid(&NodeGuid.A, 4)
+		<< PinTriggered.PinName(PinNameBuffer, PinNameLength)
+		<< PinTriggered.bOutput(bOutput);
+}
+
+void FFlowTrace::OutputSpanBegin(const EFlowTraceSpan Span)
+{
+	UE_TRACE_LOG(Flow, SpanBegin, FlowChannel)
+		<< SpanBegin.Cycle(FPlatformTime::Cycles64())
+		<< SpanBegin.Span(static_cast<uint8>(Span));
+}
+
+void FFlowTrace::OutputSpanEnd(const EFlowTraceSpan Span)
+{
+	UE_TRACE_LOG(Flow, SpanEnd, FlowChannel)
+		<< SpanEnd.Cycle(FPlatformTime::Cycles64())
+		<< SpanEnd.Span(static_cast<uint8>(Span));
+}
+
+#endif
@@ -1,7 +1,15 @@
 // Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
 
 #include "FlowWorldSettings.h"
+#include "FlowAsset.h"
 #include "FlowComponent.h"
+#include "FlowSave.h"
+#include "FlowSubsystem.h"
+
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "WorldPartition/DataLayer/DataLayerAsset.h"
+#include "WorldPartition/WorldPartitionRuntimeCellInterface.h"
 
 AFlowWorldSettings::AFlowWorldSettings(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
@@ -23,6 +31,64 @@ void AFlowWorldSettings::PostInitializeComponents()
 	}
 }
 
+void AFlowWorldSettings::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// streaming flows follow the networking mode of the persistent level's Root Flow
+	if (StreamingRootFlows.Num() > 0 && StreamingStates.Num() == 0 && IsValidInstance() && GetFlowComponent()->IsFlowNetMode(GetFlowComponent()->RootFlowMode))
+	{
+		StreamingStates.SetNum(StreamingRootFlows.Num());
+		for (int32 Index = 0; Index < StreamingStates.Num(); Index++)
+		{
+			StreamingStates[Index].InstanceName = GetStreamingInstanceName(Index);
+		}
+
+		LevelAddedHandle = FWorldDelegates::LevelAddedToWorld.AddUObject(this, &AFlowWorldSettings::OnLevelAddedToWorld);
+		LevelRemovedHandle = FWorldDelegates::LevelRemovedFromWorld.AddUObject(this, &AFlowWorldSettings::OnLevelRemovedFromWorld);
+
+		// levels made visible before Begin Play
+		for (ULevel* Level : GetWorld()->GetLevels())
+		{
+			if (Level && Level->bIsVisible)
+			{
+				OnLevelAddedToWorld(Level, GetWorld());
+			}
+		}
+	}
+}
+
+void AFlowWorldSettings::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (StreamingStates.Num() > 0)
+	{
+		FWorldDelegates::LevelAddedToWorld.Remove(LevelAddedHandle);
+		FWorldDelegates::LevelRemovedFromWorld.Remove(LevelRemovedHandle);
+
+		UFlowSubsystem* FlowSubsystem = GetFlowComponent()->GetFlowSubsystem();
+		for (FStreamingRootFlowState& State : StreamingStates)
+		{
+			if (State.LoadHandle.IsValid() && State.LoadHandle->IsLoadingInProgress())
+			{
+				State.LoadHandle->CancelHandle();
+			}
+
+			if (FlowSubsystem && State.bReleased)
+			{
+				FlowSubsystem->DiscardReleasedRootFlow(State.InstanceName);
+			}
+		}
+		StreamingStates.Empty();
+
+		if (FlowSubsystem)
+		{
+			FlowSubsystem->FinishAllRootFlows(this, EFlowFinishPolicy::Keep);
+		}
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
 bool AFlowWorldSettings::IsValidInstance() const
 {
 	if (const UWorld* World = GetWorld())
@@ -37,3 +103,163 @@ bool AFlowWorldSettings::IsValidInstance() const
 
 	return false;
 }
+
+void AFlowWorldSettings::OnLevelAddedToWorld(ULevel* Level, UWorld* World)
+{
+	if (World != GetWorld() || Level == nullptr || Level->IsPersistentLevel())
+	{
+		return;
+	}
+
+	for (int32 Index = 0; Index < StreamingRootFlows.Num(); Index++)
+	{
+		if (IsLevelOfEntry(Level, StreamingRootFlows[Index]) && ++StreamingStates[Index].VisibleLevels == 1)
+		{
+			StartStreamingRootFlow(Index);
+		}
+	}
+}
+
+void AFlowWorldSettings::OnLevelRemovedFromWorld(ULevel* Level, UWorld* World)
+{
+	// null level means the whole world is being torn down, flows are finished by End Play
+	if (World != GetWorld() || Level == nullptr || Level->IsPersistentLevel())
+	{
+		return;
+	}
+
+	for (int32 Index = 0; Index < StreamingRootFlows.Num(); Index++)
+	{
+		FStreamingRootFlowState& State = StreamingStates[Index];
+		if (State.VisibleLevels > 0 && IsLevelOfEntry(Level, StreamingRootFlows[Index]) && --State.VisibleLevels == 0)
+		{
+			StopStreamingRootFlow(Index);
+		}
+	}
+}
+
+bool AFlowWorldSettings::IsLevelOfEntry(const ULevel* Level, const FFlowStreamingRootFlow& Entry) const
+{
+	if (!Entry.Level.IsNull())
+	{
+		// package of level streamed in PIE is prefixed, unlike the soft reference
+		const FString PackageName = UWorld::RemovePIEPrefix(Level->GetOutermost()->GetName());
+		if (PackageName == Entry.Level.GetLongPackageName())
+		{
+			return true;
+		}
+	}
+
+	// Data Layer assets are referenced by the world, so they're already loaded if any cell uses them
+	if (const UDataLayerAsset* DataLayerAsset = Entry.DataLayer.Get())
+	{
+		if (const IWorldPartitionCell* Cell = Level->GetWorldPartitionRuntimeCell())
+		{
+			return Cell->ContainsDataLayer(DataLayerAsset);
+		}
+	}
+
+	return false;
+}
+
+FString AFlowWorldSettings::GetStreamingInstanceName(const int32 Index) const
+{
+	// index keeps names unique if entries share the level or Data Layer
+	const FFlowStreamingRootFlow& Entry = StreamingRootFlows[Index];
+	const FString ContentName = Entry.Level.IsNull() ? Entry.DataLayer.GetAssetName() : Entry.Level.GetAssetName();
+	return FString::Printf(TEXT("%s_%s_%d"), *GetWorld()->GetName(), *ContentName, Index);
+}
+
+void AFlowWorldSettings::StartStreamingRootFlow(const int32 Index)
+{
+	const FFlowStreamingRootFlow& Entry = StreamingRootFlows[Index];
+	if (Entry.FlowAsset.IsNull())
+	{
+		return;
+	}
+
+	if (Entry.FlowAsset.IsValid())
+	{
+		OnStreamingRootFlowLoaded(Index);
+	}
+	else
+	{
+		StreamingStates[Index].LoadHandle = StreamableManager.RequestAsyncLoad(Entry.FlowAsset.ToSoftObjectPath(), FStreamableDelegate::CreateUObject(this, &AFlowWorldSettings::OnStreamingRootFlowLoaded, Index));
+	}
+}
+
+void AFlowWorldSettings::OnStreamingRootFlowLoaded(const int32 Index)
+{
+	// content might be hidden again before the asset finished loading
+	if (!StreamingStates.IsValidIndex(Index) || StreamingStates[Index].VisibleLevels == 0)
+	{
+		return;
+	}
+
+	UFlowAsset* FlowAsset = StreamingRootFlows[Index].FlowAsset.Get();
+	UFlowSubsystem* FlowSubsystem = GetFlowComponent()->GetFlowSubsystem();
+	if (FlowAsset == nullptr || FlowSubsystem == nullptr)
+	{
+		return;
+	}
+
+	FStreamingRootFlowState& State = StreamingStates[Index];
+	UFlowAsset* Instance = nullptr;
+
+	if (State.bReleased)
+	{
+		Instance = FlowSubsystem->RestoreRootFlow(this, FlowAsset, State.InstanceName);
+		State.bReleased = false;
+	}
+	else if (UFlowSaveGame* SaveGame = FlowSubsystem->GetLoadedSaveGame(); SaveGame && SaveGame != State.LoadedSaveGame.Get())
+	{
+		// Flow might have been running or released while the game was saved
+		Instance = FlowSubsystem->LoadOwnedRootFlow(this, FlowAsset, State.InstanceName);
+		State.LoadedSaveGame = SaveGame;
+	}
+
+	if (Instance == nullptr)
+	{
+		Instance = FlowSubsystem->StartOwnedRootFlow(this, FlowAsset, State.InstanceName);
+	}
+
+	State.Instance = Instance;
+}
+
+void AFlowWorldSettings::StopStreamingRootFlow(const int32 Index)
+{
+	FStreamingRootFlowState& State = StreamingStates[Index];
+
+	// keeping the handle until now keeps the asset loaded while the content is visible
+	if (State.LoadHandle.IsValid())
+	{
+		if (State.LoadHandle->IsLoadingInProgress())
+		{
+			State.LoadHandle->CancelHandle();
+		}
+		else
+		{
+			State.LoadHandle->ReleaseHandle();
+		}
+		State.LoadHandle.Reset();
+	}
+
+	UFlowAsset* Instance = State.Instance.Get();
+	UFlowSubsystem* FlowSubsystem = GetFlowComponent()->GetFlowSubsystem();
+	State.Instance.Reset();
+	if (Instance == nullptr || FlowSubsystem == nullptr)
+	{
+		return;
+	}
+
+	switch (StreamingRootFlows[Index].StreamOutPolicy)
+	{
+		case EFlowStreamOutPolicy::SaveAndRelease:
+			State.bReleased = !FlowSubsystem->ReleaseRootFlow(Instance).IsEmpty();
+			break;
+		case EFlowStreamOutPolicy::Abort:
+			FlowSubsystem->FinishRootInstance(Instance, EFlowFinishPolicy::Abort);
+			break;
+		default: ;
+	}
+}
@@ -2,6 +2,7 @@
 
 #include "MovieScene/MovieSceneFlowTemplate.h"
 #include "MovieScene/MovieSceneFlowTrack.h"
+#include "FlowStats.h"
 #include "Nodes/World/FlowNode_PlayLevelSequence.h"
 
 #include "Evaluation/MovieSceneEvaluation.h"
@@ -23,6 +24,7 @@ struct FFlowTrackExecutionToken final : IMovieSceneExecutionToken
 	virtual void Execute(const FMovieSceneContext& Context, const FMovieSceneEvaluationOperand& Operand, FPersistentEvaluationData& PersistentData, IMovieScenePlayer& Player) override
 	{
 		MOVIESCENE_DETAILED_SCOPE_CYCLE_COUNTER(MovieSceneEval_FlowTrack_TokenExecute)
+		SCOPE_CYCLE_COUNTER(STAT_FlowMovieSceneTrack);
 
 		for (const FString& EventName : EventNames)
 		{
@@ -56,6 +58,8 @@ FMovieSceneFlowTriggerTemplate::FMovieSceneFlowTriggerTemplate(const UMovieScene
 
 void FMovieSceneFlowTriggerTemplate::EvaluateSwept(const FMovieSceneEvaluationOperand& Operand, const FMovieSceneContext& Context, const TRange<FFrameNumber>& SweptRange, const FPersistentEvaluationData& PersistentData, FMovieSceneExecutionTokens& ExecutionTokens) const
 {
+	SCOPE_CYCLE_COUNTER(STAT_FlowMovieSceneTrack);
+
 	// Don't allow events to fire when playback is in a stopped state. This can occur when stopping 
 	// playback and returning the current position to the start of playback. It's not desirable to have 
 	// all the events from the last playback position to the start of playback be fired.
@@ -112,6 +116,8 @@ FMovieSceneFlowRepeaterTemplate::FMovieSceneFlowRepeaterTemplate(const UMovieSce
 
 void FMovieSceneFlowRepeaterTemplate::EvaluateSwept(const FMovieSceneEvaluationOperand& Operand, const FMovieSceneContext& Context, const TRange<FFrameNumber>& SweptRange, const FPersistentEvaluationData& PersistentData, FMovieSceneExecutionTokens& ExecutionTokens) const
 {
+	SCOPE_CYCLE_COUNTER(STAT_FlowMovieSceneTrack);
+
 	const bool bBackwards = Context.GetDirection() == EPlayDirection::Backwards;
 	const FFrameNumber CurrentFrame = bBackwards ? Context.GetTime().CeilToFrame() : Context.GetTime().FloorToFrame();
 
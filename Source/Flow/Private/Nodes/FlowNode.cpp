@@ -4,9 +4,12 @@
 
 #include "FlowAsset.h"
 #include "FlowModule.h"
+#include "FlowNativeGraph.h"
 #include "FlowOwnerInterface.h"
 #include "FlowSettings.h"
+#include "FlowStats.h"
 #include "FlowSubsystem.h"
+#include "FlowTrace.h"
 #include "FlowTypes.h"
 
 #include "Components/ActorComponent.h"
@@ -38,10 +41,13 @@ UFlowNode::UFlowNode(const FObjectInitializer& ObjectInitializer)
 	, bCanDuplicate(true)
 	, bNodeDeprecated(false)
 #endif
+	, CookedGraphIndex(INDEX_NONE)
 	, AllowedSignalModes({EFlowSignalMode::Enabled, EFlowSignalMode::Disabled, EFlowSignalMode::PassThrough})
 	, SignalMode(EFlowSignalMode::Enabled)
 	, bPreloaded(false)
 	, ActivationState(EFlowNodeState::NeverActivated)
+	, CachedFlowOwnerInterface(nullptr)
+	, ImplementedK2Events(EFlowNodeK2Events::None)
 {
 #if WITH_EDITOR
 	Category = TEXT("Uncategorized");
@@ -196,24 +202,35 @@ IFlowOwnerInterface* UFlowNode::GetFlowOwnerInterface() const
 		return nullptr;
 	}
 
-	const UClass* ExpectedOwnerClass = FlowAsset->GetExpectedOwnerClass();
-	if (!IsValid(ExpectedOwnerClass))
+	UObject* RootFlowOwner = FlowAsset->GetOwner();
+	if (!IsValid(RootFlowOwner))
 	{
 		return nullptr;
 	}
 
-	UObject* RootFlowOwner = FlowAsset->GetOwner();
-	if (!IsValid(RootFlowOwner))
+	if (CachedFlowOwner.Get() != RootFlowOwner)
+	{
+		CachedFlowOwnerInterface = FindFlowOwnerInterface(*FlowAsset, *RootFlowOwner);
+		CachedFlowOwner = RootFlowOwner;
+	}
+
+	return CachedFlowOwnerInterface;
+}
+
+IFlowOwnerInterface* UFlowNode::FindFlowOwnerInterface(const UFlowAsset& FlowAsset, UObject& RootFlowOwner) const
+{
+	const UClass* ExpectedOwnerClass = FlowAsset.GetExpectedOwnerClass();
+	if (!IsValid(ExpectedOwnerClass))
 	{
 		return nullptr;
 	}
 
-	if (IFlowOwnerInterface* FlowOwnerInterface = TryGetFlowOwnerInterfaceFromRootFlowOwner(*RootFlowOwner, *ExpectedOwnerClass))
+	if (IFlowOwnerInterface* FlowOwnerInterface = TryGetFlowOwnerInterfaceFromRootFlowOwner(RootFlowOwner, *ExpectedOwnerClass))
 	{
 		return FlowOwnerInterface;
 	}
 
-	if (IFlowOwnerInterface* FlowOwnerInterface = TryGetFlowOwnerInterfaceActor(*RootFlowOwner, *ExpectedOwnerClass))
+	if (IFlowOwnerInterface* FlowOwnerInterface = TryGetFlowOwnerInterfaceActor(RootFlowOwner, *ExpectedOwnerClass))
 	{
 		return FlowOwnerInterface;
 	}
@@ -468,24 +485,109 @@ bool UFlowNode::IsOutputConnected(const FName& PinName) const
 	return OutputPins.Contains(PinName) && Connections.Contains(PinName);
 }
 
+void UFlowNode::CacheContext()
+{
+	CachedFlowSubsystem = GetFlowAsset() ? GetFlowAsset()->GetFlowSubsystem() : nullptr;
+	CachedWorld = GetFlowAsset() ? GetFlowAsset()->GetWorld() : nullptr;
+	CachedFlowOwner.Reset();
+	CachedFlowOwnerInterface = nullptr;
+}
+
 UFlowSubsystem* UFlowNode::GetFlowSubsystem() const
 {
+	if (UFlowSubsystem* FlowSubsystem = CachedFlowSubsystem.Get())
+	{
+		return FlowSubsystem;
+	}
+
 	return GetFlowAsset() ? GetFlowAsset()->GetFlowSubsystem() : nullptr;
 }
 
 UWorld* UFlowNode::GetWorld() const
 {
-	if (GetFlowAsset() && GetFlowAsset()->GetFlowSubsystem())
+	UWorld* World = CachedWorld.Get();
+	if (World && !World->bIsTearingDown)
 	{
-		return GetFlowAsset()->GetFlowSubsystem()->GetWorld();
+		return World;
+	}
+
+	if (GetFlowSubsystem())
+	{
+		// instance lives in the world of its owner
+		World = GetFlowAsset()->GetWorld();
+		if (CachedFlowSubsystem.IsValid())
+		{
+			CachedWorld = World;
+		}
+		return World;
 	}
 
 	return nullptr;
 }
 
+FTimerManager* UFlowNode::GetFlowTimerManager() const
+{
+	if (const UFlowSubsystem* FlowSubsystem = GetFlowSubsystem(); FlowSubsystem && FlowSubsystem->IsVirtualTimeEnabled())
+	{
+		return FlowSubsystem->GetTimerManager();
+	}
+
+	// Game Instance world might differ from the world of this node
+	return GetWorld() ? &GetWorld()->GetTimerManager() : nullptr;
+}
+
+void UFlowNode::RecordEvent(const EFlowRecordedEventType Type, const FName& Name) const
+{
+	UFlowSubsystem* FlowSubsystem = GetFlowSubsystem();
+	if (FlowSubsystem && FlowSubsystem->IsRecording())
+	{
+		FFlowRecordedEvent Event;
+		Event.Type = Type;
+		Event.Asset = GetFlowAsset()->GetTemplateAsset();
+		Event.NodeGuid = NodeGuid;
+		Event.Name = Name;
+		FlowSubsystem->RecordEvent(MoveTemp(Event), GetFlowAsset()->GetOwner());
+	}
+}
+
+void UFlowNode::GetResourceSizeEx(FResourceSizeEx& CumulativeResourceSize)
+{
+	Super::GetResourceSizeEx(CumulativeResourceSize);
+
+	CumulativeResourceSize.AddDedicatedSystemMemoryBytes(InputPins.GetAllocatedSize() + OutputPins.GetAllocatedSize() + Connections.GetAllocatedSize());
+
+#if WITH_EDITORONLY_DATA
+	for (const TArray<FFlowPin>* Pins : {&InputPins, &OutputPins})
+	{
+		for (const FFlowPin& Pin : *Pins)
+		{
+			CumulativeResourceSize.AddDedicatedSystemMemoryBytes(Pin.PinToolTip.GetAllocatedSize());
+		}
+	}
+#endif
+
+#if !UE_BUILD_SHIPPING
+	for (const TMap<FName, TArray<FPinRecord>>* Records : {&InputRecords, &OutputRecords})
+	{
+		CumulativeResourceSize.AddDedicatedSystemMemoryBytes(Records->GetAllocatedSize());
+		for (const TPair<FName, TArray<FPinRecord>>& PinRecords : *Records)
+		{
+			CumulativeResourceSize.AddDedicatedSystemMemoryBytes(PinRecords.Value.GetAllocatedSize());
+			for (const FPinRecord& Record : PinRecords.Value)
+			{
+				CumulativeResourceSize.AddDedicatedSystemMemoryBytes(Record.HumanReadableTime.GetAllocatedSize());
+			}
+		}
+	}
+#endif
+}
+
 void UFlowNode::InitializeInstance()
 {
-	K2_InitializeInstance();
+	if (IsK2EventImplemented(EFlowNodeK2Events::InitializeInstance))
+	{
+		K2_InitializeInstance();
+	}
 }
 
 void UFlowNode::TriggerPreload()
@@ -502,17 +604,26 @@ void UFlowNode::TriggerFlush()
 
 void UFlowNode::PreloadContent()
 {
-	K2_PreloadContent();
+	if (IsK2EventImplemented(EFlowNodeK2Events::PreloadContent))
+	{
+		K2_PreloadContent();
+	}
 }
 
 void UFlowNode::FlushContent()
 {
-	K2_FlushContent();
+	if (IsK2EventImplemented(EFlowNodeK2Events::FlushContent))
+	{
+		K2_FlushContent();
+	}
 }
 
 void UFlowNode::OnActivate()
 {
-	K2_OnActivate();
+	if (IsK2EventImplemented(EFlowNodeK2Events::OnActivate))
+	{
+		K2_OnActivate();
+	}
 }
 
 void UFlowNode::TriggerInput(const FName& PinName, const EFlowPinActivationType ActivationType /*= Default*/)
@@ -522,29 +633,40 @@ void UFlowNode::TriggerInput(const FName& PinName, const EFlowPinActivationType
 		// entirely ignore any Input activation
 	}
 
-	if (InputPins.Contains(PinName))
+	const int32 PinIndex = InputPins.IndexOfByKey(PinName);
+	if (PinIndex != INDEX_NONE)
 	{
 		if (SignalMode == EFlowSignalMode::Enabled)
 		{
 			const EFlowNodeState PreviousActivationState = ActivationState;
 			if (PreviousActivationState != EFlowNodeState::Active)
 			{
+				TRACE_FLOW_NODE_ACTIVATED(*this);
+				CSV_CUSTOM_STAT(Flow, NodesActivated, 1, ECsvCustomStatOp::Accumulate);
+#if !UE_BUILD_SHIPPING
+				ExecutionStats.OnActivated();
+#endif
 				OnActivate();
 			}
 
 			ActivationState = EFlowNodeState::Active;
 		}
 
+		TRACE_FLOW_PIN_TRIGGERED(*this, PinName, false);
+
 #if !UE_BUILD_SHIPPING
-		// record for debugging
-		TArray<FPinRecord>& Records = InputRecords.FindOrAdd(PinName);
-		Records.Add(FPinRecord(FApp::GetCurrentTime(), ActivationType));
+		// record for debugging, shared instances are executed for the whole game and would grow records without bound
+		if (ShouldRecordPins())
+		{
+			TArray<FPinRecord>& Records = InputRecords.FindOrAdd(PinName);
+			Records.Add(FPinRecord(FApp::GetCurrentTime(), ActivationType));
+		}
 #endif // UE_BUILD_SHIPPING
 
 #if WITH_EDITOR
-		if (GEditor && UFlowAsset::GetFlowGraphInterface().IsValid())
+		if (GEditor && GraphNode && UFlowAsset::GetFlowGraphInterface().IsValid())
 		{
-			UFlowAsset::GetFlowGraphInterface()->OnInputTriggered(GraphNode, InputPins.IndexOfByKey(PinName));
+			UFlowAsset::GetFlowGraphInterface()->OnInputTriggered(GraphNode, PinIndex);
 		}
 #endif // WITH_EDITOR
 	}
@@ -559,8 +681,18 @@ void UFlowNode::TriggerInput(const FName& PinName, const EFlowPinActivationType
 	switch (SignalMode)
 	{
 		case EFlowSignalMode::Enabled:
+		{
+			// nodes overriding ExecuteInput don't call the base implementation, so it's measured here
+			SCOPE_CYCLE_COUNTER(STAT_FlowExecuteInput);
+#if !UE_BUILD_SHIPPING
+			const double ExecuteStartTime = FPlatformTime::Seconds();
+			ExecuteInput(PinName);
+			ExecutionStats.OnExecuted(FPlatformTime::Seconds() - ExecuteStartTime);
+#else
 			ExecuteInput(PinName);
+#endif
 			break;
+		}
 		case EFlowSignalMode::Disabled:
 			if (UFlowSettings::Get()->bLogOnSignalDisabled)
 			{
@@ -580,7 +712,10 @@ void UFlowNode::TriggerInput(const FName& PinName, const EFlowPinActivationType
 
 void UFlowNode::ExecuteInput(const FName& PinName)
 {
-	K2_ExecuteInput(PinName);
+	if (IsK2EventImplemented(EFlowNodeK2Events::ExecuteInput))
+	{
+		K2_ExecuteInput(PinName);
+	}
 }
 
 void UFlowNode::TriggerFirstOutput(const bool bFinish)
@@ -592,6 +727,16 @@ void UFlowNode::TriggerFirstOutput(const bool bFinish)
 }
 
 void UFlowNode::TriggerOutput(const FName& PinName, const bool bFinish /*= false*/, const EFlowPinActivationType ActivationType /*= Default*/)
+{
+	TriggerOutputByIndex(OutputPins.IndexOfByKey(PinName), PinName, bFinish, ActivationType);
+}
+
+void UFlowNode::TriggerOutput(const FFlowNativePin& Pin, const bool bFinish /*= false*/, const EFlowPinActivationType ActivationType /*= Default*/)
+{
+	TriggerOutputByIndex(Pin.FindIndex(OutputPins), Pin.PinName, bFinish, ActivationType);
+}
+
+void UFlowNode::TriggerOutputByIndex(const int32 PinIndex, const FName& PinName, const bool bFinish, const EFlowPinActivationType ActivationType)
 {
 	// clean up node, if needed
 	if (bFinish)
@@ -600,16 +745,19 @@ void UFlowNode::TriggerOutput(const FName& PinName, const bool bFinish /*= false
 	}
 
 #if !UE_BUILD_SHIPPING
-	if (OutputPins.Contains(PinName))
+	if (PinIndex != INDEX_NONE)
 	{
 		// record for debugging, even if nothing is connected to this pin
-		TArray<FPinRecord>& Records = OutputRecords.FindOrAdd(PinName);
-		Records.Add(FPinRecord(FApp::GetCurrentTime(), ActivationType));
+		if (ShouldRecordPins())
+		{
+			TArray<FPinRecord>& Records = OutputRecords.FindOrAdd(PinName);
+			Records.Add(FPinRecord(FApp::GetCurrentTime(), ActivationType));
+		}
 
 #if WITH_EDITOR
-		if (GEditor && UFlowAsset::GetFlowGraphInterface().IsValid())
+		if (GEditor && GraphNode && UFlowAsset::GetFlowGraphInterface().IsValid())
 		{
-			UFlowAsset::GetFlowGraphInterface()->OnOutputTriggered(GraphNode, OutputPins.IndexOfByKey(PinName));
+			UFlowAsset::GetFlowGraphInterface()->OnOutputTriggered(GraphNode, PinIndex);
 		}
 #endif // WITH_EDITOR
 	}
@@ -620,10 +768,19 @@ void UFlowNode::TriggerOutput(const FName& PinName, const bool bFinish /*= false
 #endif // UE_BUILD_SHIPPING
 
 	// call the next node
-	if (OutputPins.Contains(PinName) && Connections.Contains(PinName))
+	if (PinIndex != INDEX_NONE)
 	{
-		const FConnectedPin FlowPin = GetConnection(PinName);
-		GetFlowAsset()->TriggerInput(FlowPin.NodeGuid, FlowPin.PinName);
+		TRACE_FLOW_PIN_TRIGGERED(*this, PinName, true);
+
+		UFlowAsset* FlowAsset = GetFlowAsset();
+		if (FlowAsset->GetNativeGraph() && CookedGraphIndex != INDEX_NONE)
+		{
+			FlowAsset->GetNativeGraph()->TriggerOutput(*FlowAsset, CookedGraphIndex, PinName);
+		}
+		else if (const FConnectedPin* FlowPin = Connections.Find(PinName))
+		{
+			FlowAsset->TriggerInput(FlowPin->NodeGuid, FlowPin->PinName);
+		}
 	}
 }
 
@@ -649,6 +806,8 @@ void UFlowNode::TriggerOutput(const TCHAR* PinName, const bool bFinish)
 
 void UFlowNode::Finish()
 {
+	TRACE_FLOW_NODE_FINISHED(*this);
+
 	Deactivate();
 	GetFlowAsset()->FinishNode(this);
 }
@@ -664,23 +823,80 @@ void UFlowNode::Deactivate()
 		ActivationState = EFlowNodeState::Completed;
 	}
 
+#if !UE_BUILD_SHIPPING
+	ExecutionStats.OnDeactivated();
+#endif
+
 	Cleanup();
 }
 
 void UFlowNode::Cleanup()
 {
-	K2_Cleanup();
+	if (IsK2EventImplemented(EFlowNodeK2Events::Cleanup))
+	{
+		K2_Cleanup();
+	}
 }
 
 void UFlowNode::DeinitializeInstance()
 {
-	K2_DeinitializeInstance();
+	if (IsK2EventImplemented(EFlowNodeK2Events::DeinitializeInstance))
+	{
+		K2_DeinitializeInstance();
+	}
 }
 
 void UFlowNode::ForceFinishNode()
 {
-	K2_ForceFinishNode();
+	if (IsK2EventImplemented(EFlowNodeK2Events::ForceFinishNode))
+	{
+		K2_ForceFinishNode();
+	}
+}
+
+bool UFlowNode::IsK2EventImplemented(const EFlowNodeK2Events Event) const
+{
+	if (!EnumHasAnyFlags(ImplementedK2Events, EFlowNodeK2Events::Resolved))
+	{
+		const UFlowNode* DefaultNode = GetClass()->GetDefaultObject<UFlowNode>();
+		if (!EnumHasAnyFlags(DefaultNode->ImplementedK2Events, EFlowNodeK2Events::Resolved))
+		{
+			// class default object is re-created after compiling the blueprint, so flags never go stale
+			const UClass* Class = GetClass();
+			EFlowNodeK2Events Events = EFlowNodeK2Events::Resolved;
+			const auto ResolveEvent = [Class, &Events](const FName& FunctionName, const EFlowNodeK2Events FunctionEvent)
+			{
+				if (Class->IsFunctionImplementedInScript(FunctionName))
+				{
+					Events |= FunctionEvent;
+				}
+			};
+
+			ResolveEvent(GET_FUNCTION_NAME_CHECKED(UFlowNode, K2_InitializeInstance), EFlowNodeK2Events::InitializeInstance);
+			ResolveEvent(GET_FUNCTION_NAME_CHECKED(UFlowNode, K2_DeinitializeInstance), EFlowNodeK2Events::DeinitializeInstance);
+			ResolveEvent(GET_FUNCTION_NAME_CHECKED(UFlowNode, K2_PreloadContent), EFlowNodeK2Events::PreloadContent);
+			ResolveEvent(GET_FUNCTION_NAME_CHECKED(UFlowNode, K2_FlushContent), EFlowNodeK2Events::FlushContent);
+			ResolveEvent(GET_FUNCTION_NAME_CHECKED(UFlowNode, K2_OnActivate), EFlowNodeK2Events::OnActivate);
+			ResolveEvent(GET_FUNCTION_NAME_CHECKED(UFlowNode, K2_ExecuteInput), EFlowNodeK2Events::ExecuteInput);
+			ResolveEvent(GET_FUNCTION_NAME_CHECKED(UFlowNode, K2_Cleanup), EFlowNodeK2Events::Cleanup);
+			ResolveEvent(GET_FUNCTION_NAME_CHECKED(UFlowNode, K2_ForceFinishNode), EFlowNodeK2Events::ForceFinishNode);
+
+			DefaultNode->ImplementedK2Events = Events;
+		}
+
+		ImplementedK2Events = DefaultNode->ImplementedK2Events;
+	}
+
+	return EnumHasAnyFlags(ImplementedK2Events, Event);
+}
+
+#if !UE_BUILD_SHIPPING
+bool UFlowNode::ShouldRecordPins() const
+{
+	const UFlowAsset* FlowAsset = GetFlowAsset();
+	return FlowAsset == nullptr || !FlowAsset->IsSharedInstance();
 }
+#endif
 
 void UFlowNode::ResetRecords()
 {
@@ -689,6 +905,7 @@ void UFlowNode::ResetRecords()
 #if !UE_BUILD_SHIPPING
 	InputRecords.Empty();
 	OutputRecords.Empty();
+	ExecutionStats = FFlowNodeExecutionStats();
 #endif
 }
 
@@ -33,6 +33,45 @@ FORCEINLINE FString FPinRecord::DoubleDigit(const int32 Number)
 {
 	return Number > 9 ? FString::FromInt(Number) : TEXT("0") + FString::FromInt(Number);
 }
+
+//////////////////////////////////////////////////////////////////////////
+// Node Execution Stats
+
+void FFlowNodeExecutionStats::OnActivated()
+{
+	Activations++;
+	ActivationStartTime = FPlatformTime::Seconds();
+}
+
+void FFlowNodeExecutionStats::OnExecuted(const double Seconds)
+{
+	Executions++;
+	ExecuteTime += Seconds;
+	MaxExecuteTime = FMath::Max(MaxExecuteTime, Seconds);
+}
+
+void FFlowNodeExecutionStats::OnDeactivated()
+{
+	if (ActivationStartTime >= 0.0)
+	{
+		ActiveTime += FPlatformTime::Seconds() - ActivationStartTime;
+		ActivationStartTime = -1.0;
+	}
+}
+
+double FFlowNodeExecutionStats::GetActiveTime() const
+{
+	return ActivationStartTime >= 0.0 ? ActiveTime + FPlatformTime::Seconds() - ActivationStartTime : ActiveTime;
+}
+
+void FFlowNodeExecutionStats::Append(const FFlowNodeExecutionStats& Other)
+{
+	Activations += Other.Activations;
+	Executions += Other.Executions;
+	ExecuteTime += Other.ExecuteTime;
+	MaxExecuteTime = FMath::Max(MaxExecuteTime, Other.MaxExecuteTime);
+	ActiveTime += Other.GetActiveTime();
+}
 #endif
 
 //////////////////////////////////////////////////////////////////////////
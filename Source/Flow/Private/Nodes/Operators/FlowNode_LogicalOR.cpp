@@ -2,6 +2,9 @@
 
 #include "Nodes/Operators/FlowNode_LogicalOR.h"
 
+const FFlowNativePin UFlowNode_LogicalOR::EnablePin(TEXT("Enable"));
+const FFlowNativePin UFlowNode_LogicalOR::DisablePin(TEXT("Disable"));
+
 UFlowNode_LogicalOR::UFlowNode_LogicalOR(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 	, bEnabled(true)
@@ -14,13 +17,13 @@ UFlowNode_LogicalOR::UFlowNode_LogicalOR(const FObjectInitializer& ObjectInitial
 #endif
 
 	SetNumberedInputPins(0, 1);
-	InputPins.Add(FFlowPin(TEXT("Enable"), TEXT("Enabling resets Execution Count")));
-	InputPins.Add(FFlowPin(TEXT("Disable"), TEXT("Disabling resets Execution Count")));
+	InputPins.Add(EnablePin.ToPin(TEXT("Enabling resets Execution Count")));
+	InputPins.Add(DisablePin.ToPin(TEXT("Disabling resets Execution Count")));
 }
 
 void UFlowNode_LogicalOR::ExecuteInput(const FName& PinName)
 {
-	if (PinName == TEXT("Enable"))
+	if (PinName == EnablePin)
 	{
 		if (!bEnabled)
 		{
@@ -30,7 +33,7 @@ void UFlowNode_LogicalOR::ExecuteInput(const FName& PinName)
 		return;
 	}
 
-	if (PinName == TEXT("Disable"))
+	if (PinName == DisablePin)
 	{
 		if (bEnabled)
 		{
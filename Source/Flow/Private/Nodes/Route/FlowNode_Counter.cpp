@@ -2,6 +2,14 @@
 
 #include "Nodes/Route/FlowNode_Counter.h"
 
+const FFlowNativePin UFlowNode_Counter::IncrementPin(TEXT("Increment"));
+const FFlowNativePin UFlowNode_Counter::DecrementPin(TEXT("Decrement"));
+const FFlowNativePin UFlowNode_Counter::SkipPin(TEXT("Skip"));
+const FFlowNativePin UFlowNode_Counter::ZeroPin(TEXT("Zero"));
+const FFlowNativePin UFlowNode_Counter::StepPin(TEXT("Step"));
+const FFlowNativePin UFlowNode_Counter::GoalPin(TEXT("Goal"));
+const FFlowNativePin UFlowNode_Counter::SkippedPin(TEXT("Skipped"));
+
 UFlowNode_Counter::UFlowNode_Counter(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 	, Goal(2)
@@ -13,50 +21,50 @@ UFlowNode_Counter::UFlowNode_Counter(const FObjectInitializer& ObjectInitializer
 #endif
 
 	InputPins.Empty();
-	InputPins.Add(FFlowPin(TEXT("Increment")));
-	InputPins.Add(FFlowPin(TEXT("Decrement")));
-	InputPins.Add(FFlowPin(TEXT("Skip")));
+	InputPins.Add(IncrementPin);
+	InputPins.Add(DecrementPin);
+	InputPins.Add(SkipPin);
 
 	OutputPins.Empty();
-	OutputPins.Add(FFlowPin(TEXT("Zero")));
-	OutputPins.Add(FFlowPin(TEXT("Step")));
-	OutputPins.Add(FFlowPin(TEXT("Goal")));
-	OutputPins.Add(FFlowPin(TEXT("Skipped")));
+	OutputPins.Add(ZeroPin);
+	OutputPins.Add(StepPin);
+	OutputPins.Add(GoalPin);
+	OutputPins.Add(SkippedPin);
 }
 
 void UFlowNode_Counter::ExecuteInput(const FName& PinName)
 {
-	if (PinName == TEXT("Increment"))
+	if (PinName == IncrementPin)
 	{
 		CurrentSum++;
 		if (CurrentSum == Goal)
 		{
-			TriggerOutput(TEXT("Goal"), true);
+			TriggerOutput(GoalPin, true);
 		}
 		else
 		{
-			TriggerOutput(TEXT("Step"));
+			TriggerOutput(StepPin);
 		}
 		return;
 	}
 
-	if (PinName == TEXT("Decrement"))
+	if (PinName == DecrementPin)
 	{
 		CurrentSum--;
 		if (CurrentSum == 0)
 		{
-			TriggerOutput(TEXT("Zero"), true);
+			TriggerOutput(ZeroPin, true);
 		}
 		else
 		{
-			TriggerOutput(TEXT("Step"));
+			TriggerOutput(StepPin);
 		}
 		return;
 	}
 
-	if (PinName == TEXT("Skip"))
+	if (PinName == SkipPin)
 	{
-		TriggerOutput(TEXT("Skipped"), true);
+		TriggerOutput(SkippedPin, true);
 	}
 }
 
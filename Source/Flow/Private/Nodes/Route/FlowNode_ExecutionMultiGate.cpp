@@ -1,6 +1,9 @@
 // Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
 
 #include "Nodes/Route/FlowNode_ExecutionMultiGate.h"
+#include "FlowAsset.h"
+
+const FFlowNativePin UFlowNode_ExecutionMultiGate::ResetPin(TEXT("Reset"));
 
 UFlowNode_ExecutionMultiGate::UFlowNode_ExecutionMultiGate(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
@@ -15,7 +18,7 @@ UFlowNode_ExecutionMultiGate::UFlowNode_ExecutionMultiGate(const FObjectInitiali
 	ResetPinTooltip += LINE_TERMINATOR;
 	ResetPinTooltip += TEXT("Calling In input will start triggering output pins once again.");
 
-	InputPins.Add(FFlowPin(TEXT("Reset"), ResetPinTooltip));
+	InputPins.Add(ResetPin.ToPin(ResetPinTooltip));
 	SetNumberedOutputPins(0, 1);
 	AllowedSignalModes = {EFlowSignalMode::Enabled, EFlowSignalMode::Disabled};
 }
@@ -56,7 +59,7 @@ void UFlowNode_ExecutionMultiGate::ExecuteInput(const FName& PinName)
 					}
 				}
 
-				const int32 Random = FMath::RandRange(0, AvailableIndexes.Num() - 1);
+				const int32 Random = GetFlowAsset()->GetRandomStream().RandRange(0, AvailableIndexes.Num() - 1);
 				Index = AvailableIndexes[Random];
 			}
 
@@ -84,7 +87,7 @@ void UFlowNode_ExecutionMultiGate::ExecuteInput(const FName& PinName)
 			Finish();
 		}
 	}
-	else if (PinName == TEXT("Reset"))
+	else if (PinName == ResetPin)
 	{
 		Finish();
 	}
@@ -6,8 +6,8 @@
 #include "FlowMessageLog.h"
 #include "FlowSubsystem.h"
 
-FFlowPin UFlowNode_SubGraph::StartPin(TEXT("Start"));
-FFlowPin UFlowNode_SubGraph::FinishPin(TEXT("Finish"));
+const FFlowNativePin UFlowNode_SubGraph::StartPin(TEXT("Start"));
+const FFlowNativePin UFlowNode_SubGraph::FinishPin(TEXT("Finish"));
 
 UFlowNode_SubGraph::UFlowNode_SubGraph(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
@@ -62,7 +62,7 @@ void UFlowNode_SubGraph::ExecuteInput(const FName& PinName)
 		return;
 	}
 	
-	if (PinName == TEXT("Start"))
+	if (PinName == StartPin)
 	{
 		if (GetFlowSubsystem())
 		{
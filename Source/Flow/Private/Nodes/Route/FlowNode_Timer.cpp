@@ -1,10 +1,17 @@
 // Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
 
 #include "Nodes/Route/FlowNode_Timer.h"
+#include "FlowRecording.h"
 
 #include "Engine/World.h"
 #include "TimerManager.h"
 
+const FFlowNativePin UFlowNode_Timer::SkipPin(TEXT("Skip"));
+const FFlowNativePin UFlowNode_Timer::RestartPin(TEXT("Restart"));
+const FFlowNativePin UFlowNode_Timer::CompletedPin(TEXT("Completed"));
+const FFlowNativePin UFlowNode_Timer::StepPin(TEXT("Step"));
+const FFlowNativePin UFlowNode_Timer::SkippedPin(TEXT("Skipped"));
+
 UFlowNode_Timer::UFlowNode_Timer(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 	, CompletionTime(1.0f)
@@ -18,18 +25,18 @@ UFlowNode_Timer::UFlowNode_Timer(const FObjectInitializer& ObjectInitializer)
 	NodeStyle = EFlowNodeStyle::Latent;
 #endif
 
-	InputPins.Add(FFlowPin(TEXT("Skip")));
-	InputPins.Add(FFlowPin(TEXT("Restart")));
+	InputPins.Add(SkipPin);
+	InputPins.Add(RestartPin);
 
 	OutputPins.Empty();
-	OutputPins.Add(FFlowPin(TEXT("Completed")));
-	OutputPins.Add(FFlowPin(TEXT("Step")));
-	OutputPins.Add(FFlowPin(TEXT("Skipped")));
+	OutputPins.Add(CompletedPin);
+	OutputPins.Add(StepPin);
+	OutputPins.Add(SkippedPin);
 }
 
 void UFlowNode_Timer::ExecuteInput(const FName& PinName)
 {
-	if (PinName == TEXT("In"))
+	if (PinName == DefaultInputPin.PinName)
 	{
 		if (CompletionTimerHandle.IsValid() || StepTimerHandle.IsValid())
 		{
@@ -39,11 +46,11 @@ void UFlowNode_Timer::ExecuteInput(const FName& PinName)
 
 		SetTimer();
 	}
-	else if (PinName == TEXT("Skip"))
+	else if (PinName == SkipPin)
 	{
-		TriggerOutput(TEXT("Skipped"), true);
+		TriggerOutput(SkippedPin, true);
 	}
-	else if (PinName == TEXT("Restart"))
+	else if (PinName == RestartPin)
 	{
 		Restart();
 	}
@@ -51,26 +58,26 @@ void UFlowNode_Timer::ExecuteInput(const FName& PinName)
 
 void UFlowNode_Timer::SetTimer()
 {
-	if (GetWorld())
+	if (FTimerManager* TimerManager = GetFlowTimerManager())
 	{
 		if (StepTime > 0.0f)
 		{
-			GetWorld()->GetTimerManager().SetTimer(StepTimerHandle, this, &UFlowNode_Timer::OnStep, StepTime, true);
+			TimerManager->SetTimer(StepTimerHandle, this, &UFlowNode_Timer::OnStep, StepTime, true);
 		}
 
 		if (CompletionTime > UE_KINDA_SMALL_NUMBER)
 		{
-			GetWorld()->GetTimerManager().SetTimer(CompletionTimerHandle, this, &UFlowNode_Timer::OnCompletion, CompletionTime, false);
+			TimerManager->SetTimer(CompletionTimerHandle, this, &UFlowNode_Timer::OnCompletion, CompletionTime, false);
 		}
 		else
 		{
-			GetWorld()->GetTimerManager().SetTimerForNextTick(this, &UFlowNode_Timer::OnCompletion);
+			TimerManager->SetTimerForNextTick(this, &UFlowNode_Timer::OnCompletion);
 		}
 	}
 	else
 	{
 		LogError(TEXT("No valid world"));
-		TriggerOutput(TEXT("Completed"), true);
+		TriggerOutput(CompletedPin, true);
 	}
 }
 
@@ -86,34 +93,40 @@ void UFlowNode_Timer::Restart()
 
 void UFlowNode_Timer::OnStep()
 {
+	RecordEvent(EFlowRecordedEventType::TimerFired, StepPin.PinName);
+
 	SumOfSteps += StepTime;
 
 	if (SumOfSteps >= CompletionTime)
 	{
-		TriggerOutput(TEXT("Completed"), true);
+		TriggerOutput(CompletedPin, true);
 	}
 	else
 	{
-		TriggerOutput(TEXT("Step"));
+		TriggerOutput(StepPin);
 	}
 }
 
 void UFlowNode_Timer::OnCompletion()
 {
-	TriggerOutput(TEXT("Completed"), true);
+	RecordEvent(EFlowRecordedEventType::TimerFired, CompletedPin.PinName);
+
+	TriggerOutput(CompletedPin, true);
 }
 
 void UFlowNode_Timer::Cleanup()
 {
-	if (GetWorld())
+	FTimerManager* TimerManager = GetFlowTimerManager();
+
+	if (TimerManager)
 	{
-		GetWorld()->GetTimerManager().ClearTimer(CompletionTimerHandle);
+		TimerManager->ClearTimer(CompletionTimerHandle);
 	}
 	CompletionTimerHandle.Invalidate();
 
-	if (GetWorld())
+	if (TimerManager)
 	{
-		GetWorld()->GetTimerManager().ClearTimer(StepTimerHandle);
+		TimerManager->ClearTimer(StepTimerHandle);
 	}
 	StepTimerHandle.Invalidate();
 
@@ -122,30 +135,31 @@ void UFlowNode_Timer::Cleanup()
 
 void UFlowNode_Timer::OnSave_Implementation()
 {
-	if (GetWorld())
+	if (const FTimerManager* TimerManager = GetFlowTimerManager())
 	{
 		if (CompletionTimerHandle.IsValid())
 		{
-			RemainingCompletionTime = GetWorld()->GetTimerManager().GetTimerRemaining(CompletionTimerHandle);
+			RemainingCompletionTime = TimerManager->GetTimerRemaining(CompletionTimerHandle);
 		}
 
 		if (StepTimerHandle.IsValid())
 		{
-			RemainingStepTime = GetWorld()->GetTimerManager().GetTimerRemaining(StepTimerHandle);
+			RemainingStepTime = TimerManager->GetTimerRemaining(StepTimerHandle);
 		}
 	}
 }
 
 void UFlowNode_Timer::OnLoad_Implementation()
 {
-	if (RemainingStepTime > 0.0f || RemainingCompletionTime > 0.0f)
+	FTimerManager* TimerManager = GetFlowTimerManager();
+	if (TimerManager && (RemainingStepTime > 0.0f || RemainingCompletionTime > 0.0f))
 	{
 		if (RemainingStepTime > 0.0f)
 		{
-			GetWorld()->GetTimerManager().SetTimer(StepTimerHandle, this, &UFlowNode_Timer::OnStep, StepTime, true, RemainingStepTime);
+			TimerManager->SetTimer(StepTimerHandle, this, &UFlowNode_Timer::OnStep, StepTime, true, RemainingStepTime);
 		}
 
-		GetWorld()->GetTimerManager().SetTimer(CompletionTimerHandle, this, &UFlowNode_Timer::OnCompletion, RemainingCompletionTime, false);
+		TimerManager->SetTimer(CompletionTimerHandle, this, &UFlowNode_Timer::OnCompletion, RemainingCompletionTime, false);
 
 		RemainingStepTime = 0.0f;
 		RemainingCompletionTime = 0.0f;
@@ -175,9 +189,10 @@ FString UFlowNode_Timer::GetStatusString() const
 		return FString::Printf(TEXT("Progress: %.*f"), 2, SumOfSteps);
 	}
 
-	if (CompletionTimerHandle.IsValid() && GetWorld())
+	const FTimerManager* TimerManager = GetFlowTimerManager();
+	if (CompletionTimerHandle.IsValid() && TimerManager)
 	{
-		return FString::Printf(TEXT("Progress: %.*f"), 2, GetWorld()->GetTimerManager().GetTimerElapsed(CompletionTimerHandle));
+		return FString::Printf(TEXT("Progress: %.*f"), 2, TimerManager->GetTimerElapsed(CompletionTimerHandle));
 	}
 
 	return FString();
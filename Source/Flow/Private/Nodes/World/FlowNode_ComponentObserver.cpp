@@ -3,6 +3,12 @@
 #include "Nodes/World/FlowNode_ComponentObserver.h"
 #include "FlowSubsystem.h"
 
+const FFlowNativePin UFlowNode_ComponentObserver::StartPin(TEXT("Start"));
+const FFlowNativePin UFlowNode_ComponentObserver::StopPin(TEXT("Stop"));
+const FFlowNativePin UFlowNode_ComponentObserver::SuccessPin(TEXT("Success"));
+const FFlowNativePin UFlowNode_ComponentObserver::CompletedPin(TEXT("Completed"));
+const FFlowNativePin UFlowNode_ComponentObserver::StoppedPin(TEXT("Stopped"));
+
 UFlowNode_ComponentObserver::UFlowNode_ComponentObserver(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 	, IdentityMatchType(EFlowTagContainerMatchType::HasAnyExact)
@@ -14,21 +20,21 @@ UFlowNode_ComponentObserver::UFlowNode_ComponentObserver(const FObjectInitialize
 	Category = TEXT("World");
 #endif
 
-	InputPins = {FFlowPin(TEXT("Start")), FFlowPin(TEXT("Stop"))};
-	OutputPins = {FFlowPin(TEXT("Success")), FFlowPin(TEXT("Completed")), FFlowPin(TEXT("Stopped"))};
+	InputPins = {StartPin, StopPin};
+	OutputPins = {SuccessPin, CompletedPin, StoppedPin};
 }
 
 void UFlowNode_ComponentObserver::ExecuteInput(const FName& PinName)
 {
 	if (IdentityTags.IsValid())
 	{
-		if (PinName == TEXT("Start"))
+		if (PinName == StartPin)
 		{
 			StartObserving();
 		}
-		else if (PinName == TEXT("Stop"))
+		else if (PinName == StopPin)
 		{
-			TriggerOutput(TEXT("Stopped"), true);
+			TriggerOutput(StoppedPin, true);
 		}
 	}
 	else
@@ -54,7 +60,9 @@ void UFlowNode_ComponentObserver::StartObserving()
 		const bool bExactMatch = (IdentityMatchType == EFlowTagContainerMatchType::HasAnyExact || IdentityMatchType == EFlowTagContainerMatchType::HasAllExact);
 
 		// collect already registered components
-		for (const TWeakObjectPtr<UFlowComponent>& FoundComponent : FlowSubsystem->GetComponents<UFlowComponent>(IdentityTags, ContainerMatchType, bExactMatch))
+		TArray<UFlowComponent*, TInlineAllocator<16>> FoundComponents;
+		FlowSubsystem->GetComponents(IdentityTags, ContainerMatchType, FoundComponents, bExactMatch, GetWorld());
+		for (UFlowComponent* FoundComponent : FoundComponents)
 		{
 			ObserveActor(FoundComponent->GetOwner(), FoundComponent);
 			
@@ -86,7 +94,8 @@ void UFlowNode_ComponentObserver::StopObserving()
 
 void UFlowNode_ComponentObserver::OnComponentRegistered(UFlowComponent* Component)
 {
-	if (!RegisteredActors.Contains(Component->GetOwner()) && FlowTypes::HasMatchingTags(Component->IdentityTags, IdentityTags, IdentityMatchType) == true)
+	// subsystem might serve many worlds
+	if (Component->GetWorld() == GetWorld() && !RegisteredActors.Contains(Component->GetOwner()) && FlowTypes::HasMatchingTags(Component->IdentityTags, IdentityTags, IdentityMatchType) == true)
 	{
 		ObserveActor(Component->GetOwner(), Component);
 	}
@@ -94,7 +103,7 @@ void UFlowNode_ComponentObserver::OnComponentRegistered(UFlowComponent* Componen
 
 void UFlowNode_ComponentObserver::OnComponentTagAdded(UFlowComponent* Component, const FGameplayTagContainer& AddedTags)
 {
-	if (!RegisteredActors.Contains(Component->GetOwner()) && FlowTypes::HasMatchingTags(Component->IdentityTags, IdentityTags, IdentityMatchType) == true)
+	if (Component->GetWorld() == GetWorld() && !RegisteredActors.Contains(Component->GetOwner()) && FlowTypes::HasMatchingTags(Component->IdentityTags, IdentityTags, IdentityMatchType) == true)
 	{
 		ObserveActor(Component->GetOwner(), Component);
 	}
@@ -120,12 +129,12 @@ void UFlowNode_ComponentObserver::OnComponentUnregistered(UFlowComponent* Compon
 
 void UFlowNode_ComponentObserver::OnEventReceived()
 {
-	TriggerFirstOutput(false);
+	TriggerOutput(SuccessPin);
 
 	SuccessCount++;
 	if (SuccessLimit > 0 && SuccessCount == SuccessLimit)
 	{
-		TriggerOutput(TEXT("Completed"), true);
+		TriggerOutput(CompletedPin, true);
 	}
 }
 
@@ -18,9 +18,11 @@ UFlowNode_NotifyActor::UFlowNode_NotifyActor(const FObjectInitializer& ObjectIni
 
 void UFlowNode_NotifyActor::ExecuteInput(const FName& PinName)
 {
-	if (const UFlowSubsystem* FlowSubsystem = GetWorld()->GetGameInstance()->GetSubsystem<UFlowSubsystem>())
+	if (const UFlowSubsystem* FlowSubsystem = GetFlowSubsystem())
 	{
-		for (const TWeakObjectPtr<UFlowComponent>& Component : FlowSubsystem->GetComponents<UFlowComponent>(IdentityTags, EGameplayContainerMatchType::Any, bExactMatch))
+		TArray<UFlowComponent*, TInlineAllocator<16>> Components;
+		FlowSubsystem->GetComponents(IdentityTags, EGameplayContainerMatchType::Any, Components, bExactMatch, GetWorld());
+		for (UFlowComponent* Component : Components)
 		{
 			Component->NotifyFromGraph(NotifyTags, NetMode);
 		}
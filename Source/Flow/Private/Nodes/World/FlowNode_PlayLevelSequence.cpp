@@ -4,6 +4,7 @@
 
 #include "FlowAsset.h"
 #include "FlowModule.h"
+#include "FlowRecording.h"
 #include "FlowSubsystem.h"
 #include "LevelSequence/FlowLevelSequencePlayer.h"
 #include "MovieScene/MovieSceneFlowTrack.h"
@@ -16,6 +17,15 @@
 FFlowNodeLevelSequenceEvent UFlowNode_PlayLevelSequence::OnPlaybackStarted;
 FFlowNodeLevelSequenceEvent UFlowNode_PlayLevelSequence::OnPlaybackCompleted;
 
+const FFlowNativePin UFlowNode_PlayLevelSequence::StartPin(TEXT("Start"));
+const FFlowNativePin UFlowNode_PlayLevelSequence::PausePin(TEXT("Pause"));
+const FFlowNativePin UFlowNode_PlayLevelSequence::ResumePin(TEXT("Resume"));
+const FFlowNativePin UFlowNode_PlayLevelSequence::StopPin(TEXT("Stop"));
+const FFlowNativePin UFlowNode_PlayLevelSequence::PreStartPin(TEXT("PreStart"));
+const FFlowNativePin UFlowNode_PlayLevelSequence::StartedPin(TEXT("Started"));
+const FFlowNativePin UFlowNode_PlayLevelSequence::CompletedPin(TEXT("Completed"));
+const FFlowNativePin UFlowNode_PlayLevelSequence::StoppedPin(TEXT("Stopped"));
+
 UFlowNode_PlayLevelSequence::UFlowNode_PlayLevelSequence(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 	, bPlayReverse(false)
@@ -36,15 +46,15 @@ UFlowNode_PlayLevelSequence::UFlowNode_PlayLevelSequence(const FObjectInitialize
 #endif
 
 	InputPins.Empty();
-	InputPins.Add(FFlowPin(TEXT("Start")));
-	InputPins.Add(FFlowPin(TEXT("Pause")));
-	InputPins.Add(FFlowPin(TEXT("Resume")));
-	InputPins.Add(FFlowPin(TEXT("Stop")));
-
-	OutputPins.Add(FFlowPin(TEXT("PreStart")));
-	OutputPins.Add(FFlowPin(TEXT("Started")));
-	OutputPins.Add(FFlowPin(TEXT("Completed")));
-	OutputPins.Add(FFlowPin(TEXT("Stopped")));
+	InputPins.Add(StartPin);
+	InputPins.Add(PausePin);
+	InputPins.Add(ResumePin);
+	InputPins.Add(StopPin);
+
+	OutputPins.Add(PreStartPin);
+	OutputPins.Add(StartedPin);
+	OutputPins.Add(CompletedPin);
+	OutputPins.Add(StoppedPin);
 }
 
 #if WITH_EDITOR
@@ -155,6 +165,9 @@ void UFlowNode_PlayLevelSequence::CreatePlayer()
 		if (SequencePlayer)
 		{
 			SequencePlayer->SetFlowEventReceiver(this);
+
+			// playback is started right after creating the player
+			GetFlowSubsystem()->RegisterSequencePlayer(SequencePlayer);
 		}
 
 		const FFrameRate FrameRate = LoadedSequence->GetMovieScene()->GetTickResolution();
@@ -165,7 +178,7 @@ void UFlowNode_PlayLevelSequence::CreatePlayer()
 
 void UFlowNode_PlayLevelSequence::ExecuteInput(const FName& PinName)
 {
-	if (PinName == TEXT("Start"))
+	if (PinName == StartPin)
 	{
 		LoadedSequence = Sequence.LoadSynchronous();
 
@@ -175,7 +188,7 @@ void UFlowNode_PlayLevelSequence::ExecuteInput(const FName& PinName)
 
 			if (SequencePlayer)
 			{
-				TriggerOutput(TEXT("PreStart"));
+				TriggerOutput(PreStartPin);
 
 				SequencePlayer->OnFinished.AddDynamic(this, &UFlowNode_PlayLevelSequence::OnPlaybackFinished);
 
@@ -188,21 +201,21 @@ void UFlowNode_PlayLevelSequence::ExecuteInput(const FName& PinName)
 					SequencePlayer->Play();
 				}
 
-				TriggerOutput(TEXT("Started"));
+				TriggerOutput(StartedPin);
 			}
 		}
 
 		TriggerFirstOutput(false);
 	}
-	else if (PinName == TEXT("Stop"))
+	else if (PinName == StopPin)
 	{
 		StopPlayback();
 	}
-	else if (PinName == TEXT("Pause"))
+	else if (PinName == PausePin)
 	{
 		SequencePlayer->Pause();
 	}
-	else if (PinName == TEXT("Resume") && SequencePlayer->IsPaused())
+	else if (PinName == ResumePin && SequencePlayer->IsPaused())
 	{
 		SequencePlayer->Play();
 	}
@@ -249,6 +262,7 @@ void UFlowNode_PlayLevelSequence::OnLoad_Implementation()
 
 void UFlowNode_PlayLevelSequence::TriggerEvent(const FString& EventName)
 {
+	RecordEvent(EFlowRecordedEventType::SequenceEvent, *EventName);
 	TriggerOutput(*EventName, false);
 }
 
@@ -265,7 +279,7 @@ void UFlowNode_PlayLevelSequence::OnTimeDilationUpdate(const float NewTimeDilati
 
 void UFlowNode_PlayLevelSequence::OnPlaybackFinished()
 {
-	TriggerOutput(TEXT("Completed"), true);
+	TriggerOutput(CompletedPin, true);
 }
 
 void UFlowNode_PlayLevelSequence::StopPlayback()
@@ -275,7 +289,7 @@ void UFlowNode_PlayLevelSequence::StopPlayback()
 		SequencePlayer->Stop();
 	}
 
-	TriggerOutput(TEXT("Stopped"), true);
+	TriggerOutput(StoppedPin, true);
 }
 
 void UFlowNode_PlayLevelSequence::Cleanup()
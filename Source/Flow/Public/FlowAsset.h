@@ -2,7 +2,9 @@
 
 #pragma once
 
+#include "FlowCookedGraph.h"
 #include "FlowMessageLog.h"
+#include "FlowParameter.h"
 #include "FlowSave.h"
 #include "FlowTypes.h"
 #include "Nodes/FlowNode.h"
@@ -35,6 +37,30 @@ DECLARE_DELEGATE(FFlowGraphEvent);
 
 #endif
 
+/**
+ * SubGraph node replaced with a copy of its Flow Asset while cooking
+ */
+USTRUCT()
+struct FLOW_API FFlowInlinedSubGraph
+{
+	GENERATED_BODY()
+
+	// SubGraph node placed in the parent graph
+	UPROPERTY()
+	FGuid SubGraphNodeGuid;
+
+	UPROPERTY()
+	TSoftObjectPtr<UFlowAsset> Asset;
+
+	// Targets of the SubGraph node input pins: Start and Custom Inputs
+	UPROPERTY()
+	TMap<FName, FConnectedPin> Entries;
+
+	// Guids of inlined nodes mapped to guids of the original nodes in the SubGraph asset
+	UPROPERTY()
+	TMap<FGuid, FGuid> NodeGuids;
+};
+
 /**
  * Single asset containing flow nodes.
  */
@@ -59,6 +85,16 @@ class FLOW_API UFlowAsset : public UObject
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Flow Asset")
 	bool bWorldBound;
 
+	// Values that nodes can bind their properties to, overridden per instance by Root Flow owner, SubGraph node or Flow Asset Variant
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Flow Asset")
+	TArray<FFlowParameter> Parameters;
+
+	// Stateless utility graphs can be executed by a single instance, entered by every SubGraph node within the scope
+	// Outputs are routed back to the SubGraph node that triggered the input, so graph shouldn't contain latent nodes
+	// Instance is owned by the scope object, shared instances are never written to SaveGame
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Flow Asset")
+	EFlowSharedInstanceScope SharedInstanceScope;
+
 //////////////////////////////////////////////////////////////////////////
 // Graph
 
@@ -128,6 +164,23 @@ private:
 	UPROPERTY(EditAnywhere, Category = "Sub Graph")
 	TArray<FName> CustomOutputs;
 
+	/**
+	 * If enabled, SubGraph nodes using this asset are replaced with a copy of this graph while cooking, if it's small enough
+	 * Custom Inputs and Custom Outputs become direct connections, so no separate asset instance is created at runtime
+	 * Note: Finish node of the inlined graph doesn't abort nodes still active inside it
+	 */
+	UPROPERTY(EditAnywhere, Category = "Sub Graph")
+	bool bInlineOnCook;
+
+#if WITH_EDITORONLY_DATA
+	/**
+	 * FlowNativize commandlet generates C++ dispatching signals between nodes of this asset
+	 * Meant for a few assets that drive majority of signal traffic, generated code has to be regenerated after every graph change
+	 */
+	UPROPERTY(EditAnywhere, AssetRegistrySearchable, Category = "Cooking")
+	bool bGenerateNativeCode;
+#endif
+
 public:
 #if WITH_EDITOR
 	FFlowGraphEvent OnSubGraphReconstructionRequested;
@@ -210,12 +263,87 @@ protected:
 		}
 	}
 
+//////////////////////////////////////////////////////////////////////////
+// SubGraph inlining
+
+private:
+	// Copies of nodes from inlined SubGraph assets, exists only in cooked data
+	UPROPERTY()
+	TMap<FGuid, UFlowNode*> InlinedNodes;
+
+	UPROPERTY()
+	TArray<FFlowInlinedSubGraph> InlinedSubGraphs;
+
+#if WITH_EDITOR
+public:
+	// UObject
+	virtual void PreSave(FObjectPreSaveContext SaveContext) override;
+	virtual void PostSave(FObjectPostSaveContext SaveContext) override;
+	// --
+
+private:
+	void InlineSubGraphs();
+	bool CanInlineSubGraph(const UFlowNode_SubGraph* SubGraphNode, const UFlowAsset* SubGraphAsset) const;
+	void InlineSubGraph(const UFlowNode_SubGraph* SubGraphNode, const UFlowAsset* SubGraphAsset);
+	void ClearInlinedSubGraphs();
+#endif
+
+	// Replaces connection to inlined SubGraph node with connection to the node copied from the SubGraph asset
+	// Returns false if connection leads to the SubGraph input pin that isn't connected to anything
+	bool ResolveInlinedConnection(FConnectedPin& Connection) const;
+	void RedirectInlinedConnections(UFlowNode* Node) const;
+
+public:
+	const TArray<FFlowInlinedSubGraph>& GetInlinedSubGraphs() const { return InlinedSubGraphs; }
+
+//////////////////////////////////////////////////////////////////////////
+// Cooked graph
+
+private:
+	// Exists only in cooked data, instances use the graph of their template asset
+	FFlowCookedGraph CookedGraph;
+
+public:
+	// UObject
+	virtual void Serialize(FArchive& Ar) override;
+	virtual void GetResourceSizeEx(FResourceSizeEx& CumulativeResourceSize) override;
+	// --
+
+	const FFlowCookedGraph& GetCookedGraph() const { return TemplateAsset ? TemplateAsset->CookedGraph : CookedGraph; }
+
+#if WITH_EDITOR
+	// Inlines SubGraphs and builds cooked graph, exactly as it happens while cooking the asset
+	// Called also by editor tools generating code from the cooked graph, which clear the data afterwards
+	void BuildCookedData();
+	void ClearCookedData();
+
+private:
+	// Uses Derived Data Cache, keyed on the hash of graph topology
+	void BuildCookedGraph();
+#endif
+
+private:
+	// Instance nodes in order of the cooked graph
+	TArray<UFlowNode*> CookedGraphNodes;
+
+	// Generated code replacing lookups of connections, if its hash matches the cooked graph
+	const class IFlowNativeGraph* NativeGraph;
+
+public:
+	const IFlowNativeGraph* GetNativeGraph() const { return NativeGraph; }
+
+	// Index of the node in the cooked graph
+	void TriggerInputByIndex(const int32 NodeIndex, const FName& PinName);
+
+	// Signals input of the instance node, as if the connected node triggered its output
+	void TriggerInput(const FGuid& NodeGuid, const FName& PinName);
+
 //////////////////////////////////////////////////////////////////////////
 // Instances of the template asset
 
 private:
 	// Original object holds references to instances
-	UPROPERTY(Transient)
+	// Not reported to garbage collector, Flow Subsystem is the only root of running instances and removes them on finish
 	TArray<UFlowAsset*> ActiveInstances;
 
 #if WITH_EDITORONLY_DATA
@@ -226,12 +354,20 @@ private:
 	TSharedPtr<class FFlowMessageLog> RuntimeLog;
 #endif
 
+	// Parameter values resolved for instances of this template, one block per distinct set of overrides
+	// Released with the last instance, as bound properties might change between game sessions in the editor
+	TArray<TSharedRef<const FFlowResolvedParameters>> ResolvedParameters;
+
 public:
 	void AddInstance(UFlowAsset* Instance);
 	int32 RemoveInstance(UFlowAsset* Instance);
 
+	// Values of bound properties for the given overrides, imported once and reused by following instances
+	TSharedRef<const FFlowResolvedParameters> ResolveParameters(const TArray<FFlowParameter>& Overrides);
+
 	void ClearInstances();
 	int32 GetInstancesNum() const { return ActiveInstances.Num(); }
+	const TArray<UFlowAsset*>& GetInstances() const { return ActiveInstances; }
 
 #if WITH_EDITOR
 	void GetInstanceDisplayNames(TArray<TSharedPtr<FName>>& OutDisplayNames) const;
@@ -271,34 +407,62 @@ protected:
 	// Flow Asset instances created by SubGraph nodes placed in the current graph
 	TMap<TWeakObjectPtr<UFlowNode_SubGraph>, TWeakObjectPtr<UFlowAsset>> ActiveSubGraphs;
 
+	// Instance created for the Shared Instance Scope, entered by many SubGraph nodes
+	bool bSharedInstance;
+
+	// SubGraph nodes currently executing the shared instance, outputs are routed to the last one
+	// Not reported to garbage collector, callers are only kept for the duration of their call
+	TArray<UFlowNode_SubGraph*> SharedInstanceCallers;
+
+	// Containers below aren't reported to garbage collector, as they only point to nodes already referenced by the Nodes map
+	// With many instances running, every additional reference to the same node is a measurable cost of reachability analysis
+
 	// Optional entry points to the graph, similar to blueprint Custom Events
-	UPROPERTY()
 	TSet<UFlowNode_CustomInput*> CustomInputNodes;
 
-	UPROPERTY()
 	TSet<UFlowNode*> PreloadedNodes;
 
 	// Nodes that have any work left, not marked as Finished yet
-	UPROPERTY()
 	TArray<UFlowNode*> ActiveNodes;
 
 	// All nodes active in the past, done their work
-	UPROPERTY()
 	TArray<UFlowNode*> RecordedNodes;
 
 	EFlowFinishPolicy FinishPolicy;
 
+	// Seeded by Flow Subsystem, so random choices of nodes are repeated by the replay
+	UPROPERTY(SaveGame)
+	FRandomStream RandomStream;
+
+	// Only parameters differing from template defaults, applied to nodes again after loading SaveGame
+	UPROPERTY(SaveGame)
+	TArray<FFlowParameter> ParameterOverrides;
+
+	void ApplyParameters();
+
 public:
 	virtual void InitializeInstance(const TWeakObjectPtr<UObject> InOwner, UFlowAsset* InTemplateAsset);
 	virtual void DeinitializeInstance();
 
 	UFlowAsset* GetTemplateAsset() const { return TemplateAsset; }
 
+	// Use instead of global random functions, so execution can be recorded and replayed
+	FRandomStream& GetRandomStream() { return RandomStream; }
+
+	// Value overridden by this instance, or default declared by the template
+	UFUNCTION(BlueprintPure, Category = "Flow")
+	bool GetParameterValue(const FName& Name, FString& OutValue) const;
+
+	const TArray<FFlowParameter>& GetParameterOverrides() const { return ParameterOverrides; }
+
 	// Object that spawned Root Flow instance, i.e. World Settings or Player Controller
 	// This pointer is passed to child instances: Flow Asset instances created by the SubGraph nodes
 	UFUNCTION(BlueprintPure, Category = "Flow")
 	UObject* GetOwner() const { return Owner.Get(); }
 
+	// Instance lives in the world of its owner, as the game instance might host many worlds
+	virtual UWorld* GetWorld() const override;
+
 	template <class T>
 	TWeakObjectPtr<T> GetOwner() const
 	{
@@ -323,11 +487,19 @@ public:
 	// Get Flow Asset instance created by the given SubGraph node
 	TWeakObjectPtr<UFlowAsset> GetFlowInstance(UFlowNode_SubGraph* SubGraphNode) const;
 
+	bool IsSharedInstance() const { return bSharedInstance; }
+
 protected:
 	void TriggerCustomInput_FromSubGraph(UFlowNode_SubGraph* Node, const FName& EventName) const;
 	void TriggerCustomOutput(const FName& EventName);
 
-	void TriggerInput(const FGuid& NodeGuid, const FName& PinName);
+	// Executes shared instance on behalf of the SubGraph node, None event name triggers the Start node
+	void ExecuteSharedInstance(UFlowNode_SubGraph* Caller, const FName& EventName);
+
+	// SubGraph node receiving outputs of this instance
+	UFlowNode_SubGraph* GetSubGraphCaller() const;
+
+	void TriggerInput(UFlowNode* Node, const FName& PinName);
 
 	void FinishNode(UFlowNode* Node);
 	void ResetNodes();
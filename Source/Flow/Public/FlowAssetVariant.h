@@ -0,0 +1,28 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#pragma once
+
+#include "Engine/DataAsset.h"
+
+#include "FlowParameter.h"
+#include "FlowAssetVariant.generated.h"
+
+class UFlowAsset;
+
+/**
+ * Flow Asset with different parameter values, without duplicating the graph
+ * All variants of the same Flow Asset share its template, only parameter overrides are stored per instance
+ */
+UCLASS(BlueprintType, meta = (DisplayName = "Flow Asset Variant"))
+class FLOW_API UFlowAssetVariant : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Flow Asset Variant")
+	UFlowAsset* BaseAsset;
+
+	// Overrides of parameters declared by the Base Asset, parameters not listed here keep the default value
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Flow Asset Variant")
+	TArray<FFlowParameter> Parameters;
+};
@@ -5,6 +5,7 @@
 #include "Components/ActorComponent.h"
 #include "GameplayTagContainer.h"
 
+#include "FlowParameter.h"
 #include "FlowSave.h"
 #include "FlowTypes.h"
 #include "FlowOwnerInterface.h"
@@ -12,6 +13,7 @@
 
 class UFlowAsset;
 class UFlowSubsystem;
+enum class EFlowRecordedEventType : uint8;
 
 USTRUCT()
 struct FNotifyTagReplication
@@ -126,6 +128,9 @@ private:
 	UFUNCTION()
 	void OnRep_SentNotifyTags();
 
+	// Captures notify while Flow Subsystem is recording
+	void RecordNotify(const EFlowRecordedEventType Type, const FGameplayTagContainer& Tags) const;
+
 public:
 	FFlowComponentNotify OnNotifyFromComponent;
 
@@ -174,6 +179,10 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "RootFlow")
 	UFlowAsset* RootFlow;
 
+	// Overrides of parameters declared by the Root Flow, so placed actors can reuse the same asset with different values
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "RootFlow")
+	TArray<FFlowParameter> RootFlowParameters;
+
 	// If true, component will start Root Flow on Begin Play
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "RootFlow")
 	bool bAutoStartRootFlow;
@@ -247,4 +256,8 @@ protected:
 public:
 	UFlowSubsystem* GetFlowSubsystem() const;
 	bool IsFlowNetMode(const EFlowNetMode NetMode) const;
+
+private:
+	// Resolved on Begin Play and cleared on End Play, so notifies and tag changes don't walk from world to game instance
+	TWeakObjectPtr<UFlowSubsystem> CachedFlowSubsystem;
 };
@@ -0,0 +1,73 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#pragma once
+
+#include "GameplayTagContainer.h"
+
+class UFlowComponent;
+
+/**
+ * Flow Components indexed by their Identity Tags
+ * Flow Subsystem keeps a single registry, or one per world if Flow Settings shard it by world
+ * Every tag is indexed also under all its parent tags, so non-exact queries cost as much as their result
+ */
+struct FLOW_API FFlowComponentRegistry
+{
+	void Add(const FGameplayTag& Tag, UFlowComponent* Component);
+	void Add(const FGameplayTagContainer& Tags, UFlowComponent* Component);
+
+	void Remove(const FGameplayTag& Tag, UFlowComponent* Component);
+	void Remove(const FGameplayTagContainer& Tags, UFlowComponent* Component);
+
+	void FindComponents(const FGameplayTag& Tag, const bool bExactMatch, TArray<TWeakObjectPtr<UFlowComponent>>& OutComponents) const;
+	void FindComponents(const FGameplayTagContainer& Tags, const EGameplayContainerMatchType MatchType, const bool bExactMatch, TSet<TWeakObjectPtr<UFlowComponent>>& OutComponents) const;
+
+	// Calls Visitor once for every valid component matching the query, without allocating memory
+	// Visitor returns false to stop iteration, the function returns false if iteration was stopped
+	bool ForEachComponent(const FGameplayTag& Tag, const bool bExactMatch, TFunctionRef<bool(UFlowComponent*)> Visitor) const;
+	bool ForEachComponent(const FGameplayTagContainer& Tags, const EGameplayContainerMatchType MatchType, const bool bExactMatch, TFunctionRef<bool(UFlowComponent*)> Visitor) const;
+
+	// Every registered component once, regardless of the number of its tags
+	void GetAllComponents(TSet<TWeakObjectPtr<UFlowComponent>>& OutComponents) const;
+
+	// Number of components registered with the tag, or with the tag or its child tags if not exact
+	int32 GetBucketSize(const FGameplayTag& Tag, const bool bExactMatch) const;
+
+	// Index of the tag with the smallest bucket, the only bucket scanned by query matching All tags
+	// INDEX_NONE if any of the tags has no components, as no component can match the query
+	int32 FindSmallestBucket(const FGameplayTagContainer& Tags, const bool bExactMatch) const;
+
+	// Number of distinct Identity Tags
+	int32 NumBuckets() const { return BucketSizes.Num(); }
+
+	// Number of components registered with the most common Identity Tag
+	int32 GetLargestBucketSize() const { return LargestBucketSize; }
+
+	// Identity Tags with most components, sorted from the largest bucket
+	void GetLargestBuckets(const int32 MaxBuckets, TArray<TPair<FGameplayTag, int32>>& OutBuckets) const;
+
+	int32 Num() const { return Components.Num(); }
+	SIZE_T GetAllocatedSize() const;
+
+	void Empty();
+
+private:
+	// Exact Identity Tags
+	TMultiMap<FGameplayTag, TWeakObjectPtr<UFlowComponent>> Components;
+
+	// Number of entries per exact Identity Tag, so queries can pick the smallest bucket without iterating it
+	TMap<FGameplayTag, int32> BucketSizes;
+
+	// Number of buckets of every size, so the largest bucket is known without iterating buckets after removal
+	TArray<int32> BucketSizeHistogram;
+	int32 LargestBucketSize = 0;
+
+	void ResizeBucket(const int32 OldSize, const int32 NewSize);
+
+	// Identity Tags and all their parents, with the number of component's tags matching given tag
+	// i.e. component tagged with A.B and A.C is counted twice in bucket of A
+	TMap<FGameplayTag, TMap<TWeakObjectPtr<UFlowComponent>, int32>> HierarchicalComponents;
+
+	void AddToHierarchy(const FGameplayTag& Tag, const TWeakObjectPtr<UFlowComponent>& Component);
+	void RemoveFromHierarchy(const FGameplayTag& Tag, const TWeakObjectPtr<UFlowComponent>& Component);
+};
@@ -0,0 +1,66 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/SecureHash.h"
+
+/**
+ * Compact topology of the Flow Asset, built while cooking and stored as a versioned blob in the cooked package
+ * Node guids, pin connections and entry points are resolved to indices, so runtime doesn't need to search the graph
+ */
+struct FLOW_API FFlowCookedGraph
+{
+	// Increase it whenever the layout changes, outdated blobs are ignored and runtime falls back to node data
+	static constexpr int32 Version = 2;
+
+	struct FOutput
+	{
+		FName PinName;
+		int32 NodeIndex = INDEX_NONE;
+		FName InputPinName;
+
+		friend FArchive& operator<<(FArchive& Ar, FOutput& Output)
+		{
+			return Ar << Output.PinName << Output.NodeIndex << Output.InputPinName;
+		}
+	};
+
+	struct FEntry
+	{
+		FName EventName;
+		int32 NodeIndex = INDEX_NONE;
+
+		friend FArchive& operator<<(FArchive& Ar, FEntry& Entry)
+		{
+			return Ar << Entry.EventName << Entry.NodeIndex;
+		}
+	};
+
+	// Hash of the topology, identifies native code generated from this graph
+	FSHAHash Hash;
+
+	// Sorted, so nodes can be found by binary search
+	TArray<FGuid> NodeGuids;
+
+	// Index of the first output of every node, the last element closes the range of the last node
+	TArray<int32> FirstOutputs;
+	TArray<FOutput> Outputs;
+
+	int32 DefaultEntryNode = INDEX_NONE;
+	TArray<FEntry> CustomInputs;
+
+	bool IsValid() const { return NodeGuids.Num() > 0; }
+	void Reset();
+
+	SIZE_T GetAllocatedSize() const;
+
+	int32 FindNode(const FGuid& NodeGuid) const;
+	TArrayView<const FOutput> GetOutputs(const int32 NodeIndex) const;
+
+	void SaveToBlob(TArray<uint8>& OutBlob);
+	bool LoadFromBlob(const TArray<uint8>& Blob);
+
+private:
+	void Serialize(FArchive& Ar);
+};
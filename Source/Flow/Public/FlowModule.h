@@ -2,11 +2,18 @@
 
 #pragma once
 
+#include "HAL/LowLevelMemTracker.h"
 #include "Logging/LogMacros.h"
 #include "Modules/ModuleInterface.h"
 
 DECLARE_LOG_CATEGORY_EXTERN(LogFlow, Log, All)
 
+// Low Level Memory Tracker tags, displayed as Flow/Instances, Flow/SaveGame and Flow/Registry
+LLM_DECLARE_TAG_API(Flow, FLOW_API);
+LLM_DECLARE_TAG_API(Flow_Instances, FLOW_API);
+LLM_DECLARE_TAG_API(Flow_SaveGame, FLOW_API);
+LLM_DECLARE_TAG_API(Flow_Registry, FLOW_API);
+
 class FFlowModule final : public IModuleInterface
 {
 public:
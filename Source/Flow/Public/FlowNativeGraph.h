@@ -0,0 +1,63 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/SecureHash.h"
+
+class UFlowAsset;
+
+/**
+ * Topology of a single Flow Asset compiled to C++ by the FlowNativize commandlet
+ * Node behavior still lives in UFlowNode instances, generated code only replaces lookups of connections
+ */
+class FLOW_API IFlowNativeGraph
+{
+public:
+	virtual ~IFlowNativeGraph() {}
+
+	// Node index matches index of the node in cooked graph of the asset
+	// Returns false if output pin isn't connected
+	virtual bool TriggerOutput(UFlowAsset& Instance, const int32 NodeIndex, const FName& PinName) const = 0;
+};
+
+/**
+ * Generated graphs register themselves during static initialization
+ * Flow Subsystem picks generated graph only if its hash matches the cooked graph of the asset
+ */
+class FLOW_API FFlowNativeGraphRegistry
+{
+public:
+	static void Register(const FName& AssetPath, const FSHAHash& Hash, const IFlowNativeGraph* NativeGraph);
+	static void Unregister(const FName& AssetPath);
+
+	static const IFlowNativeGraph* Find(const FName& AssetPath, const FSHAHash& Hash);
+
+private:
+	struct FEntry
+	{
+		FSHAHash Hash;
+		const IFlowNativeGraph* NativeGraph;
+	};
+
+	static TMap<FName, FEntry>& GetEntries();
+};
+
+struct FFlowNativeGraphRegistrar
+{
+	FFlowNativeGraphRegistrar(const TCHAR* InAssetPath, const TCHAR* Hash, const IFlowNativeGraph* NativeGraph)
+		: AssetPath(InAssetPath)
+	{
+		FSHAHash ParsedHash;
+		ParsedHash.FromString(Hash);
+		FFlowNativeGraphRegistry::Register(AssetPath, ParsedHash, NativeGraph);
+	}
+
+	~FFlowNativeGraphRegistrar()
+	{
+		FFlowNativeGraphRegistry::Unregister(AssetPath);
+	}
+
+private:
+	FName AssetPath;
+};
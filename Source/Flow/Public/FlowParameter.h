@@ -0,0 +1,101 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#pragma once
+
+#include "FlowParameter.generated.h"
+
+class UFlowAsset;
+class UFlowNode;
+
+/**
+ * Named value declared by Flow Asset, overridden when starting Root Flow, by SubGraph node or by Flow Asset Variant
+ * Value is text in the same format as property values copied in the details panel, so any property type can be bound
+ */
+USTRUCT(BlueprintType)
+struct FLOW_API FFlowParameter
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, SaveGame, Category = "FlowParameter")
+	FName Name;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, SaveGame, Category = "FlowParameter")
+	FString Value;
+
+	FFlowParameter()
+		: Name(NAME_None)
+	{
+	}
+
+	FFlowParameter(const FName& InName, const FString& InValue)
+		: Name(InName)
+		, Value(InValue)
+	{
+	}
+
+	static const FFlowParameter* Find(const TArray<FFlowParameter>& Parameters, const FName& Name)
+	{
+		return Parameters.FindByPredicate([&Name](const FFlowParameter& Parameter) { return Parameter.Name == Name; });
+	}
+};
+
+/**
+ * Node property receiving value of the Flow Asset parameter, when the asset instance is created
+ */
+USTRUCT()
+struct FLOW_API FFlowParameterBinding
+{
+	GENERATED_BODY()
+
+	// Name of the property declared by the node class
+	UPROPERTY(EditAnywhere, Category = "FlowParameter")
+	FName PropertyName;
+
+	// Name of the parameter declared by the Flow Asset
+	UPROPERTY(EditAnywhere, Category = "FlowParameter")
+	FName ParameterName;
+
+	FFlowParameterBinding()
+		: PropertyName(NAME_None)
+		, ParameterName(NAME_None)
+	{
+	}
+};
+
+/**
+ * Parameter values imported to the bound node properties once, then copied to nodes of every instance
+ * Built by the template asset for each distinct set of overrides, so creating an instance doesn't parse any text
+ */
+class FLOW_API FFlowResolvedParameters
+{
+public:
+	FFlowResolvedParameters(const UFlowAsset& Template, const TArray<FFlowParameter>& InOverrides);
+	~FFlowResolvedParameters();
+
+	FFlowResolvedParameters(const FFlowResolvedParameters&) = delete;
+	FFlowResolvedParameters& operator=(const FFlowResolvedParameters&) = delete;
+
+	const TArray<FFlowParameter>& GetOverrides() const { return Overrides; }
+	bool HasValues() const { return Values.Num() > 0; }
+
+	// Copies values to the instance of the template node identified by the guid
+	void Apply(const FGuid& NodeGuid, UFlowNode& Node) const;
+
+	SIZE_T GetAllocatedSize() const;
+
+private:
+	struct FValue
+	{
+		const FProperty* Property;
+		int32 Offset;
+	};
+
+	TArray<FFlowParameter> Overrides;
+
+	// Values of a single node are stored next to each other, node maps to its first value and count
+	TMap<FGuid, TPair<int32, int32>> NodeValues;
+	TArray<FValue> Values;
+
+	// Values of all bound properties, constructed and destroyed by their properties
+	TArray<uint8, TAlignedHeapAllocator<16>> Buffer;
+};
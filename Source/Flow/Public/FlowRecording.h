@@ -0,0 +1,104 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#pragma once
+
+#include "GameplayTagContainer.h"
+#include "UObject/SoftObjectPath.h"
+
+#include "FlowParameter.h"
+#include "FlowRecording.generated.h"
+
+UENUM()
+enum class EFlowRecordedEventType : uint8
+{
+	// Stimuli coming from outside of Flow graphs, applied again by the replay
+	StartRootFlow,
+	FinishRootFlow,
+	CustomInput,
+	NotifyGraph,
+	ComponentRegistered,
+	ComponentUnregistered,
+	IdentityTagsAdded,
+	IdentityTagsRemoved,
+
+	// Results of graph execution, compared with the replay to detect divergence
+	NotifyFromGraph,
+	TimerFired,
+	SequenceEvent
+};
+
+/**
+ * Single event captured by the Flow Subsystem recorder
+ */
+USTRUCT()
+struct FLOW_API FFlowRecordedEvent
+{
+	GENERATED_BODY()
+
+	// Seconds since the recording started, virtual time if the subsystem runs it
+	UPROPERTY()
+	double Time = 0.0;
+
+	UPROPERTY()
+	EFlowRecordedEventType Type = EFlowRecordedEventType::StartRootFlow;
+
+	// Path of component or owner object receiving or producing the event, relative to the world
+	UPROPERTY()
+	FString Object;
+
+	// Template of the Flow Asset instance
+	UPROPERTY()
+	FSoftObjectPath Asset;
+
+	// Node which produced the event
+	UPROPERTY()
+	FGuid NodeGuid;
+
+	// Custom Input, Timer output or Level Sequence event name
+	UPROPERTY()
+	FName Name;
+
+	UPROPERTY()
+	FGameplayTagContainer Tags;
+
+	// Finish Policy, or whether multiple instances are allowed for StartRootFlow
+	UPROPERTY()
+	int32 Value = 0;
+
+	// Parameter overrides provided to StartRootFlow
+	UPROPERTY()
+	TArray<FFlowParameter> Parameters;
+
+	bool IsStimulus() const { return Type < EFlowRecordedEventType::NotifyFromGraph; }
+
+	// Compares everything but time
+	bool Matches(const FFlowRecordedEvent& Other) const;
+
+	FString ToString() const;
+};
+
+/**
+ * Compact log of Flow execution, enough to re-execute it deterministically in a headless world
+ */
+USTRUCT()
+struct FLOW_API FFlowRecording
+{
+	GENERATED_BODY()
+
+	// Seed of random streams owned by Flow Asset instances
+	UPROPERTY()
+	int32 RandomSeed = 0;
+
+	UPROPERTY()
+	bool bVirtualTime = false;
+
+	// Time of stopping the recording
+	UPROPERTY()
+	double Duration = 0.0;
+
+	UPROPERTY()
+	TArray<FFlowRecordedEvent> Events;
+
+	bool SaveToFile(const FString& Filename);
+	bool LoadFromFile(const FString& Filename);
+};
@@ -46,6 +46,27 @@ struct FLOW_API FFlowAssetSaveData
 	}
 };
 
+// Root Flow saved and finished by UFlowSubsystem::ReleaseRootFlow, together with its sub-flows
+USTRUCT(BlueprintType)
+struct FLOW_API FFlowReleasedRootFlowSaveData
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY(SaveGame, VisibleAnywhere, Category = "Flow")
+	FString WorldName;
+
+	UPROPERTY(SaveGame, VisibleAnywhere, Category = "Flow")
+	FString InstanceName;
+
+	UPROPERTY(SaveGame, VisibleAnywhere, Category = "Flow")
+	TArray<FFlowAssetSaveData> FlowInstances;
+
+	friend FArchive& operator<<(FArchive& Ar, FFlowReleasedRootFlowSaveData& InReleasedData)
+	{
+		return Ar;
+	}
+};
+
 USTRUCT(BlueprintType)
 struct FLOW_API FFlowComponentSaveData
 {
@@ -90,11 +111,16 @@ public:
 
 	UPROPERTY(VisibleAnywhere, Category = "Flow")
 	TArray<FFlowAssetSaveData> FlowInstances;
+
+	// Root Flows released while their streaming content was hidden
+	UPROPERTY(VisibleAnywhere, Category = "Flow")
+	TArray<FFlowReleasedRootFlowSaveData> ReleasedRootFlows;
 	
 	friend FArchive& operator<<(FArchive& Ar, UFlowSaveGame& SaveGame)
 	{
 		Ar << SaveGame.FlowComponents;
 		Ar << SaveGame.FlowInstances;
+		Ar << SaveGame.ReleasedRootFlows;
 		return Ar;
 	}
 };
@@ -35,6 +35,12 @@ class FLOW_API UFlowSettings : public UDeveloperSettings
 	UPROPERTY(Config, EditAnywhere, Category = "Flow")
 	bool bLogOnSignalPassthrough;
 
+	// Partitions Flow Component registry, Root Flows and SaveGame data by world of their owners
+	// Enable it if the game instance hosts many game worlds at once, i.e. dedicated server running several matches
+	// Queries and world cleanup then scale with size of the given world only
+	UPROPERTY(Config, EditAnywhere, Category = "Flow")
+	bool bShardByWorld;
+
 	// Adjust the Titles for FlowNodes to be more expressive than default
 	// by incorporating data that would otherwise go in the Description
 	UPROPERTY(EditAnywhere, config, Category = "Nodes")
@@ -44,6 +50,10 @@ class FLOW_API UFlowSettings : public UDeveloperSettings
 	UPROPERTY(EditAnywhere, Config, Category = "Nodes", meta = (MustImplement = "/Script.Flow.FlowOwnerInterface"))
 	FSoftClassPath DefaultExpectedOwnerClass;
 
+	// SubGraph asset marked as "Inline On Cook" will be inlined only if it contains up to this number of nodes
+	UPROPERTY(EditAnywhere, Config, Category = "Cooking", meta = (ClampMin = 0))
+	int32 MaxInlinedSubGraphNodes;
+
 public:
 	UClass* GetDefaultExpectedOwnerClass() const;
 
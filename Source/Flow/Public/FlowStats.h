@@ -0,0 +1,29 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#pragma once
+
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "Stats/Stats.h"
+
+// Use "stat Flow" to display these, all of them compile out if stats are disabled
+DECLARE_STATS_GROUP(TEXT("Flow"), STATGROUP_Flow, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Create Flow Instance"), STAT_FlowCreateInstance, STATGROUP_Flow, FLOW_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Initialize Instance"), STAT_FlowInitializeInstance, STATGROUP_Flow, FLOW_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Trigger Input"), STAT_FlowTriggerInput, STATGROUP_Flow, FLOW_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Execute Input"), STAT_FlowExecuteInput, STATGROUP_Flow, FLOW_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Find Components"), STAT_FlowFindComponents, STATGROUP_Flow, FLOW_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Save Game"), STAT_FlowSaveGame, STATGROUP_Flow, FLOW_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Load Root Flow"), STAT_FlowLoadRootFlow, STATGROUP_Flow, FLOW_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("MovieScene Flow Track"), STAT_FlowMovieSceneTrack, STATGROUP_Flow, FLOW_API);
+
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Live Instances"), STAT_FlowLiveInstances, STATGROUP_Flow, FLOW_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Active Nodes"), STAT_FlowActiveNodes, STATGROUP_Flow, FLOW_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Signals"), STAT_FlowSignals, STATGROUP_Flow, FLOW_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Registry Size"), STAT_FlowRegistrySize, STATGROUP_Flow, FLOW_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Registry Buckets"), STAT_FlowRegistryBuckets, STATGROUP_Flow, FLOW_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Registry Largest Bucket"), STAT_FlowRegistryLargestBucket, STATGROUP_Flow, FLOW_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Registry Scanned Entries"), STAT_FlowRegistryScannedEntries, STATGROUP_Flow, FLOW_API);
+
+// CSV profiler category, captured with "csvprofile start" or -csvCaptureFrames
+CSV_DECLARE_CATEGORY_MODULE_EXTERN(FLOW_API, Flow);
@@ -5,12 +5,18 @@
 #include "GameFramework/Actor.h"
 #include "GameplayTagContainer.h"
 #include "Subsystems/GameInstanceSubsystem.h"
+#include "UObject/ObjectKey.h"
 
 #include "FlowComponent.h"
+#include "FlowComponentRegistry.h"
+#include "FlowRecording.h"
 #include "FlowSubsystem.generated.h"
 
+class FTimerManager;
 class UFlowAsset;
+class UFlowAssetVariant;
 class UFlowNode_SubGraph;
+class UMovieSceneSequencePlayer;
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FSimpleFlowEvent);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FSimpleFlowComponentEvent, UFlowComponent*, Component);
@@ -18,6 +24,17 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FTaggedFlowComponentEvent, UFlowCom
 
 DECLARE_DELEGATE_OneParam(FNativeFlowAssetEvent, class UFlowAsset*);
 
+/**
+ * Part of the Flow Subsystem dedicated to a single world, if Flow Settings shard the subsystem by world
+ */
+struct FFlowWorldShard
+{
+	FFlowComponentRegistry ComponentRegistry;
+
+	/* Root Flow instances owned by objects living in this world */
+	TMap<UFlowAsset*, TWeakObjectPtr<UObject>> RootInstances;
+};
+
 /**
  * Flow Subsystem
  * - manages lifetime of Flow Graphs
@@ -41,14 +58,29 @@ private:
 	UPROPERTY()
 	TArray<UFlowAsset*> InstancedTemplates;
 
-	/* Assets instanced by object from another system, i.e. World Settings or Player Controller */
-	UPROPERTY()
+	/* Assets instanced by object from another system, i.e. World Settings or Player Controller
+	 * Reported to garbage collector by AddReferencedObjects, together with other instances */
 	TMap<UFlowAsset*, TWeakObjectPtr<UObject>> RootInstances;
 
-	/* Assets instanced by Sub Graph nodes */
-	UPROPERTY()
+	/* Assets instanced by Sub Graph nodes
+	 * Reported to garbage collector by AddReferencedObjects, nodes are kept alive by their parent instance */
 	TMap<UFlowNode_SubGraph*, UFlowAsset*> InstancedSubFlows;
 
+	/* Instances of assets with Shared Instance Scope, keyed by template and scope object
+	 * Reported to garbage collector by AddReferencedObjects */
+	TMap<TPair<UFlowAsset*, FObjectKey>, UFlowAsset*> SharedSubFlows;
+
+	/* Registries and Root Flows partitioned by world, so queries and world cleanup only touch objects of the given world
+	 * Used only if Flow Settings shard the subsystem by world, i.e. the process hosts many game worlds */
+	TMap<TObjectKey<UWorld>, FFlowWorldShard> WorldShards;
+	bool bShardedByWorld;
+
+	FDelegateHandle WorldCleanupHandle;
+
+	/* Root Flows saved and finished by ReleaseRootFlow, keyed by name of the released instance
+	 * Records include sub-flows of the released instance, kept until restored or discarded by the owner */
+	TMap<FString, TArray<FFlowAssetSaveData>> ReleasedRootFlows;
+
 #if WITH_EDITOR
 public:
 	/* Called after creating the first instance of given Flow Asset */
@@ -63,6 +95,9 @@ protected:
 	UFlowSaveGame* LoadedSaveGame;
 
 public:
+	/* Single root reporting every running instance, instances report their nodes through the Nodes map */
+	static void AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector);
+
 	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
 
 	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
@@ -75,7 +110,20 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "FlowSubsystem", meta = (DefaultToSelf = "Owner"))
 	virtual void StartRootFlow(UObject* Owner, UFlowAsset* FlowAsset, const bool bAllowMultipleInstances = true);
 
-	virtual UFlowAsset* CreateRootFlow(UObject* Owner, UFlowAsset* FlowAsset, const bool bAllowMultipleInstances = true);
+	/* Start the root Flow with values of Flow Asset parameters, instance shares the template with every other instance of the asset */
+	UFUNCTION(BlueprintCallable, Category = "FlowSubsystem", meta = (DefaultToSelf = "Owner", AutoCreateRefTerm = "Parameters"))
+	virtual void StartRootFlowWithParameters(UObject* Owner, UFlowAsset* FlowAsset, const TArray<FFlowParameter>& Parameters, const bool bAllowMultipleInstances = true);
+
+	/* Start the root Flow from the Base Asset of variant, with parameter values of the variant */
+	UFUNCTION(BlueprintCallable, Category = "FlowSubsystem", meta = (DefaultToSelf = "Owner"))
+	void StartRootFlowVariant(UObject* Owner, UFlowAssetVariant* Variant, const bool bAllowMultipleInstances = true);
+
+	virtual UFlowAsset* CreateRootFlow(UObject* Owner, UFlowAsset* FlowAsset, const bool bAllowMultipleInstances = true, const TArray<FFlowParameter>& Parameters = TArray<FFlowParameter>());
+
+	/* Start the root Flow and return its instance, the same owner might run any number of instances of the asset
+	 * Caller identifies the Flow by the returned instance, i.e. World Settings running a Flow per streaming level
+	 * Instance Name should be stable between game sessions, if the owner loads the Flow by this name from the SaveGame */
+	UFlowAsset* StartOwnedRootFlow(UObject* Owner, UFlowAsset* FlowAsset, const FString& InstanceName = FString());
 
 	/* Finish Policy value is read by Flow Node
 	 * Nodes have opportunity to terminate themselves differently if Flow Graph has been aborted
@@ -89,15 +137,39 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "FlowSubsystem", meta = (DefaultToSelf = "Owner"))
 	virtual void FinishAllRootFlows(UObject* Owner, const EFlowFinishPolicy FinishPolicy);
 
+	/* Finish the given Root Flow instance, does nothing if it has finished already */
+	void FinishRootInstance(UFlowAsset* Instance, const EFlowFinishPolicy FinishPolicy);
+
 protected:
+	/* Creates the Root Flow without checking for other instances of the owner */
+	UFlowAsset* CreateRootInstance(UObject* Owner, UFlowAsset* FlowAsset, const TArray<FFlowParameter>& Parameters, const FString& InstanceName = FString());
+
 	UFlowAsset* CreateSubFlow(UFlowNode_SubGraph* SubGraphNode, const FString SavedInstanceName = FString(), const bool bPreloading = false);
 	void RemoveSubFlow(UFlowNode_SubGraph* SubGraphNode, const EFlowFinishPolicy FinishPolicy);
 
-	UFlowAsset* CreateFlowInstance(const TWeakObjectPtr<UObject> Owner, TSoftObjectPtr<UFlowAsset> FlowAsset, FString NewInstanceName = FString());
+	/* Returns instance shared by SubGraph nodes within the scope, or null if SubGraph should create its own instance */
+	UFlowAsset* FindOrCreateSharedSubFlow(UFlowNode_SubGraph* SubGraphNode);
+
+	/* Finishes shared instances owned by the scope object, and ones left by destroyed scopes */
+	void RemoveSharedSubFlows(const UObject* Scope);
+
+	UFlowAsset* CreateFlowInstance(const TWeakObjectPtr<UObject> Owner, TSoftObjectPtr<UFlowAsset> FlowAsset, FString NewInstanceName = FString(), const TArray<FFlowParameter>& Parameters = TArray<FFlowParameter>());
 
 	virtual void AddInstancedTemplate(UFlowAsset* Template);
 	virtual void RemoveInstancedTemplate(UFlowAsset* Template);
 
+	void AddRootInstance(UFlowAsset* Instance, UObject* Owner);
+	void RemoveRootInstance(UFlowAsset* Instance);
+
+	/* Root Flow instances that might be owned by given object, only ones living in the same world if the subsystem is sharded */
+	const TMap<UFlowAsset*, TWeakObjectPtr<UObject>>& GetRootInstancesInWorldOf(const UObject* Owner) const;
+
+	/* World the object lives in, or the Game Instance world if object doesn't belong to any */
+	UWorld* GetOwnerWorld(const UObject* Owner) const;
+
+	/* Finishes Root Flows and drops registry of the world, if the subsystem is sharded by world */
+	virtual void OnWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources);
+
 public:
 	/* Returns all assets instanced by object from another system like World Settings */
 	UFUNCTION(BlueprintPure, Category = "FlowSubsystem")
@@ -116,6 +188,9 @@ public:
 
 	virtual UWorld* GetWorld() const override;
 
+	/* Writes memory used by Flow instances, nodes, component registry and loaded SaveGame, executed by the Flow.MemReport command */
+	virtual void DumpMemoryReport(FOutputDevice& Ar);
+
 //////////////////////////////////////////////////////////////////////////
 // SaveGame support
 
@@ -137,12 +212,120 @@ public:
 	UFUNCTION(BlueprintPure, Category = "FlowSubsystem")
 	UFlowSaveGame* GetLoadedSaveGame() const { return LoadedSaveGame; }
 
+	/* Saves the Root Flow instance and finishes it, so it doesn't use CPU and memory until restored
+	 * Released objects are renamed and marked as garbage, as restored sub-flows are created under their saved names
+	 * Returns name of the released instance, to be passed to RestoreRootFlow, or empty string if the instance isn't running */
+	virtual FString ReleaseRootFlow(UFlowAsset* RootInstance);
+
+	/* Creates the Root Flow again from the state saved by ReleaseRootFlow, instance gets the released name back */
+	virtual UFlowAsset* RestoreRootFlow(UObject* Owner, UFlowAsset* FlowAsset, const FString& ReleasedInstanceName);
+
+	/* Drops the state saved by ReleaseRootFlow, if the owner won't restore it anymore */
+	void DiscardReleasedRootFlow(const FString& ReleasedInstanceName);
+
+	bool HasReleasedRootFlow(const FString& ReleasedInstanceName) const { return ReleasedRootFlows.Contains(ReleasedInstanceName); }
+
+	/* Creates the Root Flow from the loaded SaveGame under its saved name, for owners started it with StartOwnedRootFlow
+	 * Flow running while the game was saved is loaded, Flow released at that time is restored by RestoreRootFlow
+	 * Returns null if the SaveGame doesn't contain the instance */
+	virtual UFlowAsset* LoadOwnedRootFlow(UObject* Owner, UFlowAsset* FlowAsset, const FString& SavedAssetInstanceName);
+
+protected:
+	/* Record of the root or sub-flow instance saved by ReleaseRootFlow */
+	const FFlowAssetSaveData* FindReleasedInstance(const FString& InstanceName) const;
+
+public:
+
+//////////////////////////////////////////////////////////////////////////
+// Virtual time
+
+private:
+	/* Replaces world timers for Flow nodes while virtual time is enabled */
+	TSharedPtr<FTimerManager> VirtualTimerManager;
+
+	/* Level Sequences played by Flow nodes, advanced together with virtual timers */
+	TArray<TWeakObjectPtr<UMovieSceneSequencePlayer>> VirtualTimeSequencePlayers;
+
+	double VirtualTime;
+
+public:
+	/* Drives Flow-owned time (Timer nodes, Level Sequences played by Flow) by AdvanceVirtualTime instead of the world tick
+	 * Meant for headless simulations, i.e. running hours of timer-driven quests in minutes
+	 * Level Sequences are still ticked by the world too, so the world shouldn't advance its own time meanwhile
+	 * Can be toggled only while no Flow instance is running, so no node waits on a clock that stops ticking */
+	UFUNCTION(BlueprintCallable, Category = "FlowSubsystem|VirtualTime")
+	virtual void SetVirtualTimeEnabled(const bool bEnabled);
+
+	UFUNCTION(BlueprintPure, Category = "FlowSubsystem|VirtualTime")
+	bool IsVirtualTimeEnabled() const { return VirtualTimerManager.IsValid(); }
+
+	/* Advances virtual clock, expected to be called once per frame, Delta Seconds can be much longer than the real frame
+	 * Looping timers fire as many times as they would during this time, but timers started by them wait for the next call */
+	UFUNCTION(BlueprintCallable, Category = "FlowSubsystem|VirtualTime")
+	virtual void AdvanceVirtualTime(const float DeltaSeconds);
+
+	/* Seconds elapsed on the virtual clock since enabling it */
+	UFUNCTION(BlueprintPure, Category = "FlowSubsystem|VirtualTime")
+	double GetVirtualTime() const { return VirtualTime; }
+
+	/* Timer manager of the virtual clock, null unless virtual time is enabled
+	 * Nodes use timers of their own world otherwise, see UFlowNode::GetFlowTimerManager */
+	FTimerManager* GetTimerManager() const;
+
+	/* Called by nodes starting Level Sequence playback, so it follows the virtual clock if enabled */
+	void RegisterSequencePlayer(UMovieSceneSequencePlayer* SequencePlayer);
+
+//////////////////////////////////////////////////////////////////////////
+// Recording
+
+private:
+	TSharedPtr<FFlowRecording> Recording;
+	double RecordingStartTime;
+
+	/* Seed of random streams created for Flow Asset instances, combined with the order of creating instances */
+	int32 RandomSeed;
+	int32 SeededInstances;
+
+public:
+	/* Starts capturing stimuli of Flow execution: root flows, notifies, custom inputs and component registrations
+	 * Timer and Level Sequence events are captured too, so the replay can verify it executed the same way
+	 * Should be started before starting flows, as instances are seeded by the order of their creation */
+	UFUNCTION(BlueprintCallable, Category = "FlowSubsystem|Recording")
+	virtual void StartRecording();
+
+	/* Stops recording and writes it to the file, see FlowReplay commandlet */
+	UFUNCTION(BlueprintCallable, Category = "FlowSubsystem|Recording")
+	virtual bool StopRecording(const FString& Filename);
+
+	/* Stops recording and returns it */
+	TSharedPtr<FFlowRecording> FinishRecording();
+
+	UFUNCTION(BlueprintPure, Category = "FlowSubsystem|Recording")
+	bool IsRecording() const { return Recording.IsValid(); }
+
+	/* Adds event if recording, time and the name of Object are filled by the subsystem */
+	void RecordEvent(FFlowRecordedEvent&& Event, const UObject* Object);
+
+	/* Path of the object relative to the world, identifies recorded objects */
+	FString GetRecordedObjectName(const UObject* Object) const;
+
+	int32 GetRandomSeed() const { return RandomSeed; }
+	void SetRandomSeed(const int32 NewSeed);
+
+	/* Seed of the next Flow Asset instance */
+	int32 MakeInstanceSeed();
+
 //////////////////////////////////////////////////////////////////////////
 // Component Registry
 
 protected:
-	/* All the Flow Components currently existing in the world */
-	TMultiMap<FGameplayTag, TWeakObjectPtr<UFlowComponent>> FlowComponentRegistry;
+	/* All the Flow Components currently existing in the world, unless the subsystem is sharded by world */
+	FFlowComponentRegistry FlowComponentRegistry;
+
+	/* Registry of the world, subsystem keeps a single registry unless it's sharded by world */
+	FFlowComponentRegistry& GetComponentRegistry(const UWorld* World);
+	FFlowComponentRegistry* FindComponentRegistry(const UWorld* World);
+	const FFlowComponentRegistry* FindComponentRegistry(const UWorld* World) const;
 
 protected:
 	virtual void RegisterComponent(UFlowComponent* Component);
@@ -175,64 +358,95 @@ public:
 	/**
 	 * Returns all registered Flow Components identified by given tag
 	 * 
+	 * @param WorldContextObject Only components living in the world of this object are returned, if the subsystem is sharded by world
 	 * @param Tag Tag to check if it matches Identity Tags of registered Flow Components
 	 * @param ComponentClass Only components matching this class we'll be returned
-	 * @param bExactMatch If true, the tag has to be exactly present, if false then TagContainer will include it's parent tags while matching. Be careful, using latter option may be very expensive, as the search cost is proportional to the number of registered Gameplay Tags!
+	 * @param bExactMatch If true, the tag has to be exactly present, if false then TagContainer will include it's parent tags while matching
 	 */
-	UFUNCTION(BlueprintPure, Category = "FlowSubsystem", meta = (DeterminesOutputType = "ComponentClass"))
-	TSet<UFlowComponent*> GetFlowComponentsByTag(const FGameplayTag Tag, const TSubclassOf<UFlowComponent> ComponentClass, const bool bExactMatch = true) const;
+	UFUNCTION(BlueprintPure, Category = "FlowSubsystem", meta = (WorldContext = "WorldContextObject", DeterminesOutputType = "ComponentClass"))
+	TSet<UFlowComponent*> GetFlowComponentsByTagInWorld(const UObject* WorldContextObject, const FGameplayTag Tag, const TSubclassOf<UFlowComponent> ComponentClass, const bool bExactMatch = true) const;
 
 	/**
 	 * Returns all registered Flow Components identified by Any or All provided tags
 	 * 
+	 * @param WorldContextObject Only components living in the world of this object are returned, if the subsystem is sharded by world
 	 * @param Tags Container to check if it matches Identity Tags of registered Flow Components
 	 * @param MatchType If Any, returned component needs to have only one of given tags. If All, component needs to have all given Identity Tags
 	 * @param ComponentClass Only components matching this class we'll be returned
-	* @param bExactMatch If true, the tag has to be exactly present, if false then TagContainer will include it's parent tags while matching. Be careful, using latter option may be very expensive, as the search cost is proportional to the number of registered Gameplay Tags!
+	* @param bExactMatch If true, the tag has to be exactly present, if false then TagContainer will include it's parent tags while matching
 	 */
-	UFUNCTION(BlueprintPure, Category = "FlowSubsystem", meta = (DeterminesOutputType = "ComponentClass"))
-	TSet<UFlowComponent*> GetFlowComponentsByTags(const FGameplayTagContainer Tags, const EGameplayContainerMatchType MatchType, const TSubclassOf<UFlowComponent> ComponentClass, const bool bExactMatch = true) const;
+	UFUNCTION(BlueprintPure, Category = "FlowSubsystem", meta = (WorldContext = "WorldContextObject", DeterminesOutputType = "ComponentClass"))
+	TSet<UFlowComponent*> GetFlowComponentsByTagsInWorld(const UObject* WorldContextObject, const FGameplayTagContainer Tags, const EGameplayContainerMatchType MatchType, const TSubclassOf<UFlowComponent> ComponentClass, const bool bExactMatch = true) const;
 
 	/**
 	 * Returns all registered actors with Flow Component identified by given tag
 	 * 
+	 * @param WorldContextObject Only components living in the world of this object are returned, if the subsystem is sharded by world
 	 * @param Tag Tag to check if it matches Identity Tags of registered Flow Components
 	 * @param ActorClass Only actors matching this class we'll be returned
-	 * @param bExactMatch If true, the tag has to be exactly present, if false then TagContainer will include it's parent tags while matching. Be careful, using latter option may be very expensive, as the search cost is proportional to the number of registered Gameplay Tags!
+	 * @param bExactMatch If true, the tag has to be exactly present, if false then TagContainer will include it's parent tags while matching
 	 */
-	UFUNCTION(BlueprintPure, Category = "FlowSubsystem", meta = (DeterminesOutputType = "ActorClass"))
-	TSet<AActor*> GetFlowActorsByTag(const FGameplayTag Tag, const TSubclassOf<AActor> ActorClass, const bool bExactMatch = true) const;
+	UFUNCTION(BlueprintPure, Category = "FlowSubsystem", meta = (WorldContext = "WorldContextObject", DeterminesOutputType = "ActorClass"))
+	TSet<AActor*> GetFlowActorsByTagInWorld(const UObject* WorldContextObject, const FGameplayTag Tag, const TSubclassOf<AActor> ActorClass, const bool bExactMatch = true) const;
 
 	/**
 	 * Returns all registered actors with Flow Component identified by Any or All provided tags
 	 * 
+	 * @param WorldContextObject Only components living in the world of this object are returned, if the subsystem is sharded by world
 	 * @param Tags Container to check if it matches Identity Tags of registered Flow Components
 	 * @param MatchType If Any, returned component needs to have only one of given tags. If All, component needs to have all given Identity Tags
 	 * @param ActorClass Only actors matching this class we'll be returned
-	 * @param bExactMatch If true, the tag has to be exactly present, if false then TagContainer will include it's parent tags while matching. Be careful, using latter option may be very expensive, as the search cost is proportional to the number of registered Gameplay Tags!
+	 * @param bExactMatch If true, the tag has to be exactly present, if false then TagContainer will include it's parent tags while matching
 	 */
-	UFUNCTION(BlueprintPure, Category = "FlowSubsystem", meta = (DeterminesOutputType = "ActorClass"))
-	TSet<AActor*> GetFlowActorsByTags(const FGameplayTagContainer Tags, const EGameplayContainerMatchType MatchType, const TSubclassOf<AActor> ActorClass, const bool bExactMatch = true) const;
+	UFUNCTION(BlueprintPure, Category = "FlowSubsystem", meta = (WorldContext = "WorldContextObject", DeterminesOutputType = "ActorClass"))
+	TSet<AActor*> GetFlowActorsByTagsInWorld(const UObject* WorldContextObject, const FGameplayTagContainer Tags, const EGameplayContainerMatchType MatchType, const TSubclassOf<AActor> ActorClass, const bool bExactMatch = true) const;
 
 	/**
 	 * Returns all registered actors as pairs: Actor as key, its Flow Component as value
 	 * 
+	 * @param WorldContextObject Only components living in the world of this object are returned, if the subsystem is sharded by world
 	 * @param Tag Tag to check if it matches Identity Tags of registered Flow Components
 	 * @param ActorClass Only actors matching this class we'll be returned
-	 * @param bExactMatch If true, the tag has to be exactly present, if false then TagContainer will include it's parent tags while matching. Be careful, using latter option may be very expensive, as the search cost is proportional to the number of registered Gameplay Tags!
+	 * @param bExactMatch If true, the tag has to be exactly present, if false then TagContainer will include it's parent tags while matching
 	 */
-	UFUNCTION(BlueprintPure, Category = "FlowSubsystem", meta = (DeterminesOutputType = "ActorClass"))
-	TMap<AActor*, UFlowComponent*> GetFlowActorsAndComponentsByTag(const FGameplayTag Tag, const TSubclassOf<AActor> ActorClass, const bool bExactMatch = true) const;
+	UFUNCTION(BlueprintPure, Category = "FlowSubsystem", meta = (WorldContext = "WorldContextObject", DeterminesOutputType = "ActorClass"))
+	TMap<AActor*, UFlowComponent*> GetFlowActorsAndComponentsByTagInWorld(const UObject* WorldContextObject, const FGameplayTag Tag, const TSubclassOf<AActor> ActorClass, const bool bExactMatch = true) const;
 
 	/**
 	 * Returns all registered actors as pairs: Actor as key, its Flow Component as value
 	 * 
+	 * @param WorldContextObject Only components living in the world of this object are returned, if the subsystem is sharded by world
 	 * @param Tags Container to check if it matches Identity Tags of registered Flow Components
 	 * @param MatchType If Any, returned component needs to have only one of given tags. If All, component needs to have all given Identity Tags
 	 * @param ActorClass Only actors matching this class we'll be returned
-	 * @param bExactMatch If true, the tag has to be exactly present, if false then TagContainer will include it's parent tags while matching. Be careful, using latter option may be very expensive, as the search cost is proportional to the number of registered Gameplay Tags!
+	 * @param bExactMatch If true, the tag has to be exactly present, if false then TagContainer will include it's parent tags while matching
 	 */
-	UFUNCTION(BlueprintPure, Category = "FlowSubsystem", meta = (DeterminesOutputType = "ActorClass"))
+	UFUNCTION(BlueprintPure, Category = "FlowSubsystem", meta = (WorldContext = "WorldContextObject", DeterminesOutputType = "ActorClass"))
+	TMap<AActor*, UFlowComponent*> GetFlowActorsAndComponentsByTagsInWorld(const UObject* WorldContextObject, const FGameplayTagContainer Tags, const EGameplayContainerMatchType MatchType, const TSubclassOf<AActor> ActorClass, const bool bExactMatch = true) const;
+
+	/* Deprecated queries of Game Instance world, kept for existing callers */
+	UE_DEPRECATED(5.4, "Use GetFlowComponentsByTagInWorld, so the query returns components of the caller's world if the subsystem is sharded by world.")
+	UFUNCTION(BlueprintPure, Category = "FlowSubsystem", meta = (DeterminesOutputType = "ComponentClass", DeprecatedFunction, DeprecationMessage = "Use GetFlowComponentsByTagInWorld instead."))
+	TSet<UFlowComponent*> GetFlowComponentsByTag(const FGameplayTag Tag, const TSubclassOf<UFlowComponent> ComponentClass, const bool bExactMatch = true) const;
+
+	UE_DEPRECATED(5.4, "Use GetFlowComponentsByTagsInWorld, so the query returns components of the caller's world if the subsystem is sharded by world.")
+	UFUNCTION(BlueprintPure, Category = "FlowSubsystem", meta = (DeterminesOutputType = "ComponentClass", DeprecatedFunction, DeprecationMessage = "Use GetFlowComponentsByTagsInWorld instead."))
+	TSet<UFlowComponent*> GetFlowComponentsByTags(const FGameplayTagContainer Tags, const EGameplayContainerMatchType MatchType, const TSubclassOf<UFlowComponent> ComponentClass, const bool bExactMatch = true) const;
+
+	UE_DEPRECATED(5.4, "Use GetFlowActorsByTagInWorld, so the query returns components of the caller's world if the subsystem is sharded by world.")
+	UFUNCTION(BlueprintPure, Category = "FlowSubsystem", meta = (DeterminesOutputType = "ActorClass", DeprecatedFunction, DeprecationMessage = "Use GetFlowActorsByTagInWorld instead."))
+	TSet<AActor*> GetFlowActorsByTag(const FGameplayTag Tag, const TSubclassOf<AActor> ActorClass, const bool bExactMatch = true) const;
+
+	UE_DEPRECATED(5.4, "Use GetFlowActorsByTagsInWorld, so the query returns components of the caller's world if the subsystem is sharded by world.")
+	UFUNCTION(BlueprintPure, Category = "FlowSubsystem", meta = (DeterminesOutputType = "ActorClass", DeprecatedFunction, DeprecationMessage = "Use GetFlowActorsByTagsInWorld instead."))
+	TSet<AActor*> GetFlowActorsByTags(const FGameplayTagContainer Tags, const EGameplayContainerMatchType MatchType, const TSubclassOf<AActor> ActorClass, const bool bExactMatch = true) const;
+
+	UE_DEPRECATED(5.4, "Use GetFlowActorsAndComponentsByTagInWorld, so the query returns components of the caller's world if the subsystem is sharded by world.")
+	UFUNCTION(BlueprintPure, Category = "FlowSubsystem", meta = (DeterminesOutputType = "ActorClass", DeprecatedFunction, DeprecationMessage = "Use GetFlowActorsAndComponentsByTagInWorld instead."))
+	TMap<AActor*, UFlowComponent*> GetFlowActorsAndComponentsByTag(const FGameplayTag Tag, const TSubclassOf<AActor> ActorClass, const bool bExactMatch = true) const;
+
+	UE_DEPRECATED(5.4, "Use GetFlowActorsAndComponentsByTagsInWorld, so the query returns components of the caller's world if the subsystem is sharded by world.")
+	UFUNCTION(BlueprintPure, Category = "FlowSubsystem", meta = (DeterminesOutputType = "ActorClass", DeprecatedFunction, DeprecationMessage = "Use GetFlowActorsAndComponentsByTagsInWorld instead."))
 	TMap<AActor*, UFlowComponent*> GetFlowActorsAndComponentsByTags(const FGameplayTagContainer Tags, const EGameplayContainerMatchType MatchType, const TSubclassOf<AActor> ActorClass, const bool bExactMatch = true) const;
 
 	/**
@@ -240,27 +454,23 @@ public:
 	 * 
 	 * @tparam T Only components matching this class we'll be returned
 	 * @param Tag Tag to check if it matches Identity Tags of registered Flow Components
-	 * @param bExactMatch If true, the tag has to be exactly present, if false then TagContainer will include it's parent tags while matching. Be careful, using latter option may be very expensive, as the search cost is proportional to the number of registered Gameplay Tags!
+	 * @param bExactMatch If true, the tag has to be exactly present, if false then TagContainer will include it's parent tags while matching
+	 * @param World World of registered components, if the subsystem is sharded by world. Game Instance world if not provided
 	 */
 	template <class T>
-	TSet<TWeakObjectPtr<T>> GetComponents(const FGameplayTag& Tag, const bool bExactMatch = true) const
+	TSet<TWeakObjectPtr<T>> GetComponents(const FGameplayTag& Tag, const bool bExactMatch = true, const UWorld* World = nullptr) const
 	{
 		static_assert(TPointerIsConvertibleFromTo<T, const UActorComponent>::Value, "'T' template parameter to GetComponents must be derived from UActorComponent");
 
-		TArray<TWeakObjectPtr<UFlowComponent>> FoundComponents;
-		FindComponents(Tag, bExactMatch, FoundComponents);
-
 		TSet<TWeakObjectPtr<T>> Result;
-		for (const TWeakObjectPtr<UFlowComponent>& Component : FoundComponents)
+		VisitComponents(Tag, bExactMatch, [&Result](UFlowComponent* Component)
 		{
-			if (Component.IsValid())
+			if (T* ComponentOfClass = Cast<T>(Component))
 			{
-				if (T* ComponentOfClass = Cast<T>(Component))
-				{
-					Result.Emplace(ComponentOfClass);
-				}
+				Result.Emplace(ComponentOfClass);
 			}
-		}
+			return true;
+		}, World);
 
 		return Result;
 	}
@@ -271,27 +481,23 @@ public:
 	 * @tparam T Only components matching this class we'll be returned
 	 * @param Tags Container to check if it matches Identity Tags of registered Flow Components
 	 * @param MatchType If Any, returned component needs to have only one of given tags. If All, component needs to have all given Identity Tags
-	 * @param bExactMatch If true, the tag has to be exactly present, if false then TagContainer will include it's parent tags while matching. Be careful, using latter option may be very expensive, as the search cost is proportional to the number of registered Gameplay Tags!
+	 * @param bExactMatch If true, the tag has to be exactly present, if false then TagContainer will include it's parent tags while matching
+	 * @param World World of registered components, if the subsystem is sharded by world. Game Instance world if not provided
 	 */
 	template <class T>
-	TSet<TWeakObjectPtr<T>> GetComponents(const FGameplayTagContainer& Tags, const EGameplayContainerMatchType MatchType, const bool bExactMatch = true) const
+	TSet<TWeakObjectPtr<T>> GetComponents(const FGameplayTagContainer& Tags, const EGameplayContainerMatchType MatchType, const bool bExactMatch = true, const UWorld* World = nullptr) const
 	{
 		static_assert(TPointerIsConvertibleFromTo<T, const UActorComponent>::Value, "'T' template parameter to GetComponents must be derived from UActorComponent");
 
-		TSet<TWeakObjectPtr<UFlowComponent>> FoundComponents;
-		FindComponents(Tags, MatchType, bExactMatch, FoundComponents);
-
 		TSet<TWeakObjectPtr<T>> Result;
-		for (const TWeakObjectPtr<UFlowComponent>& Component : FoundComponents)
+		VisitComponents(Tags, MatchType, bExactMatch, [&Result](UFlowComponent* Component)
 		{
-			if (Component.IsValid())
+			if (T* ComponentOfClass = Cast<T>(Component))
 			{
-				if (T* ComponentOfClass = Cast<T>(Component))
-				{
-					Result.Emplace(ComponentOfClass);
-				}
+				Result.Emplace(ComponentOfClass);
 			}
-		}
+			return true;
+		}, World);
 
 		return Result;
 	}
@@ -301,27 +507,23 @@ public:
 	 * 
 	 * @tparam T Only components matching this class we'll be returned
 	 * @param Tag Tag to check if it matches Identity Tags of registered Flow Components
-	 * @param bExactMatch If true, the tag has to be exactly present, if false then TagContainer will include it's parent tags while matching. Be careful, using latter option may be very expensive, as the search cost is proportional to the number of registered Gameplay Tags!
+	 * @param bExactMatch If true, the tag has to be exactly present, if false then TagContainer will include it's parent tags while matching
+	 * @param World World of registered components, if the subsystem is sharded by world. Game Instance world if not provided
 	 */
 	template <class T>
-	TSet<TWeakObjectPtr<T>> GetActors(const FGameplayTag& Tag, const bool bExactMatch = true) const
+	TSet<TWeakObjectPtr<T>> GetActors(const FGameplayTag& Tag, const bool bExactMatch = true, const UWorld* World = nullptr) const
 	{
 		static_assert(TPointerIsConvertibleFromTo<T, const AActor>::Value, "'T' template parameter to GetActors must be derived from AActor");
 
-		TArray<TWeakObjectPtr<UFlowComponent>> FoundComponents;
-		FindComponents(Tag, bExactMatch, FoundComponents);
-
 		TSet<TWeakObjectPtr<T>> Result;
-		for (const TWeakObjectPtr<UFlowComponent>& Component : FoundComponents)
+		VisitComponents(Tag, bExactMatch, [&Result](UFlowComponent* Component)
 		{
-			if (Component.IsValid())
+			if (T* ActorOfClass = Cast<T>(Component->GetOwner()))
 			{
-				if (T* ActorOfClass = Cast<T>(Component->GetOwner()))
-				{
-					Result.Emplace(ActorOfClass);
-				}
+				Result.Emplace(ActorOfClass);
 			}
-		}
+			return true;
+		}, World);
 
 		return Result;
 	}
@@ -332,27 +534,23 @@ public:
 	 * @tparam T Only actors matching this class we'll be returned
 	 * @param Tags Container to check if it matches Identity Tags of registered Flow Components
 	 * @param MatchType If Any, returned component needs to have only one of given tags. If All, component needs to have all given Identity Tags
-	 * @param bExactMatch If true, the tag has to be exactly present, if false then TagContainer will include it's parent tags while matching. Be careful, using latter option may be very expensive, as the search cost is proportional to the number of registered Gameplay Tags!
+	 * @param bExactMatch If true, the tag has to be exactly present, if false then TagContainer will include it's parent tags while matching
+	 * @param World World of registered components, if the subsystem is sharded by world. Game Instance world if not provided
 	 */
 	template <class T>
-	TSet<TWeakObjectPtr<T>> GetActors(const FGameplayTagContainer& Tags, const EGameplayContainerMatchType MatchType, const bool bExactMatch = true) const
+	TSet<TWeakObjectPtr<T>> GetActors(const FGameplayTagContainer& Tags, const EGameplayContainerMatchType MatchType, const bool bExactMatch = true, const UWorld* World = nullptr) const
 	{
 		static_assert(TPointerIsConvertibleFromTo<T, const AActor>::Value, "'T' template parameter to GetActors must be derived from AActor");
 
-		TSet<TWeakObjectPtr<UFlowComponent>> FoundComponents;
-		FindComponents(Tags, MatchType, bExactMatch, FoundComponents);
-
 		TSet<TWeakObjectPtr<T>> Result;
-		for (const TWeakObjectPtr<UFlowComponent>& Component : FoundComponents)
+		VisitComponents(Tags, MatchType, bExactMatch, [&Result](UFlowComponent* Component)
 		{
-			if (Component.IsValid())
+			if (T* ActorOfClass = Cast<T>(Component->GetOwner()))
 			{
-				if (T* ActorOfClass = Cast<T>(Component->GetOwner()))
-				{
-					Result.Emplace(ActorOfClass);
-				}
+				Result.Emplace(ActorOfClass);
 			}
-		}
+			return true;
+		}, World);
 
 		return Result;
 	}
@@ -363,30 +561,26 @@ public:
 	 * @tparam ActorT Only actors matching this class we'll be returned
 	 * @tparam ComponentT Only components matching this class we'll be returned
 	 * @param Tag Tag to check if it matches Identity Tags of registered Flow Components
-	 * @param bExactMatch If true, the tag has to be exactly present, if false then TagContainer will include it's parent tags while matching. Be careful, using latter option may be very expensive, as the search cost is proportional to the number of registered Gameplay Tags!
+	 * @param bExactMatch If true, the tag has to be exactly present, if false then TagContainer will include it's parent tags while matching
+	 * @param World World of registered components, if the subsystem is sharded by world. Game Instance world if not provided
 	 */
 	template <class ActorT, class ComponentT>
-	TMap<TWeakObjectPtr<ActorT>, TWeakObjectPtr<ComponentT>> GetActorsAndComponents(const FGameplayTag& Tag, const bool bExactMatch = true) const
+	TMap<TWeakObjectPtr<ActorT>, TWeakObjectPtr<ComponentT>> GetActorsAndComponents(const FGameplayTag& Tag, const bool bExactMatch = true, const UWorld* World = nullptr) const
 	{
 		static_assert(TPointerIsConvertibleFromTo<ActorT, const AActor>::Value, "'ActorT' template parameter to GetActorsAndComponents must be derived from AActor");
 		static_assert(TPointerIsConvertibleFromTo<ComponentT, const UActorComponent>::Value, "'ComponentT' template parameter to GetActorsAndComponents must be derived from UActorComponent");
 
-		TArray<TWeakObjectPtr<UFlowComponent>> FoundComponents;
-		FindComponents(Tag, bExactMatch, FoundComponents);
-
 		TMap<TWeakObjectPtr<ActorT>, TWeakObjectPtr<ComponentT>> Result;
-		for (const TWeakObjectPtr<UFlowComponent>& Component : FoundComponents)
+		VisitComponents(Tag, bExactMatch, [&Result](UFlowComponent* Component)
 		{
-			if (Component.IsValid())
+			ComponentT* ComponentOfClass = Cast<ComponentT>(Component);
+			ActorT* ActorOfClass = Cast<ActorT>(Component->GetOwner());
+			if (ComponentOfClass && ActorOfClass)
 			{
-				ComponentT* ComponentOfClass = Cast<ComponentT>(Component);
-				ActorT* ActorOfClass = Cast<ActorT>(Component->GetOwner());
-				if (ComponentOfClass && ActorOfClass)
-				{
-					Result.Emplace(ActorOfClass, ComponentOfClass);
-				}
+				Result.Emplace(ActorOfClass, ComponentOfClass);
 			}
-		}
+			return true;
+		}, World);
 
 		return Result;
 	}
@@ -398,35 +592,171 @@ public:
 	 * @tparam ComponentT Only components matching this class we'll be returned
 	 * @param Tags Container to check if it matches Identity Tags of registered Flow Components
 	 * @param MatchType If Any, returned component needs to have only one of given tags. If All, component needs to have all given Identity Tags
-	 * @param bExactMatch If true, the tag has to be exactly present, if false then TagContainer will include it's parent tags while matching. Be careful, using latter option may be very expensive, as the search cost is proportional to the number of registered Gameplay Tags!
+	 * @param bExactMatch If true, the tag has to be exactly present, if false then TagContainer will include it's parent tags while matching
+	 * @param World World of registered components, if the subsystem is sharded by world. Game Instance world if not provided
 	 */
 	template <class ActorT, class ComponentT>
-	TMap<TWeakObjectPtr<ActorT>, TWeakObjectPtr<ComponentT>> GetActorsAndComponents(const FGameplayTagContainer& Tags, const EGameplayContainerMatchType MatchType, const bool bExactMatch = true) const
+	TMap<TWeakObjectPtr<ActorT>, TWeakObjectPtr<ComponentT>> GetActorsAndComponents(const FGameplayTagContainer& Tags, const EGameplayContainerMatchType MatchType, const bool bExactMatch = true, const UWorld* World = nullptr) const
 	{
 		static_assert(TPointerIsConvertibleFromTo<ActorT, const AActor>::Value, "'ActorT' template parameter to GetActorsAndComponents must be derived from AActor");
 		static_assert(TPointerIsConvertibleFromTo<ComponentT, const UActorComponent>::Value, "'ComponentT' template parameter to GetActorsAndComponents must be derived from UActorComponent");
 
-		TSet<TWeakObjectPtr<UFlowComponent>> FoundComponents;
-		FindComponents(Tags, MatchType, bExactMatch, FoundComponents);
-
 		TMap<TWeakObjectPtr<ActorT>, TWeakObjectPtr<ComponentT>> Result;
-		for (const TWeakObjectPtr<UFlowComponent>& Component : FoundComponents)
+		VisitComponents(Tags, MatchType, bExactMatch, [&Result](UFlowComponent* Component)
 		{
-			if (Component.IsValid())
+			ComponentT* ComponentOfClass = Cast<ComponentT>(Component);
+			ActorT* ActorOfClass = Cast<ActorT>(Component->GetOwner());
+			if (ComponentOfClass && ActorOfClass)
 			{
-				ComponentT* ComponentOfClass = Cast<ComponentT>(Component);
-				ActorT* ActorOfClass = Cast<ActorT>(Component->GetOwner());
-				if (ComponentOfClass && ActorOfClass)
-				{
-					Result.Emplace(ActorOfClass, ComponentOfClass);
-				}
+				Result.Emplace(ActorOfClass, ComponentOfClass);
 			}
-		}
+			return true;
+		}, World);
 
 		return Result;
 	}
 
+	/**
+	 * Calls Visitor for every registered Flow Component identified by given tag, without allocating memory
+	 * Visitor can't register components or change their Identity Tags, use GetComponents with inline allocated array if it might
+	 * 
+	 * @tparam T Only components matching this class will be visited
+	 * @param Visitor Returns false to stop iteration
+	 * @return False if the visitor stopped iteration
+	 */
+	template <class T>
+	bool ForEachComponent(const FGameplayTag& Tag, TFunctionRef<bool(T*)> Visitor, const bool bExactMatch = true, const UWorld* World = nullptr) const
+	{
+		static_assert(TPointerIsConvertibleFromTo<T, const UActorComponent>::Value, "'T' template parameter to ForEachComponent must be derived from UActorComponent");
+
+		return VisitComponents(Tag, bExactMatch, [&Visitor](UFlowComponent* Component)
+		{
+			T* ComponentOfClass = Cast<T>(Component);
+			return ComponentOfClass == nullptr || Visitor(ComponentOfClass);
+		}, World);
+	}
+
+	/**
+	 * Calls Visitor for every registered Flow Component identified by Any or All provided tags, without allocating memory
+	 * Visitor can't register components or change their Identity Tags, use GetComponents with inline allocated array if it might
+	 * 
+	 * @tparam T Only components matching this class will be visited
+	 * @param Visitor Returns false to stop iteration
+	 * @return False if the visitor stopped iteration
+	 */
+	template <class T>
+	bool ForEachComponent(const FGameplayTagContainer& Tags, const EGameplayContainerMatchType MatchType, TFunctionRef<bool(T*)> Visitor, const bool bExactMatch = true, const UWorld* World = nullptr) const
+	{
+		static_assert(TPointerIsConvertibleFromTo<T, const UActorComponent>::Value, "'T' template parameter to ForEachComponent must be derived from UActorComponent");
+
+		return VisitComponents(Tags, MatchType, bExactMatch, [&Visitor](UFlowComponent* Component)
+		{
+			T* ComponentOfClass = Cast<T>(Component);
+			return ComponentOfClass == nullptr || Visitor(ComponentOfClass);
+		}, World);
+	}
+
+	/**
+	 * Calls Visitor for owner of every registered Flow Component identified by given tag, without allocating memory
+	 * Actor is visited once per its matching Flow Component
+	 * 
+	 * @tparam T Only actors matching this class will be visited
+	 * @param Visitor Returns false to stop iteration
+	 * @return False if the visitor stopped iteration
+	 */
+	template <class T>
+	bool ForEachActor(const FGameplayTag& Tag, TFunctionRef<bool(T*)> Visitor, const bool bExactMatch = true, const UWorld* World = nullptr) const
+	{
+		static_assert(TPointerIsConvertibleFromTo<T, const AActor>::Value, "'T' template parameter to ForEachActor must be derived from AActor");
+
+		return VisitComponents(Tag, bExactMatch, [&Visitor](UFlowComponent* Component)
+		{
+			T* ActorOfClass = Cast<T>(Component->GetOwner());
+			return ActorOfClass == nullptr || Visitor(ActorOfClass);
+		}, World);
+	}
+
+	/**
+	 * Calls Visitor for owner of every registered Flow Component identified by Any or All provided tags, without allocating memory
+	 * Actor is visited once per its matching Flow Component
+	 * 
+	 * @tparam T Only actors matching this class will be visited
+	 * @param Visitor Returns false to stop iteration
+	 * @return False if the visitor stopped iteration
+	 */
+	template <class T>
+	bool ForEachActor(const FGameplayTagContainer& Tags, const EGameplayContainerMatchType MatchType, TFunctionRef<bool(T*)> Visitor, const bool bExactMatch = true, const UWorld* World = nullptr) const
+	{
+		static_assert(TPointerIsConvertibleFromTo<T, const AActor>::Value, "'T' template parameter to ForEachActor must be derived from AActor");
+
+		return VisitComponents(Tags, MatchType, bExactMatch, [&Visitor](UFlowComponent* Component)
+		{
+			T* ActorOfClass = Cast<T>(Component->GetOwner());
+			return ActorOfClass == nullptr || Visitor(ActorOfClass);
+		}, World);
+	}
+
+	/**
+	 * Appends registered Flow Components identified by given tag to the array, i.e. TArray with TInlineAllocator doesn't touch the heap
+	 * Array is a snapshot of the registry, safe to iterate while components get registered or retagged
+	 */
+	template <class T, typename AllocatorType>
+	void GetComponents(const FGameplayTag& Tag, TArray<T*, AllocatorType>& OutComponents, const bool bExactMatch = true, const UWorld* World = nullptr) const
+	{
+		ForEachComponent<T>(Tag, [&OutComponents](T* Component)
+		{
+			OutComponents.Add(Component);
+			return true;
+		}, bExactMatch, World);
+	}
+
+	/**
+	 * Appends registered Flow Components identified by Any or All provided tags to the array, i.e. TArray with TInlineAllocator doesn't touch the heap
+	 * Array is a snapshot of the registry, safe to iterate while components get registered or retagged
+	 */
+	template <class T, typename AllocatorType>
+	void GetComponents(const FGameplayTagContainer& Tags, const EGameplayContainerMatchType MatchType, TArray<T*, AllocatorType>& OutComponents, const bool bExactMatch = true, const UWorld* World = nullptr) const
+	{
+		ForEachComponent<T>(Tags, MatchType, [&OutComponents](T* Component)
+		{
+			OutComponents.Add(Component);
+			return true;
+		}, bExactMatch, World);
+	}
+
+	/* Appends owners of registered Flow Components identified by given tag to the array, actor is added once per its matching Flow Component */
+	template <class T, typename AllocatorType>
+	void GetActors(const FGameplayTag& Tag, TArray<T*, AllocatorType>& OutActors, const bool bExactMatch = true, const UWorld* World = nullptr) const
+	{
+		ForEachActor<T>(Tag, [&OutActors](T* Actor)
+		{
+			OutActors.Add(Actor);
+			return true;
+		}, bExactMatch, World);
+	}
+
+	/* Appends owners of registered Flow Components identified by Any or All provided tags to the array, actor is added once per its matching Flow Component */
+	template <class T, typename AllocatorType>
+	void GetActors(const FGameplayTagContainer& Tags, const EGameplayContainerMatchType MatchType, TArray<T*, AllocatorType>& OutActors, const bool bExactMatch = true, const UWorld* World = nullptr) const
+	{
+		ForEachActor<T>(Tags, MatchType, [&OutActors](T* Actor)
+		{
+			OutActors.Add(Actor);
+			return true;
+		}, bExactMatch, World);
+	}
+
+	/* True if any Flow Component identified by given tag is registered, stops at the first one */
+	bool AnyComponentWithTag(const FGameplayTag& Tag, const bool bExactMatch = true, const UWorld* World = nullptr) const;
+
+	/* Number of registered Flow Components identified by given tag */
+	int32 CountComponentsWithTag(const FGameplayTag& Tag, const bool bExactMatch = true, const UWorld* World = nullptr) const;
+
+	/* Number of registry entries for given tag, read without visiting components
+	 * Entries of components pending destruction are included, so it's an upper bound of CountComponentsWithTag */
+	int32 GetBucketSize(const FGameplayTag& Tag, const bool bExactMatch = true, const UWorld* World = nullptr) const;
+
 private:
-	void FindComponents(const FGameplayTag& Tag, const bool bExactMatch, TArray<TWeakObjectPtr<UFlowComponent>>& OutComponents) const;
-	void FindComponents(const FGameplayTagContainer& Tags, const EGameplayContainerMatchType MatchType, const bool bExactMatch, TSet<TWeakObjectPtr<UFlowComponent>>& OutComponents) const;
+	bool VisitComponents(const FGameplayTag& Tag, const bool bExactMatch, TFunctionRef<bool(UFlowComponent*)> Visitor, const UWorld* World) const;
+	bool VisitComponents(const FGameplayTagContainer& Tags, const EGameplayContainerMatchType MatchType, const bool bExactMatch, TFunctionRef<bool(UFlowComponent*)> Visitor, const UWorld* World) const;
 };
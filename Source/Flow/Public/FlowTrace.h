@@ -0,0 +1,87 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Trace/Trace.h"
+
+#define FLOW_TRACE_ENABLED (UE_TRACE_ENABLED && !UE_BUILD_SHIPPING)
+
+class UFlowAsset;
+class UFlowNode;
+
+#if FLOW_TRACE_ENABLED
+
+UE_TRACE_CHANNEL_EXTERN(FlowChannel, FLOW_API);
+
+enum class EFlowTraceSpan : uint8
+{
+	SaveGame,
+	LoadGame
+};
+
+/**
+ * Unreal Insights events of Flow execution, recorded only while FlowChannel is enabled, i.e. "-trace=default,flow"
+ * Nodes are identified by their guid, pins by name, and every event by the id of the asset instance it belongs to
+ */
+struct FLOW_API FFlowTrace
+{
+	static void OutputInstanceCreated(const UFlowAsset& Instance);
+	static void OutputInstanceFinished(const UFlowAsset& Instance);
+
+	static void OutputNodeActivated(const UFlowNode& Node);
+	static void OutputNodeFinished(const UFlowNode& Node);
+	static void OutputPinTriggered(const UFlowNode& Node, const FName& PinName, const bool bOutput);
+
+	static void OutputSpanBegin(const EFlowTraceSpan Span);
+	static void OutputSpanEnd(const EFlowTraceSpan Span);
+};
+
+struct FFlowTraceSpanScope
+{
+	explicit FFlowTraceSpanScope(const EFlowTraceSpan InSpan)
+		: Span(InSpan)
+		, bTraced(UE_TRACE_CHANNELEXPR_IS_ENABLED(FlowChannel))
+	{
+		if (bTraced)
+		{
+			FFlowTrace::OutputSpanBegin(Span);
+		}
+	}
+
+	~FFlowTraceSpanScope()
+	{
+		if (bTraced)
+		{
+			FFlowTrace::OutputSpanEnd(Span);
+		}
+	}
+
+private:
+	EFlowTraceSpan Span;
+	bool bTraced;
+};
+
+#define FLOW_TRACE_EVENT(Call) \
+	if (UE_TRACE_CHANNELEXPR_IS_ENABLED(FlowChannel)) \
+	{ \
+		FFlowTrace::Call; \
+	}
+
+#define TRACE_FLOW_INSTANCE_CREATED(Instance) FLOW_TRACE_EVENT(OutputInstanceCreated(Instance))
+#define TRACE_FLOW_INSTANCE_FINISHED(Instance) FLOW_TRACE_EVENT(OutputInstanceFinished(Instance))
+#define TRACE_FLOW_NODE_ACTIVATED(Node) FLOW_TRACE_EVENT(OutputNodeActivated(Node))
+#define TRACE_FLOW_NODE_FINISHED(Node) FLOW_TRACE_EVENT(OutputNodeFinished(Node))
+#define TRACE_FLOW_PIN_TRIGGERED(Node, PinName, bOutput) FLOW_TRACE_EVENT(OutputPinTriggered(Node, PinName, bOutput))
+#define TRACE_FLOW_SPAN_SCOPE(Span) FFlowTraceSpanScope ANONYMOUS_VARIABLE(FlowTraceSpan)(EFlowTraceSpan::Span)
+
+#else
+
+#define TRACE_FLOW_INSTANCE_CREATED(Instance)
+#define TRACE_FLOW_INSTANCE_FINISHED(Instance)
+#define TRACE_FLOW_NODE_ACTIVATED(Node)
+#define TRACE_FLOW_NODE_FINISHED(Node)
+#define TRACE_FLOW_PIN_TRIGGERED(Node, PinName, bOutput)
+#define TRACE_FLOW_SPAN_SCOPE(Span)
+
+#endif
@@ -56,6 +56,22 @@ enum class EFlowNetMode : uint8
 	SinglePlayerOnly	UMETA(ToolTip = "Executed only in the single player, not available in multiplayer.")
 };
 
+UENUM(BlueprintType)
+enum class EFlowSharedInstanceScope : uint8
+{
+	None				UMETA(ToolTip = "Every SubGraph node creates its own instance."),
+	Subsystem			UMETA(ToolTip = "Single instance for all SubGraph nodes, owned by the Game Instance."),
+	World				UMETA(ToolTip = "Single instance per world, owned by the world of Root Flow owner."),
+	RootOwner			UMETA(ToolTip = "Single instance per Root Flow owner, i.e. shared by all graphs running on the same actor.")
+};
+
+UENUM(BlueprintType)
+enum class EFlowStreamOutPolicy : uint8
+{
+	SaveAndRelease		UMETA(ToolTip = "Flow state is saved and the instance is released. Flow continues from the saved state once the content is visible again."),
+	Abort				UMETA(ToolTip = "Flow is aborted. It starts from scratch once the content is visible again.")
+};
+
 UENUM(BlueprintType)
 enum class EFlowTagContainerMatchType : uint8
 {
@@ -2,10 +2,40 @@
 
 #pragma once
 
+#include "Engine/StreamableManager.h"
 #include "GameFramework/WorldSettings.h"
+
+#include "FlowTypes.h"
 #include "FlowWorldSettings.generated.h"
 
+class UDataLayerAsset;
+class UFlowAsset;
 class UFlowComponent;
+class UFlowSaveGame;
+
+/**
+ * Flow Asset running only while the given streaming level or Data Layer content is visible
+ */
+USTRUCT(BlueprintType)
+struct FLOW_API FFlowStreamingRootFlow
+{
+	GENERATED_BODY()
+
+	// Streaming level, Flow starts once it becomes visible
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Flow")
+	TSoftObjectPtr<UWorld> Level;
+
+	// World Partition Data Layer, Flow starts once any of its cells becomes visible and finishes after the last one is hidden
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Flow")
+	TSoftObjectPtr<UDataLayerAsset> DataLayer;
+
+	// Loaded asynchronously, only while the content is visible
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Flow")
+	TSoftObjectPtr<UFlowAsset> FlowAsset;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Flow")
+	EFlowStreamOutPolicy StreamOutPolicy = EFlowStreamOutPolicy::SaveAndRelease;
+};
 
 /**
  * World Settings used to start a Flow for this world
@@ -19,11 +49,57 @@ private:
 	UPROPERTY(BlueprintReadOnly, VisibleAnywhere, Category = "Flow", meta = (AllowPrivateAccess = "true"))
 	UFlowComponent* FlowComponent;
 
+	// Root Flows tied to visibility of streaming levels and Data Layers, owned by this actor
+	// CPU and memory used by these flows scales with the loaded content
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Flow", meta = (AllowPrivateAccess = "true"))
+	TArray<FFlowStreamingRootFlow> StreamingRootFlows;
+
 public:
 	UFlowComponent* GetFlowComponent() const { return FlowComponent; }
 
 	virtual void PostInitializeComponents() override;
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 private:
 	bool IsValidInstance() const;
+
+//////////////////////////////////////////////////////////////////////////
+// Streaming Root Flows
+
+	struct FStreamingRootFlowState
+	{
+		// Visible levels matching the entry, more than one for Data Layer split into World Partition cells
+		int32 VisibleLevels = 0;
+
+		TSharedPtr<FStreamableHandle> LoadHandle;
+
+		// Entries might share the Flow Asset, so every entry tracks its own instance
+		TWeakObjectPtr<UFlowAsset> Instance;
+
+		// Stable between game sessions, so the instance is found in the SaveGame
+		FString InstanceName;
+		bool bReleased = false;
+
+		// SaveGame the instance has been loaded from already, later streaming in restores the released instance or starts a new one
+		TWeakObjectPtr<UFlowSaveGame> LoadedSaveGame;
+	};
+
+	// Runtime state of every StreamingRootFlows entry
+	TArray<FStreamingRootFlowState> StreamingStates;
+
+	FStreamableManager StreamableManager;
+
+	FDelegateHandle LevelAddedHandle;
+	FDelegateHandle LevelRemovedHandle;
+
+	void OnLevelAddedToWorld(ULevel* Level, UWorld* World);
+	void OnLevelRemovedFromWorld(ULevel* Level, UWorld* World);
+
+	bool IsLevelOfEntry(const ULevel* Level, const FFlowStreamingRootFlow& Entry) const;
+	FString GetStreamingInstanceName(const int32 Index) const;
+
+	void StartStreamingRootFlow(const int32 Index);
+	void OnStreamingRootFlowLoaded(const int32 Index);
+	void StopStreamingRootFlow(const int32 Index);
 };
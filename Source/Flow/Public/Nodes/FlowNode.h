@@ -8,11 +8,14 @@
 #include "VisualLogger/VisualLoggerDebugSnapshotInterface.h"
 
 #include "FlowMessageLog.h"
+#include "FlowParameter.h"
 #include "FlowTypes.h"
 #include "Nodes/FlowPin.h"
 #include "FlowNode.generated.h"
 
+class FTimerManager;
 class UFlowAsset;
+enum class EFlowRecordedEventType : uint8;
 class UFlowSubsystem;
 class IFlowOwnerInterface;
 
@@ -20,6 +23,24 @@ class IFlowOwnerInterface;
 DECLARE_DELEGATE(FFlowNodeEvent);
 #endif
 
+// Blueprint events called on every node instance, flagged if the node class implements them
+enum class EFlowNodeK2Events : uint16
+{
+	None = 0,
+	InitializeInstance = 1 << 0,
+	DeinitializeInstance = 1 << 1,
+	PreloadContent = 1 << 2,
+	FlushContent = 1 << 3,
+	OnActivate = 1 << 4,
+	ExecuteInput = 1 << 5,
+	Cleanup = 1 << 6,
+	ForceFinishNode = 1 << 7,
+
+	// Flags above were already resolved for the class
+	Resolved = 1 << 15
+};
+ENUM_CLASS_FLAGS(EFlowNodeK2Events)
+
 /**
  * A Flow Node is UObject-based node designed to handle entire gameplay feature within single node.
  */
@@ -117,6 +138,21 @@ protected:
 	UPROPERTY()
 	FGuid NodeGuid;
 
+private:
+	// Index in the cooked graph of the asset instance, INDEX_NONE if asset wasn't cooked
+	int32 CookedGraphIndex;
+
+public:
+	int32 GetCookedGraphIndex() const { return CookedGraphIndex; }
+
+protected:
+	// Properties of this node receiving values of Flow Asset parameters, so asset variants don't need to duplicate the graph
+	UPROPERTY(EditAnywhere, Category = "FlowNode")
+	TArray<FFlowParameterBinding> ParameterBindings;
+
+public:
+	const TArray<FFlowParameterBinding>& GetParameterBindings() const { return ParameterBindings; }
+
 public:
 	void SetGuid(const FGuid NewGuid) { NodeGuid = NewGuid; }
 	FGuid GetGuid() const { return NodeGuid; }
@@ -135,6 +171,7 @@ public:
 protected:
 
 	// Helper functions for GetFlowOwnerInterface()
+	IFlowOwnerInterface* FindFlowOwnerInterface(const UFlowAsset& FlowAsset, UObject& RootFlowOwner) const;
 	IFlowOwnerInterface* TryGetFlowOwnerInterfaceFromRootFlowOwner(UObject& RootFlowOwner, const UClass& ExpectedOwnerClass) const;
 	IFlowOwnerInterface* TryGetFlowOwnerInterfaceActor(UObject& RootFlowOwner, const UClass& ExpectedOwnerClass) const;
 
@@ -265,14 +302,48 @@ public:
 private:
 	TMap<FName, TArray<FPinRecord>> InputRecords;
 	TMap<FName, TArray<FPinRecord>> OutputRecords;
+
+	FFlowNodeExecutionStats ExecutionStats;
+
+	// Pins of shared instance nodes aren't recorded, as these nodes keep executing until the world ends
+	bool ShouldRecordPins() const;
+
+public:
+	const FFlowNodeExecutionStats& GetExecutionStats() const { return ExecutionStats; }
+
+	const TMap<FName, TArray<FPinRecord>>& GetInputRecords() const { return InputRecords; }
+	const TMap<FName, TArray<FPinRecord>>& GetOutputRecords() const { return OutputRecords; }
 #endif
 
+private:
+	// Context of the node instance, resolved once the instance is created, so hot accessors don't walk outers on every call
+	TWeakObjectPtr<UFlowSubsystem> CachedFlowSubsystem;
+
+	// Resolved again if the world is torn down, i.e. Root Flow owned by Game Instance survives the level travel
+	mutable TWeakObjectPtr<UWorld> CachedWorld;
+
+	// Interface is valid as long as the Root Flow owner it was resolved for
+	mutable TWeakObjectPtr<UObject> CachedFlowOwner;
+	mutable IFlowOwnerInterface* CachedFlowOwnerInterface;
+
+	void CacheContext();
+
 public:
 	UFUNCTION(BlueprintPure, Category = "FlowNode")
 	UFlowSubsystem* GetFlowSubsystem() const;
 
 	virtual UWorld* GetWorld() const override;
 
+	// Timer manager for node delays, follows virtual time of Flow Subsystem if enabled
+	FTimerManager* GetFlowTimerManager() const;
+
+	// Captures event of this node while Flow Subsystem is recording, so the replay can verify it happened at the same time
+	void RecordEvent(const EFlowRecordedEventType Type, const FName& Name) const;
+
+	// UObject
+	virtual void GetResourceSizeEx(FResourceSizeEx& CumulativeResourceSize) override;
+	// --
+
 protected:
 	// Method called just after creating the node instance, while initializing the Flow Asset instance
 	// This happens before executing graph, only called during gameplay
@@ -322,6 +393,12 @@ protected:
 	void TriggerOutput(const FString& PinName, const bool bFinish = false);
 	void TriggerOutput(const FText& PinName, const bool bFinish = false);
 	void TriggerOutput(const TCHAR* PinName, const bool bFinish = false);
+	void TriggerOutput(const FFlowNativePin& Pin, const bool bFinish = false, const EFlowPinActivationType ActivationType = EFlowPinActivationType::Default);
+
+private:
+	void TriggerOutputByIndex(const int32 PinIndex, const FName& PinName, const bool bFinish, const EFlowPinActivationType ActivationType);
+
+protected:
 
 	UFUNCTION(BlueprintCallable, Category = "FlowNode", meta = (HidePin = "ActivationType"))
 	void TriggerOutputPin(const FFlowOutputPinHandle Pin, const bool bFinish = false, const EFlowPinActivationType ActivationType = EFlowPinActivationType::Default);
@@ -360,6 +437,12 @@ protected:
 private:
 	void ResetRecords();
 
+	// Blueprint events implemented by the node class, resolved once on the class default object
+	// Calling an event without Blueprint implementation still goes through ProcessEvent, so these calls are skipped
+	mutable EFlowNodeK2Events ImplementedK2Events;
+
+	bool IsK2EventImplemented(const EFlowNodeK2Events Event) const;
+
 //////////////////////////////////////////////////////////////////////////
 // SaveGame support
 
@@ -13,12 +13,14 @@ struct FLOW_API FFlowPin
 	UPROPERTY(EditDefaultsOnly, Category = "FlowPin")
 	FName PinName;
 
+#if WITH_EDITORONLY_DATA
 	// An optional Display Name, you can use it to override PinName without the need to update graph connections
 	UPROPERTY(EditDefaultsOnly, Category = "FlowPin")
 	FText PinFriendlyName;
 
 	UPROPERTY(EditDefaultsOnly, Category = "FlowPin")
 	FString PinToolTip;
+#endif
 
 	static inline FName AnyPinName = TEXT("AnyPinName");
 
@@ -57,23 +59,30 @@ struct FLOW_API FFlowPin
 	{
 	}
 
+	// Display text isn't needed by cooked game
 	FFlowPin(const FStringView InPinName, const FText& InPinFriendlyName)
 		: PinName(InPinName)
-		, PinFriendlyName(InPinFriendlyName)
 	{
+#if WITH_EDITORONLY_DATA
+		PinFriendlyName = InPinFriendlyName;
+#endif
 	}
 
 	FFlowPin(const FStringView InPinName, const FString& InPinTooltip)
 		: PinName(InPinName)
-		, PinToolTip(InPinTooltip)
 	{
+#if WITH_EDITORONLY_DATA
+		PinToolTip = InPinTooltip;
+#endif
 	}
 
 	FFlowPin(const FStringView InPinName, const FText& InPinFriendlyName, const FString& InPinTooltip)
 		: PinName(InPinName)
-		, PinFriendlyName(InPinFriendlyName)
-		, PinToolTip(InPinTooltip)
 	{
+#if WITH_EDITORONLY_DATA
+		PinFriendlyName = InPinFriendlyName;
+		PinToolTip = InPinTooltip;
+#endif
 	}
 
 	FORCEINLINE bool IsValid() const
@@ -107,6 +116,55 @@ struct FLOW_API FFlowPin
 	}
 };
 
+/**
+ * Pin declared by native node class as a static member, so its name is created once instead of on every comparison or trigger
+ * Compare it with PinName in ExecuteInput and pass it to TriggerOutput, which finds the pin by index hint instead of scanning pins
+ */
+struct FLOW_API FFlowNativePin
+{
+	const FName PinName;
+
+	explicit FFlowNativePin(const TCHAR* InPinName)
+		: PinName(InPinName)
+		, IndexHint(INDEX_NONE)
+	{
+	}
+
+	operator FFlowPin() const
+	{
+		return FFlowPin(PinName);
+	}
+
+	// Display text isn't needed by cooked game
+	FFlowPin ToPin(const FString& InPinTooltip) const
+	{
+		return FFlowPin(PinName.ToString(), InPinTooltip);
+	}
+
+	// Index of this pin in given pins, hint is verified since subclasses might declare pins in a different order
+	int32 FindIndex(const TArray<FFlowPin>& Pins) const
+	{
+		if (!Pins.IsValidIndex(IndexHint) || Pins[IndexHint].PinName != PinName)
+		{
+			IndexHint = Pins.IndexOfByKey(PinName);
+		}
+		return IndexHint;
+	}
+
+	FORCEINLINE friend bool operator==(const FName& Name, const FFlowNativePin& Pin)
+	{
+		return Name == Pin.PinName;
+	}
+
+	FORCEINLINE friend bool operator!=(const FName& Name, const FFlowNativePin& Pin)
+	{
+		return Name != Pin.PinName;
+	}
+
+private:
+	mutable int32 IndexHint;
+};
+
 USTRUCT()
 struct FLOW_API FFlowPinHandle
 {
@@ -209,6 +267,36 @@ struct FLOW_API FPinRecord
 private:
 	FORCEINLINE static FString DoubleDigit(const int32 Number);
 };
+
+// Execution statistics of the node instance, displayed as heatmap in the graph editor
+struct FLOW_API FFlowNodeExecutionStats
+{
+	// How many times node became active
+	int32 Activations = 0;
+
+	// How many inputs were executed
+	int32 Executions = 0;
+
+	// Seconds spent in ExecuteInput, including nodes triggered synchronously by it
+	double ExecuteTime = 0.0;
+	double MaxExecuteTime = 0.0;
+
+	// Seconds spent in the active state, not including the current activation
+	double ActiveTime = 0.0;
+
+	// Platform time of the current activation, negative while node isn't active
+	double ActivationStartTime = -1.0;
+
+	void OnActivated();
+	void OnExecuted(const double Seconds);
+	void OnDeactivated();
+
+	// Includes the time of the current activation
+	double GetActiveTime() const;
+
+	// Sums stats of multiple instances of the same node
+	void Append(const FFlowNodeExecutionStats& Other);
+};
 #endif
 
 // It can represent any trait added on the specific node instance, i.e. breakpoint
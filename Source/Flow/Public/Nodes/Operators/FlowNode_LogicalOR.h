@@ -14,6 +14,10 @@ class FLOW_API UFlowNode_LogicalOR final : public UFlowNode
 {
 	GENERATED_UCLASS_BODY()
 
+public:
+	static const FFlowNativePin EnablePin;
+	static const FFlowNativePin DisablePin;
+
 protected:
 	UPROPERTY(EditAnywhere, Category = "Lifetime", SaveGame)
 	bool bEnabled;
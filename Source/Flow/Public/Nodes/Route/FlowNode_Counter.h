@@ -13,6 +13,15 @@ class FLOW_API UFlowNode_Counter final : public UFlowNode
 {
 	GENERATED_UCLASS_BODY()
 
+public:
+	static const FFlowNativePin IncrementPin;
+	static const FFlowNativePin DecrementPin;
+	static const FFlowNativePin SkipPin;
+	static const FFlowNativePin ZeroPin;
+	static const FFlowNativePin StepPin;
+	static const FFlowNativePin GoalPin;
+	static const FFlowNativePin SkippedPin;
+
 protected:
 	UPROPERTY(EditAnywhere, Category = "Counter", meta = (ClampMin = 2))
 	int32 Goal;
@@ -13,6 +13,9 @@ class FLOW_API UFlowNode_ExecutionMultiGate final : public UFlowNode
 {
 	GENERATED_UCLASS_BODY()
 
+public:
+	static const FFlowNativePin ResetPin;
+
 	UPROPERTY(EditAnywhere, Category = "MultiGate")
 	bool bRandom;
 
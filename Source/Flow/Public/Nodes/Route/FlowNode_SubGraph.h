@@ -17,13 +17,17 @@ class FLOW_API UFlowNode_SubGraph : public UFlowNode
 	friend class FFlowNode_SubGraphDetails;
 	friend class UFlowSubsystem;
 
-	static FFlowPin StartPin;
-	static FFlowPin FinishPin;
+	static const FFlowNativePin StartPin;
+	static const FFlowNativePin FinishPin;
 	
 private:
 	UPROPERTY(EditAnywhere, Category = "Graph")
 	TSoftObjectPtr<UFlowAsset> Asset;
 
+	// Overrides of parameters declared by the Asset, so the same graph can be reused with different values
+	UPROPERTY(EditAnywhere, Category = "Graph")
+	TArray<FFlowParameter> Parameters;
+
 	/*
 	 * Allow to create instance of the same Flow Asset as the asset containing this node
 	 * Enabling it may cause an infinite loop, if graph would keep creating copies of itself
@@ -14,6 +14,13 @@ class FLOW_API UFlowNode_Timer : public UFlowNode
 {
 	GENERATED_UCLASS_BODY()
 
+public:
+	static const FFlowNativePin SkipPin;
+	static const FFlowNativePin RestartPin;
+	static const FFlowNativePin CompletedPin;
+	static const FFlowNativePin StepPin;
+	static const FFlowNativePin SkippedPin;
+
 protected:
 	// If the value is closer to 0, Timer will complete in next tick
 	UPROPERTY(EditAnywhere, Category = "Timer", meta = (ClampMin = 0.0f))
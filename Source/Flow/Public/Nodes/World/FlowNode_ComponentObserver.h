@@ -17,6 +17,14 @@ UCLASS(Abstract, NotBlueprintable)
 class FLOW_API UFlowNode_ComponentObserver : public UFlowNode
 {
 	GENERATED_UCLASS_BODY()
+
+public:
+	static const FFlowNativePin StartPin;
+	static const FFlowNativePin StopPin;
+	static const FFlowNativePin SuccessPin;
+	static const FFlowNativePin CompletedPin;
+	static const FFlowNativePin StoppedPin;
+
 	
 	friend class FFlowNode_ComponentObserverDetails;
 
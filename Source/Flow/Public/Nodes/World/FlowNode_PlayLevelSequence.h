@@ -28,6 +28,15 @@ class FLOW_API UFlowNode_PlayLevelSequence : public UFlowNode
 	friend struct FFlowTrackExecutionToken;
 
 public:	
+	static const FFlowNativePin StartPin;
+	static const FFlowNativePin PausePin;
+	static const FFlowNativePin ResumePin;
+	static const FFlowNativePin StopPin;
+	static const FFlowNativePin PreStartPin;
+	static const FFlowNativePin StartedPin;
+	static const FFlowNativePin CompletedPin;
+	static const FFlowNativePin StoppedPin;
+
 	static FFlowNodeLevelSequenceEvent OnPlaybackStarted;
 	static FFlowNodeLevelSequenceEvent OnPlaybackCompleted;
 
@@ -0,0 +1,160 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "Commandlets/FlowNativizeCommandlet.h"
+#include "FlowEditorModule.h"
+
+#include "FlowAsset.h"
+
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+UFlowNativizeCommandlet::UFlowNativizeCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UFlowNativizeCommandlet::Main(const FString& Params)
+{
+	FString OutputDirectory;
+	if (!FParse::Value(*Params, TEXT("Output="), OutputDirectory))
+	{
+		UE_LOG(LogFlowEditor, Error, TEXT("FlowNativize: missing -Output=<Directory> parameter"));
+		return 1;
+	}
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	AssetRegistry.SearchAllAssets(true);
+
+	FARFilter Filter;
+	Filter.ClassPaths.Add(UFlowAsset::StaticClass()->GetClassPathName());
+	Filter.bRecursiveClasses = true;
+	Filter.TagsAndValues.Add(GET_MEMBER_NAME_CHECKED(UFlowAsset, bGenerateNativeCode), FString(TEXT("True")));
+
+	TArray<FAssetData> FoundAssets;
+	AssetRegistry.GetAssets(Filter, FoundAssets);
+
+	int32 GeneratedFiles = 0;
+	TSet<FString> GeneratedNames;
+	for (const FAssetData& AssetData : FoundAssets)
+	{
+		UFlowAsset* FlowAsset = Cast<UFlowAsset>(AssetData.GetAsset());
+		if (FlowAsset == nullptr)
+		{
+			continue;
+		}
+
+		// generated code has to match the topology of cooked asset, including inlined SubGraphs
+		FlowAsset->BuildCookedData();
+
+		if (FlowAsset->GetCookedGraph().IsValid())
+		{
+			// package path keeps names unique between folders, i.e. /Game/Quests/Intro becomes FlowNative_Game_Quests_Intro
+			FString GeneratedName = FlowAsset->GetPackage()->GetName();
+			GeneratedName.RemoveFromStart(TEXT("/"));
+			for (TCHAR& Character : GeneratedName)
+			{
+				if (!FChar::IsAlnum(Character))
+				{
+					Character = TEXT('_');
+				}
+			}
+			GeneratedName = TEXT("FlowNative_") + GeneratedName;
+
+			// sanitizing might still map different paths to the same name, i.e. /Game/A_B and /Game/A/B
+			if (GeneratedNames.Contains(GeneratedName))
+			{
+				UE_LOG(LogFlowEditor, Error, TEXT("FlowNativize: %s would overwrite code generated as %s, rename its package"), *FlowAsset->GetPathName(), *GeneratedName);
+				FlowAsset->ClearCookedData();
+				continue;
+			}
+			GeneratedNames.Add(GeneratedName);
+
+			const FString FilePath = FPaths::Combine(OutputDirectory, GeneratedName + TEXT(".cpp"));
+			if (FFileHelper::SaveStringToFile(GenerateCode(FlowAsset, GeneratedName), *FilePath))
+			{
+				UE_LOG(LogFlowEditor, Display, TEXT("FlowNativize: generated %s from %s"), *FilePath, *FlowAsset->GetPathName());
+				GeneratedFiles++;
+			}
+			else
+			{
+				UE_LOG(LogFlowEditor, Error, TEXT("FlowNativize: failed to write %s"), *FilePath);
+			}
+		}
+		else
+		{
+			UE_LOG(LogFlowEditor, Warning, TEXT("FlowNativize: %s doesn't contain any nodes"), *FlowAsset->GetPathName());
+		}
+
+		FlowAsset->ClearCookedData();
+	}
+
+	UE_LOG(LogFlowEditor, Display, TEXT("FlowNativize: generated %d of %d marked Flow Assets"), GeneratedFiles, FoundAssets.Num());
+	return GeneratedFiles == FoundAssets.Num() ? 0 : 1;
+}
+
+FString UFlowNativizeCommandlet::GenerateCode(const UFlowAsset* FlowAsset, const FString& GeneratedName)
+{
+	const FFlowCookedGraph& Graph = FlowAsset->GetCookedGraph();
+
+	// every pin name becomes a static FName, so dispatch compares only name indices
+	TArray<FName> PinNames;
+	for (const FFlowCookedGraph::FOutput& Output : Graph.Outputs)
+	{
+		PinNames.AddUnique(Output.PinName);
+		PinNames.AddUnique(Output.InputPinName);
+	}
+
+	FString Code;
+	Code += TEXT("// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors\n\n");
+	Code += FString::Printf(TEXT("// Generated by FlowNativize commandlet from %s, don't modify it manually\n\n"), *FlowAsset->GetPathName());
+	Code += TEXT("#include \"FlowAsset.h\"\n");
+	Code += TEXT("#include \"FlowNativeGraph.h\"\n\n");
+
+	Code += FString::Printf(TEXT("namespace %s\n{\n"), *GeneratedName);
+	Code += TEXT("\tclass FNativeGraph final : public IFlowNativeGraph\n\t{\n\tpublic:\n");
+	Code += TEXT("\t\tvirtual bool TriggerOutput(UFlowAsset& Instance, const int32 NodeIndex, const FName& PinName) const override\n\t\t{\n");
+
+	if (PinNames.Num() > 0)
+	{
+		Code += TEXT("\t\t\tstatic const FName Pins[] =\n\t\t\t{\n");
+		for (const FName& PinName : PinNames)
+		{
+			Code += FString::Printf(TEXT("\t\t\t\tFName(TEXT(\"%s\")),\n"), *PinName.ToString().ReplaceCharWithEscapedChar());
+		}
+		Code += TEXT("\t\t\t};\n\n");
+	}
+
+	Code += TEXT("\t\t\tswitch (NodeIndex)\n\t\t\t{\n");
+	for (int32 NodeIndex = 0; NodeIndex < Graph.NodeGuids.Num(); NodeIndex++)
+	{
+		const TArrayView<const FFlowCookedGraph::FOutput> Outputs = Graph.GetOutputs(NodeIndex);
+		if (Outputs.Num() == 0)
+		{
+			continue;
+		}
+
+		Code += FString::Printf(TEXT("\t\t\t\tcase %d: // %s\n"), NodeIndex, *Graph.NodeGuids[NodeIndex].ToString());
+		for (const FFlowCookedGraph::FOutput& Output : Outputs)
+		{
+			if (Output.NodeIndex != INDEX_NONE)
+			{
+				Code += FString::Printf(TEXT("\t\t\t\t\tif (PinName == Pins[%d])\n\t\t\t\t\t{\n"), PinNames.IndexOfByKey(Output.PinName));
+				Code += FString::Printf(TEXT("\t\t\t\t\t\tInstance.TriggerInputByIndex(%d, Pins[%d]);\n"), Output.NodeIndex, PinNames.IndexOfByKey(Output.InputPinName));
+				Code += TEXT("\t\t\t\t\t\treturn true;\n\t\t\t\t\t}\n");
+			}
+		}
+		Code += TEXT("\t\t\t\t\treturn false;\n");
+	}
+	Code += TEXT("\t\t\t\tdefault:\n\t\t\t\t\treturn false;\n\t\t\t}\n");
+	Code += TEXT("\t\t}\n\t};\n\n");
+
+	Code += TEXT("\tstatic const FNativeGraph NativeGraph{};\n");
+	Code += FString::Printf(TEXT("\tstatic const FFlowNativeGraphRegistrar Registrar(TEXT(\"%s\"), TEXT(\"%s\"), &NativeGraph);\n"), *FlowAsset->GetPackage()->GetName(), *Graph.Hash.ToString());
+	Code += TEXT("}\n");
+
+	return Code;
+}
@@ -1,6 +1,7 @@
 // Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
 
 #include "Graph/FlowGraph.h"
+#include "Graph/FlowGraphEditorSettings.h"
 #include "Graph/FlowGraphSchema.h"
 #include "Graph/FlowGraphSchema_Actions.h"
 #include "Graph/Nodes/FlowGraphNode.h"
@@ -81,3 +82,54 @@ UFlowAsset* UFlowGraph::GetFlowAsset() const
 {
 	return GetTypedOuter<UFlowAsset>();
 }
+
+float UFlowGraph::GetExecutionHeat(const UFlowGraphNode* GraphNode) const
+{
+	if (ExecutionMetricsFrame != GFrameCounter)
+	{
+		ExecutionMetricsFrame = GFrameCounter;
+		UpdateExecutionMetrics();
+	}
+
+	const double* Metric = ExecutionMetrics.Find(GraphNode);
+	if (Metric == nullptr)
+	{
+		return -1.0f;
+	}
+
+	return MaxExecutionMetric > 0.0 ? static_cast<float>(*Metric / MaxExecutionMetric) : 0.0f;
+}
+
+void UFlowGraph::UpdateExecutionMetrics() const
+{
+	const EFlowHeatmapMetric HeatmapMetric = UFlowGraphEditorSettings::Get()->HeatmapMetric;
+
+	ExecutionMetrics.Reset();
+	MaxExecutionMetric = 0.0;
+
+	for (const UEdGraphNode* Node : Nodes)
+	{
+		FFlowNodeExecutionStats Stats;
+		const UFlowGraphNode* GraphNode = Cast<UFlowGraphNode>(Node);
+		if (GraphNode && GraphNode->GetExecutionStats(Stats))
+		{
+			double Metric = 0.0;
+			switch (HeatmapMetric)
+			{
+				case EFlowHeatmapMetric::Activations:
+					Metric = Stats.Activations;
+					break;
+				case EFlowHeatmapMetric::ExecuteTime:
+					Metric = Stats.ExecuteTime;
+					break;
+				case EFlowHeatmapMetric::ActiveTime:
+					Metric = Stats.GetActiveTime();
+					break;
+				default: ;
+			}
+
+			ExecutionMetrics.Add(GraphNode, Metric);
+			MaxExecutionMetric = FMath::Max(MaxExecutionMetric, Metric);
+		}
+	}
+}
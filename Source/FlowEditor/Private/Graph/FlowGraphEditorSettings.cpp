@@ -13,5 +13,9 @@ UFlowGraphEditorSettings::UFlowGraphEditorSettings(const FObjectInitializer& Obj
 	, SubGraphPreviewSize(FVector2D(640.f, 360.f))
 	, bHighlightInputWiresOfSelectedNodes(true)
 	, bHighlightOutputWiresOfSelectedNodes(false)
+	, HeatmapMode(EFlowHeatmapMode::Disabled)
+	, HeatmapMetric(EFlowHeatmapMetric::ExecuteTime)
+	, HeatmapColdColor(FLinearColor(0.0f, 0.3f, 1.0f, 1.0f))
+	, HeatmapHotColor(FLinearColor(1.0f, 0.05f, 0.0f, 1.0f))
 {
 }
@@ -641,6 +641,51 @@ FLinearColor UFlowGraphNode::GetStatusBackgroundColor() const
 	return UFlowGraphSettings::Get()->NodeStatusBackground;
 }
 
+bool UFlowGraphNode::GetExecutionStats(FFlowNodeExecutionStats& OutStats) const
+{
+	if (FlowNode == nullptr)
+	{
+		return false;
+	}
+
+	switch (UFlowGraphEditorSettings::Get()->HeatmapMode)
+	{
+		case EFlowHeatmapMode::InspectedInstance:
+			if (const UFlowNode* NodeInstance = FlowNode->GetInspectedInstance())
+			{
+				OutStats = NodeInstance->GetExecutionStats();
+				return true;
+			}
+			break;
+		case EFlowHeatmapMode::AllInstances:
+		{
+			const UFlowAsset* TemplateAsset = FlowNode->GetFlowAsset();
+			if (TemplateAsset && TemplateAsset->GetInstancesNum() > 0)
+			{
+				OutStats = FFlowNodeExecutionStats();
+				for (const UFlowAsset* Instance : TemplateAsset->GetInstances())
+				{
+					if (const UFlowNode* NodeInstance = Instance->GetNode(FlowNode->GetGuid()))
+					{
+						OutStats.Append(NodeInstance->GetExecutionStats());
+					}
+				}
+				return true;
+			}
+			break;
+		}
+		default: ;
+	}
+
+	return false;
+}
+
+float UFlowGraphNode::GetExecutionHeat() const
+{
+	const UFlowGraph* FlowGraph = Cast<UFlowGraph>(GetGraph());
+	return FlowGraph ? FlowGraph->GetExecutionHeat(this) : -1.0f;
+}
+
 bool UFlowGraphNode::IsContentPreloaded() const
 {
 	if (FlowNode)
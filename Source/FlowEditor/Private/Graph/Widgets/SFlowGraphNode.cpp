@@ -2,6 +2,7 @@
 
 #include "Graph/Widgets/SFlowGraphNode.h"
 #include "FlowEditorStyle.h"
+#include "Graph/FlowGraphEditorSettings.h"
 #include "Graph/FlowGraphSettings.h"
 
 #include "Nodes/FlowNode.h"
@@ -75,6 +76,15 @@ void SFlowGraphNode::GetNodeInfoPopups(FNodeInfoContext* Context, TArray<FGraphI
 			const FGraphInformationPopupInfo DescriptionPopup = FGraphInformationPopupInfo(nullptr, UFlowGraphSettings::Get()->NodeStatusBackground, TEXT("Preloaded"));
 			Popups.Add(DescriptionPopup);
 		}
+
+		FFlowNodeExecutionStats Stats;
+		if (FlowGraphNode->GetExecutionStats(Stats) && Stats.Activations > 0)
+		{
+			const FString StatsString = FString::Printf(TEXT("x%d | %.3f ms (max %.3f ms) | active %.2f s"),
+				Stats.Activations, Stats.ExecuteTime * 1000.0, Stats.MaxExecuteTime * 1000.0, Stats.GetActiveTime());
+			const FGraphInformationPopupInfo StatsPopup = FGraphInformationPopupInfo(nullptr, UFlowGraphSettings::Get()->NodeStatusBackground, StatsString);
+			Popups.Add(StatsPopup);
+		}
 	}
 }
 
@@ -464,6 +474,15 @@ FSlateColor SFlowGraphNode::GetNodeTitleColor() const
 FSlateColor SFlowGraphNode::GetNodeBodyColor() const
 {
 	FLinearColor ReturnBodyColor = GraphNode->GetNodeBodyTintColor();
+	if (GEditor->PlayWorld)
+	{
+		const float Heat = FlowGraphNode->GetExecutionHeat();
+		if (Heat >= 0.0f)
+		{
+			const UFlowGraphEditorSettings* Settings = UFlowGraphEditorSettings::Get();
+			ReturnBodyColor = FLinearColor::LerpUsingHSV(Settings->HeatmapColdColor, Settings->HeatmapHotColor, Heat);
+		}
+	}
 	if (FlowGraphNode->GetSignalMode() != EFlowSignalMode::Enabled)
 	{
 		ReturnBodyColor *= FLinearColor(1.0f, 1.0f, 1.0f, 0.5f); 
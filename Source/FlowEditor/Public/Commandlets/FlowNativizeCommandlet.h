@@ -0,0 +1,27 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#pragma once
+
+#include "Commandlets/Commandlet.h"
+#include "FlowNativizeCommandlet.generated.h"
+
+class UFlowAsset;
+
+/**
+ * Generates C++ dispatching signals between nodes of Flow Assets marked as "Generate Native Code"
+ * Usage: UnrealEditor-Cmd.exe <Project> -run=FlowNativize -Output=<Directory in the game module>
+ * Generated files have to be compiled into a game module depending on the Flow module, and regenerated after every graph change
+ */
+UCLASS()
+class FLOWEDITOR_API UFlowNativizeCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UFlowNativizeCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+private:
+	static FString GenerateCode(const UFlowAsset* FlowAsset, const FString& GeneratedName);
+};
@@ -7,6 +7,8 @@
 #include "FlowAsset.h"
 #include "FlowGraph.generated.h"
 
+class UFlowGraphNode;
+
 class FLOWEDITOR_API FFlowGraphInterface : public IFlowGraphInterface
 {
 public:
@@ -30,4 +32,15 @@ class FLOWEDITOR_API UFlowGraph : public UEdGraph
 
 	/** Returns the FlowAsset that contains this graph */
 	UFlowAsset* GetFlowAsset() const;
+
+	// Heatmap metric of the node divided by the highest one in the graph, negative if the node has no stats
+	float GetExecutionHeat(const UFlowGraphNode* GraphNode) const;
+
+private:
+	// Every node widget asks for its heat on every paint, so metrics of all nodes are gathered once per frame
+	void UpdateExecutionMetrics() const;
+
+	mutable TMap<const UFlowGraphNode*, double> ExecutionMetrics;
+	mutable double MaxExecutionMetric = 0.0;
+	mutable uint64 ExecutionMetricsFrame = MAX_uint64;
 };
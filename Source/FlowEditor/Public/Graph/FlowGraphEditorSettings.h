@@ -12,6 +12,22 @@ enum class EFlowNodeDoubleClickTarget : uint8
 	PrimaryAsset   UMETA(Tooltip = "Open asset defined as primary asset, i.e. Dialogue asset for PlayDialogue node")
 };
 
+UENUM()
+enum class EFlowHeatmapMode : uint8
+{
+	Disabled,
+	InspectedInstance UMETA(Tooltip = "Display execution stats of the instance selected in the debugger"),
+	AllInstances      UMETA(Tooltip = "Sum execution stats of all instances of the edited asset")
+};
+
+UENUM()
+enum class EFlowHeatmapMetric : uint8
+{
+	Activations,
+	ExecuteTime UMETA(Tooltip = "Time spent in ExecuteInput, including nodes triggered synchronously by it"),
+	ActiveTime  UMETA(Tooltip = "Time between node activation and finish")
+};
+
 /**
  *
  */
@@ -54,6 +70,20 @@ class FLOWEDITOR_API UFlowGraphEditorSettings : public UDeveloperSettings
 	UPROPERTY(EditAnywhere, config, Category = "Wires")
 	bool bHighlightOutputWiresOfSelectedNodes;
 
+	// Colors nodes by their execution stats while playing, and displays stats above nodes
+	UPROPERTY(EditAnywhere, config, Category = "Heatmap")
+	EFlowHeatmapMode HeatmapMode;
+
+	// Stat deciding the node color, relative to the hottest node in the graph
+	UPROPERTY(EditAnywhere, config, Category = "Heatmap", meta = (EditCondition = "HeatmapMode != EFlowHeatmapMode::Disabled"))
+	EFlowHeatmapMetric HeatmapMetric;
+
+	UPROPERTY(EditAnywhere, config, Category = "Heatmap", meta = (EditCondition = "HeatmapMode != EFlowHeatmapMode::Disabled"))
+	FLinearColor HeatmapColdColor;
+
+	UPROPERTY(EditAnywhere, config, Category = "Heatmap", meta = (EditCondition = "HeatmapMode != EFlowHeatmapMode::Disabled"))
+	FLinearColor HeatmapHotColor;
+
 public:
 	virtual FName GetCategoryName() const override { return FName("Flow Graph"); }
 	virtual FText GetSectionText() const override { return INVTEXT("User Settings"); }
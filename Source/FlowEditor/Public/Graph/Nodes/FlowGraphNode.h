@@ -129,6 +129,12 @@ public:
 	FString GetStatusString() const;
 	FLinearColor GetStatusBackgroundColor() const;
 
+	// Execution stats of the inspected instance or all instances, depending on heatmap mode
+	bool GetExecutionStats(FFlowNodeExecutionStats& OutStats) const;
+
+	// Heatmap metric of this node divided by the highest one in the graph, negative if there are no stats
+	float GetExecutionHeat() const;
+
 	// Check this to display information while node is preloaded
 	bool IsContentPreloaded() const;
 
@@ -0,0 +1,26 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+using UnrealBuildTool;
+
+public class FlowInsights : ModuleRules
+{
+	public FlowInsights(ReadOnlyTargetRules target) : base(target)
+	{
+		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		PublicDependencyModuleNames.AddRange(new[]
+		{
+			"TraceAnalysis",
+			"TraceServices"
+		});
+
+		PrivateDependencyModuleNames.AddRange(new[]
+		{
+			"Core",
+			"InputCore",
+			"Slate",
+			"SlateCore",
+			"TraceInsights"
+		});
+	}
+}
@@ -0,0 +1,25 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "FlowInsightsModule.h"
+#include "FlowTimingViewExtender.h"
+#include "FlowTraceModule.h"
+
+#include "Features/IModularFeatures.h"
+#include "Modules/ModuleManager.h"
+
+static FFlowTraceModule FlowTraceModule;
+static FFlowTimingViewExtender FlowTimingViewExtender;
+
+void FFlowInsightsModule::StartupModule()
+{
+	IModularFeatures::Get().RegisterModularFeature(TraceServices::ModuleFeatureName, &FlowTraceModule);
+	IModularFeatures::Get().RegisterModularFeature(FlowTimingView::TimingViewExtenderFeatureName, &FlowTimingViewExtender);
+}
+
+void FFlowInsightsModule::ShutdownModule()
+{
+	IModularFeatures::Get().UnregisterModularFeature(FlowTimingView::TimingViewExtenderFeatureName, &FlowTimingViewExtender);
+	IModularFeatures::Get().UnregisterModularFeature(TraceServices::ModuleFeatureName, &FlowTraceModule);
+}
+
+IMPLEMENT_MODULE(FFlowInsightsModule, FlowInsights)
@@ -0,0 +1,63 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "FlowTimingTrack.h"
+#include "FlowTraceProvider.h"
+
+#include "Insights/ViewModels/ITimingViewDrawHelper.h"
+#include "Insights/ViewModels/TimingTrackViewport.h"
+#include "TraceServices/Model/AnalysisSession.h"
+
+#define LOCTEXT_NAMESPACE "FlowTimingTrack"
+
+INSIGHTS_IMPLEMENT_RTTI(FFlowTimingTrack)
+
+FFlowTimingTrack::FFlowTimingTrack(const TraceServices::IAnalysisSession& InSession, const EMode InMode)
+	: FTimingEventsTrack(InMode == EMode::Instances ? LOCTEXT("InstancesTrackName", "Flow Instances").ToString() : LOCTEXT("NodesTrackName", "Flow Nodes").ToString())
+	, Session(InSession)
+	, Mode(InMode)
+{
+}
+
+void FFlowTimingTrack::BuildDrawState(ITimingEventsTrackDrawStateBuilder& Builder, const ITimingTrackUpdateContext& Context)
+{
+	TraceServices::FAnalysisSessionReadScope SessionReadScope(Session);
+
+	const FFlowTraceProvider* Provider = Session.ReadProvider<FFlowTraceProvider>(FFlowTraceProvider::ProviderName);
+	if (Provider == nullptr)
+	{
+		return;
+	}
+
+	const double ViewStartTime = Context.GetViewport().GetStartTime();
+	const double ViewEndTime = Context.GetViewport().GetEndTime();
+
+	// events still open are drawn until the end of the trace received so far
+	const double SessionEndTime = Session.GetDurationSeconds();
+
+	if (Mode == EMode::Instances)
+	{
+		Provider->EnumerateInstances([&](const FFlowTraceProvider::FInstance& Instance)
+		{
+			const double EndTime = FMath::Min(Instance.EndTime, SessionEndTime);
+			if (EndTime >= ViewStartTime && Instance.StartTime <= ViewEndTime)
+			{
+				const FString& Name = Instance.InstanceName.IsEmpty() ? Instance.TemplatePath : Instance.InstanceName;
+				Builder.AddEvent(Instance.StartTime, EndTime, Instance.Depth, *Name, 0, GetTypeHash(Instance.TemplatePath) | 0xFF000000);
+			}
+		});
+	}
+	else
+	{
+		Provider->EnumerateNodeLifetimes([&](const FFlowTraceProvider::FNodeLifetime& NodeLifetime)
+		{
+			const double EndTime = FMath::Min(NodeLifetime.EndTime, SessionEndTime);
+			if (EndTime >= ViewStartTime && NodeLifetime.StartTime <= ViewEndTime)
+			{
+				const FString Name = NodeLifetime.NodeClass.ToString();
+				Builder.AddEvent(NodeLifetime.StartTime, EndTime, NodeLifetime.Depth, *Name, 0, GetTypeHash(NodeLifetime.NodeClass) | 0xFF000000);
+			}
+		});
+	}
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,85 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "FlowTimingViewExtender.h"
+#include "FlowTimingTrack.h"
+#include "FlowTraceProvider.h"
+
+#include "Framework/MultiBox/MultiBoxBuilder.h"
+#include "Insights/ITimingViewSession.h"
+#include "TraceServices/Model/AnalysisSession.h"
+
+#define LOCTEXT_NAMESPACE "FlowTimingViewExtender"
+
+void FFlowTimingViewExtender::OnBeginSession(FlowTimingView::ITimingViewSession& InSession)
+{
+	SessionTracks.Add(&InSession);
+}
+
+void FFlowTimingViewExtender::OnEndSession(FlowTimingView::ITimingViewSession& InSession)
+{
+	SessionTracks.Remove(&InSession);
+}
+
+void FFlowTimingViewExtender::Tick(FlowTimingView::ITimingViewSession& InSession, const TraceServices::IAnalysisSession& InAnalysisSession)
+{
+	FSessionTracks* Tracks = SessionTracks.Find(&InSession);
+	if (Tracks == nullptr)
+	{
+		return;
+	}
+
+	TraceServices::FAnalysisSessionReadScope SessionReadScope(InAnalysisSession);
+
+	const FFlowTraceProvider* Provider = InAnalysisSession.ReadProvider<FFlowTraceProvider>(FFlowTraceProvider::ProviderName);
+	if (Provider == nullptr)
+	{
+		return;
+	}
+
+	if (!Tracks->InstancesTrack.IsValid())
+	{
+		Tracks->InstancesTrack = MakeShared<FFlowTimingTrack>(InAnalysisSession, FFlowTimingTrack::EMode::Instances);
+		Tracks->NodesTrack = MakeShared<FFlowTimingTrack>(InAnalysisSession, FFlowTimingTrack::EMode::Nodes);
+
+		InSession.AddScrollableTrack(Tracks->InstancesTrack);
+		InSession.AddScrollableTrack(Tracks->NodesTrack);
+	}
+
+	// rebuild draw state only if the analysis received new Flow events
+	if (Tracks->ChangeNumber != Provider->GetChangeNumber())
+	{
+		Tracks->ChangeNumber = Provider->GetChangeNumber();
+		Tracks->InstancesTrack->SetDirtyFlag();
+		Tracks->NodesTrack->SetDirtyFlag();
+	}
+}
+
+void FFlowTimingViewExtender::ExtendFilterMenu(FlowTimingView::ITimingViewSession& InSession, FMenuBuilder& InMenuBuilder)
+{
+	const FSessionTracks* Tracks = SessionTracks.Find(&InSession);
+	if (Tracks == nullptr || !Tracks->InstancesTrack.IsValid())
+	{
+		return;
+	}
+
+	auto AddTrackEntry = [&InMenuBuilder](const TSharedPtr<FFlowTimingTrack>& Track, const FText& Label, const FText& ToolTip)
+	{
+		InMenuBuilder.AddMenuEntry(
+			Label,
+			ToolTip,
+			FSlateIcon(),
+			FUIAction(
+				FExecuteAction::CreateLambda([Track]() { Track->ToggleVisibility(); }),
+				FCanExecuteAction(),
+				FIsActionChecked::CreateLambda([Track]() { return Track->IsVisible(); })),
+			NAME_None,
+			EUserInterfaceActionType::ToggleButton);
+	};
+
+	InMenuBuilder.BeginSection("Flow", LOCTEXT("FlowSection", "Flow"));
+	AddTrackEntry(Tracks->InstancesTrack, LOCTEXT("InstancesTrack", "Flow Instances"), LOCTEXT("InstancesTrackToolTip", "Show lifetimes of Flow Asset instances"));
+	AddTrackEntry(Tracks->NodesTrack, LOCTEXT("NodesTrack", "Flow Nodes"), LOCTEXT("NodesTrackToolTip", "Show lifetimes of active Flow Nodes"));
+	InMenuBuilder.EndSection();
+}
+
+#undef LOCTEXT_NAMESPACE
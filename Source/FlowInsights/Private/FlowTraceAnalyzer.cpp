@@ -0,0 +1,95 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "FlowTraceAnalyzer.h"
+#include "FlowTraceProvider.h"
+
+#include "TraceServices/Model/AnalysisSession.h"
+
+FFlowTraceAnalyzer::FFlowTraceAnalyzer(TraceServices::IAnalysisSession& InSession, FFlowTraceProvider& InProvider)
+	: Session(InSession)
+	, Provider(InProvider)
+{
+}
+
+void FFlowTraceAnalyzer::OnAnalysisBegin(const FOnAnalysisContext& Context)
+{
+	FInterfaceBuilder& Builder = Context.InterfaceBuilder;
+
+	Builder.RouteEvent(RouteId_InstanceCreated, "Flow", "InstanceCreated");
+	Builder.RouteEvent(RouteId_InstanceFinished, "Flow", "InstanceFinished");
+	Builder.RouteEvent(RouteId_NodeActivated, "Flow", "NodeActivated");
+	Builder.RouteEvent(RouteId_NodeFinished, "Flow", "NodeFinished");
+	Builder.RouteEvent(RouteId_PinTriggered, "Flow", "PinTriggered");
+	Builder.RouteEvent(RouteId_SpanBegin, "Flow", "SpanBegin");
+	Builder.RouteEvent(RouteId_SpanEnd, "Flow", "SpanEnd");
+}
+
+bool FFlowTraceAnalyzer::OnEvent(uint16 RouteId, EStyle Style, const FOnEventContext& Context)
+{
+	TraceServices::FAnalysisSessionEditScope EditScope(Session);
+
+	const FEventData& EventData = Context.EventData;
+	const double Time = Context.EventTime.AsSeconds(EventData.GetValue<uint64>("Cycle"));
+
+	auto ReadNodeGuid = [&EventData]()
+	{
+		const TArrayReader<uint32>& Guid = EventData.GetArray<uint32>("NodeGuid");
+		return Guid.Num() == 4 ? FGuid(Guid[0], Guid[1], Guid[2], Guid[3]) : FGuid();
+	};
+
+	switch (RouteId)
+	{
+		case RouteId_InstanceCreated:
+		{
+			FString InstanceName, TemplatePath, OwnerName;
+			EventData.GetString("InstanceName", InstanceName);
+			EventData.GetString("TemplatePath", TemplatePath);
+			EventData.GetString("OwnerName", OwnerName);
+
+			Provider.OnInstanceCreated(EventData.GetValue<uint32>("InstanceId"), Time, InstanceName, TemplatePath, OwnerName);
+			break;
+		}
+		case RouteId_InstanceFinished:
+			Provider.OnInstanceFinished(EventData.GetValue<uint32>("InstanceId"), Time);
+			break;
+		case RouteId_NodeActivated:
+		{
+			const uint32 InstanceId = EventData.GetValue<uint32>("InstanceId");
+			const FGuid NodeGuid = ReadNodeGuid();
+
+			FString NodeClass;
+			EventData.GetString("NodeClass", NodeClass);
+
+			Provider.OnInstanceEvent(InstanceId, {Time, FFlowTraceProvider::EEventType::NodeActivated, NodeGuid, NAME_None});
+			Provider.OnNodeActivated(InstanceId, Time, NodeGuid, FName(*NodeClass));
+			break;
+		}
+		case RouteId_NodeFinished:
+		{
+			const uint32 InstanceId = EventData.GetValue<uint32>("InstanceId");
+			const FGuid NodeGuid = ReadNodeGuid();
+
+			Provider.OnInstanceEvent(InstanceId, {Time, FFlowTraceProvider::EEventType::NodeFinished, NodeGuid, NAME_None});
+			Provider.OnNodeFinished(InstanceId, Time, NodeGuid);
+			break;
+		}
+		case RouteId_PinTriggered:
+		{
+			FString PinName;
+			EventData.GetString("PinName", PinName);
+
+			const FFlowTraceProvider::EEventType Type = EventData.GetValue<bool>("bOutput") ? FFlowTraceProvider::EEventType::OutputTriggered : FFlowTraceProvider::EEventType::InputTriggered;
+			Provider.OnInstanceEvent(EventData.GetValue<uint32>("InstanceId"), {Time, Type, ReadNodeGuid(), FName(*PinName)});
+			break;
+		}
+		case RouteId_SpanBegin:
+			Provider.OnSpanBegin(EventData.GetValue<uint8>("Span"), Time);
+			break;
+		case RouteId_SpanEnd:
+			Provider.OnSpanEnd(EventData.GetValue<uint8>("Span"), Time);
+			break;
+		default: ;
+	}
+
+	return true;
+}
@@ -0,0 +1,27 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "FlowTraceModule.h"
+#include "FlowTraceAnalyzer.h"
+#include "FlowTraceProvider.h"
+
+#include "TraceServices/Model/AnalysisSession.h"
+
+static const FName FlowTraceModuleName(TEXT("TraceModule_Flow"));
+
+void FFlowTraceModule::GetModuleInfo(TraceServices::FModuleInfo& OutModuleInfo)
+{
+	OutModuleInfo.Name = FlowTraceModuleName;
+	OutModuleInfo.DisplayName = TEXT("Flow");
+}
+
+void FFlowTraceModule::OnAnalysisBegin(TraceServices::IAnalysisSession& Session)
+{
+	const TSharedPtr<FFlowTraceProvider> Provider = MakeShared<FFlowTraceProvider>(Session);
+	Session.AddProvider(FFlowTraceProvider::ProviderName, Provider);
+	Session.AddAnalyzer(new FFlowTraceAnalyzer(Session, *Provider));
+}
+
+void FFlowTraceModule::GetLoggers(TArray<const TCHAR*>& OutLoggers)
+{
+	OutLoggers.Add(TEXT("Flow"));
+}
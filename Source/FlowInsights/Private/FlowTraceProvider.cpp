@@ -0,0 +1,170 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "FlowTraceProvider.h"
+
+FName FFlowTraceProvider::ProviderName(TEXT("FlowTraceProvider"));
+
+FFlowTraceProvider::FFlowTraceProvider(TraceServices::IAnalysisSession& InSession)
+	: Session(InSession)
+{
+}
+
+void FFlowTraceProvider::OnInstanceCreated(const uint32 InstanceId, const double Time, const FString& InstanceName, const FString& TemplatePath, const FString& OwnerName)
+{
+	Session.WriteAccessCheck();
+
+	// the finish event of the previous instance with this id got lost, i.e. the trace started late
+	if (LiveInstances.Contains(InstanceId))
+	{
+		OnInstanceFinished(InstanceId, Time);
+	}
+
+	FInstance& Instance = Instances.AddDefaulted_GetRef();
+	Instance.InstanceId = InstanceId;
+	Instance.InstanceName = InstanceName;
+	Instance.TemplatePath = TemplatePath;
+	Instance.OwnerName = OwnerName;
+	Instance.StartTime = Time;
+
+	int32 Depth = InstanceLanes.FindAndSetFirstZeroBit();
+	if (Depth == INDEX_NONE)
+	{
+		Depth = InstanceLanes.Add(true);
+	}
+	Instance.Depth = static_cast<uint32>(Depth);
+
+	LiveInstances.Add(InstanceId, Instances.Num() - 1);
+	ChangeNumber++;
+}
+
+void FFlowTraceProvider::OnInstanceFinished(const uint32 InstanceId, const double Time)
+{
+	Session.WriteAccessCheck();
+
+	if (FInstance* Instance = FindLiveInstance(InstanceId))
+	{
+		if (const TMap<FGuid, int32>* Nodes = ActiveNodes.Find(InstanceId))
+		{
+			for (const TPair<FGuid, int32>& Node : *Nodes)
+			{
+				FinishNode(Node.Value, Time);
+			}
+			ActiveNodes.Remove(InstanceId);
+		}
+
+		Instance->EndTime = Time;
+		InstanceLanes[Instance->Depth] = false;
+
+		LiveInstances.Remove(InstanceId);
+		ChangeNumber++;
+	}
+}
+
+void FFlowTraceProvider::OnInstanceEvent(const uint32 InstanceId, const FEvent& Event)
+{
+	Session.WriteAccessCheck();
+
+	if (FInstance* Instance = FindLiveInstance(InstanceId))
+	{
+		Instance->Events.Add(Event);
+	}
+}
+
+void FFlowTraceProvider::OnNodeActivated(const uint32 InstanceId, const double Time, const FGuid& NodeGuid, const FName& NodeClass)
+{
+	Session.WriteAccessCheck();
+
+	const int32* InstanceIndex = LiveInstances.Find(InstanceId);
+	if (InstanceIndex == nullptr)
+	{
+		return;
+	}
+
+	TMap<FGuid, int32>& Nodes = ActiveNodes.FindOrAdd(InstanceId);
+
+	// node activated again without finishing, i.e. its input triggered twice
+	if (const int32* ActiveIndex = Nodes.Find(NodeGuid))
+	{
+		FinishNode(*ActiveIndex, Time);
+	}
+
+	int32 Depth = NodeLanes.FindAndSetFirstZeroBit();
+	if (Depth == INDEX_NONE)
+	{
+		Depth = NodeLanes.Add(true);
+	}
+
+	Nodes.Add(NodeGuid, NodeLifetimes.Add({*InstanceIndex, NodeClass, Time, TNumericLimits<double>::Max(), static_cast<uint32>(Depth)}));
+	ChangeNumber++;
+}
+
+void FFlowTraceProvider::OnNodeFinished(const uint32 InstanceId, const double Time, const FGuid& NodeGuid)
+{
+	Session.WriteAccessCheck();
+
+	if (TMap<FGuid, int32>* Nodes = ActiveNodes.Find(InstanceId))
+	{
+		int32 LifetimeIndex;
+		if (Nodes->RemoveAndCopyValue(NodeGuid, LifetimeIndex))
+		{
+			FinishNode(LifetimeIndex, Time);
+			ChangeNumber++;
+		}
+	}
+}
+
+void FFlowTraceProvider::OnSpanBegin(const uint8 Type, const double Time)
+{
+	Session.WriteAccessCheck();
+
+	Spans.Add({Type, Time, TNumericLimits<double>::Max()});
+	ChangeNumber++;
+}
+
+void FFlowTraceProvider::OnSpanEnd(const uint8 Type, const double Time)
+{
+	Session.WriteAccessCheck();
+
+	for (int32 i = Spans.Num() - 1; i >= 0; i--)
+	{
+		if (Spans[i].Type == Type && Spans[i].EndTime == TNumericLimits<double>::Max())
+		{
+			Spans[i].EndTime = Time;
+			ChangeNumber++;
+			break;
+		}
+	}
+}
+
+void FFlowTraceProvider::EnumerateInstances(TFunctionRef<void(const FInstance&)> Callback) const
+{
+	Session.ReadAccessCheck();
+
+	for (const FInstance& Instance : Instances)
+	{
+		Callback(Instance);
+	}
+}
+
+void FFlowTraceProvider::EnumerateNodeLifetimes(TFunctionRef<void(const FNodeLifetime&)> Callback) const
+{
+	Session.ReadAccessCheck();
+
+	for (const FNodeLifetime& NodeLifetime : NodeLifetimes)
+	{
+		Callback(NodeLifetime);
+	}
+}
+
+FFlowTraceProvider::FInstance* FFlowTraceProvider::FindLiveInstance(const uint32 InstanceId)
+{
+	const int32* Index = LiveInstances.Find(InstanceId);
+	return Index ? &Instances[*Index] : nullptr;
+}
+
+void FFlowTraceProvider::FinishNode(const int32 LifetimeIndex, const double Time)
+{
+	FNodeLifetime& NodeLifetime = NodeLifetimes[LifetimeIndex];
+	NodeLifetime.EndTime = Time;
+	NodeLanes[NodeLifetime.Depth] = false;
+}
@@ -0,0 +1,15 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#pragma once
+
+#include "Modules/ModuleInterface.h"
+
+/**
+ * Analysis of Flow trace events, loaded by the editor and the standalone Unreal Insights
+ */
+class FFlowInsightsModule final : public IModuleInterface
+{
+public:
+	virtual void StartupModule() override;
+	virtual void ShutdownModule() override;
+};
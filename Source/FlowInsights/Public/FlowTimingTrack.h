@@ -0,0 +1,35 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#pragma once
+
+#include "Insights/ViewModels/TimingEventsTrack.h"
+
+namespace TraceServices
+{
+	class IAnalysisSession;
+}
+
+class FFlowTraceProvider;
+
+/**
+ * Timing View track drawing lifetimes of Flow Asset instances or of their active nodes
+ */
+class FFlowTimingTrack : public FTimingEventsTrack
+{
+	INSIGHTS_DECLARE_RTTI(FFlowTimingTrack, FTimingEventsTrack)
+
+public:
+	enum class EMode : uint8
+	{
+		Instances,
+		Nodes
+	};
+
+	FFlowTimingTrack(const TraceServices::IAnalysisSession& InSession, const EMode InMode);
+
+	virtual void BuildDrawState(ITimingEventsTrackDrawStateBuilder& Builder, const ITimingTrackUpdateContext& Context) override;
+
+private:
+	const TraceServices::IAnalysisSession& Session;
+	EMode Mode;
+};
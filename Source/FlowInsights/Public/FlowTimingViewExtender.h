@@ -0,0 +1,36 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#pragma once
+
+#include "Insights/ITimingViewExtender.h"
+
+class FFlowTimingTrack;
+
+#if ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION < 4
+namespace FlowTimingView = Insights;
+#else
+namespace FlowTimingView = UE::Insights::Timing;
+#endif
+
+/**
+ * Adds Flow tracks to the Timing View of every Insights session which traced the FlowChannel
+ */
+class FFlowTimingViewExtender : public FlowTimingView::ITimingViewExtender
+{
+public:
+	virtual void OnBeginSession(FlowTimingView::ITimingViewSession& InSession) override;
+	virtual void OnEndSession(FlowTimingView::ITimingViewSession& InSession) override;
+	virtual void Tick(FlowTimingView::ITimingViewSession& InSession, const TraceServices::IAnalysisSession& InAnalysisSession) override;
+	virtual void ExtendFilterMenu(FlowTimingView::ITimingViewSession& InSession, FMenuBuilder& InMenuBuilder) override;
+
+private:
+	struct FSessionTracks
+	{
+		TSharedPtr<FFlowTimingTrack> InstancesTrack;
+		TSharedPtr<FFlowTimingTrack> NodesTrack;
+		uint32 ChangeNumber = 0;
+	};
+
+	// the editor might show several Timing Views at once
+	TMap<FlowTimingView::ITimingViewSession*, FSessionTracks> SessionTracks;
+};
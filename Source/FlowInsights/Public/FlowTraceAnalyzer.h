@@ -0,0 +1,39 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#pragma once
+
+#include "Trace/Analyzer.h"
+
+namespace TraceServices
+{
+	class IAnalysisSession;
+}
+
+class FFlowTraceProvider;
+
+/**
+ * Reads events of the FlowChannel and passes them to the Flow Trace Provider
+ */
+class FFlowTraceAnalyzer : public UE::Trace::IAnalyzer
+{
+public:
+	FFlowTraceAnalyzer(TraceServices::IAnalysisSession& InSession, FFlowTraceProvider& InProvider);
+
+	virtual void OnAnalysisBegin(const FOnAnalysisContext& Context) override;
+	virtual bool OnEvent(uint16 RouteId, EStyle Style, const FOnEventContext& Context) override;
+
+private:
+	enum : uint16
+	{
+		RouteId_InstanceCreated,
+		RouteId_InstanceFinished,
+		RouteId_NodeActivated,
+		RouteId_NodeFinished,
+		RouteId_PinTriggered,
+		RouteId_SpanBegin,
+		RouteId_SpanEnd
+	};
+
+	TraceServices::IAnalysisSession& Session;
+	FFlowTraceProvider& Provider;
+};
@@ -0,0 +1,112 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TraceServices/Model/AnalysisSession.h"
+
+/**
+ * Flow events read from the Insights trace, grouped by the asset instance which emitted them
+ */
+class FLOWINSIGHTS_API FFlowTraceProvider : public TraceServices::IProvider
+{
+public:
+	static FName ProviderName;
+
+	enum class EEventType : uint8
+	{
+		NodeActivated,
+		NodeFinished,
+		InputTriggered,
+		OutputTriggered
+	};
+
+	struct FEvent
+	{
+		double Time;
+		EEventType Type;
+		FGuid NodeGuid;
+		FName PinName;
+	};
+
+	struct FInstance
+	{
+		uint32 InstanceId = 0;
+		FString InstanceName;
+		FString TemplatePath;
+		FString OwnerName;
+
+		double StartTime = 0.0;
+		double EndTime = TNumericLimits<double>::Max();
+
+		// lane on the timing track, reused after the instance finishes
+		uint32 Depth = 0;
+
+		TArray<FEvent> Events;
+	};
+
+	// time between activation and finish of a single node
+	struct FNodeLifetime
+	{
+		int32 InstanceIndex;
+		FName NodeClass;
+		double StartTime;
+		double EndTime;
+		uint32 Depth;
+	};
+
+	struct FSpan
+	{
+		uint8 Type;
+		double StartTime;
+		double EndTime;
+	};
+
+	explicit FFlowTraceProvider(TraceServices::IAnalysisSession& InSession);
+
+	void OnInstanceCreated(const uint32 InstanceId, const double Time, const FString& InstanceName, const FString& TemplatePath, const FString& OwnerName);
+	void OnInstanceFinished(const uint32 InstanceId, const double Time);
+	void OnInstanceEvent(const uint32 InstanceId, const FEvent& Event);
+	void OnNodeActivated(const uint32 InstanceId, const double Time, const FGuid& NodeGuid, const FName& NodeClass);
+	void OnNodeFinished(const uint32 InstanceId, const double Time, const FGuid& NodeGuid);
+
+	void OnSpanBegin(const uint8 Type, const double Time);
+	void OnSpanEnd(const uint8 Type, const double Time);
+
+	// instances are listed in order of creation
+	void EnumerateInstances(TFunctionRef<void(const FInstance&)> Callback) const;
+	const FInstance& GetInstance(const int32 InstanceIndex) const { return Instances[InstanceIndex]; }
+	const TArray<FSpan>& GetSpans() const { return Spans; }
+
+	// lifetimes are listed in order of node activation
+	void EnumerateNodeLifetimes(TFunctionRef<void(const FNodeLifetime&)> Callback) const;
+
+	uint32 GetMaxInstanceDepth() const { return InstanceLanes.Num(); }
+	uint32 GetMaxNodeDepth() const { return NodeLanes.Num(); }
+
+	// incremented on every change, so views know when to rebuild
+	uint32 GetChangeNumber() const { return ChangeNumber; }
+
+private:
+	FInstance* FindLiveInstance(const uint32 InstanceId);
+	void FinishNode(const int32 LifetimeIndex, const double Time);
+
+	TraceServices::IAnalysisSession& Session;
+
+	TArray<FInstance> Instances;
+
+	// object ids are reused after garbage collection, so only the latest instance with the given id is live
+	TMap<uint32, int32> LiveInstances;
+
+	TArray<FNodeLifetime> NodeLifetimes;
+
+	// active nodes of every live instance, pointing to NodeLifetimes
+	TMap<uint32, TMap<FGuid, int32>> ActiveNodes;
+
+	TBitArray<> InstanceLanes;
+	TBitArray<> NodeLanes;
+
+	TArray<FSpan> Spans;
+
+	uint32 ChangeNumber = 0;
+};
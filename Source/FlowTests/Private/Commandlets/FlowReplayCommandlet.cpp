@@ -0,0 +1,283 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "Commandlets/FlowReplayCommandlet.h"
+#include "FlowBenchmarkEnvironment.h"
+#include "FlowTestsModule.h"
+
+#include "FlowAsset.h"
+#include "FlowComponent.h"
+#include "FlowRecording.h"
+#include "FlowSubsystem.h"
+
+#include "Dom/JsonObject.h"
+#include "GameFramework/Actor.h"
+#include "UObject/UObjectGlobals.h"
+
+namespace FlowReplay
+{
+	/**
+	 * Maps objects named in the recording to objects created by the replay, and back
+	 * Replayed events are translated to recorded names, so both logs can be compared directly
+	 */
+	class FObjectMap
+	{
+	public:
+		explicit FObjectMap(const UFlowSubsystem* InFlowSubsystem)
+			: FlowSubsystem(InFlowSubsystem)
+		{
+		}
+
+		void Add(const FString& RecordedName, UObject* Object)
+		{
+			Objects.Add(RecordedName, Object);
+			RecordedNames.Add(FlowSubsystem->GetRecordedObjectName(Object), RecordedName);
+		}
+
+		UObject* Find(const FString& RecordedName) const
+		{
+			const TWeakObjectPtr<UObject>* Object = Objects.Find(RecordedName);
+			return Object ? Object->Get() : nullptr;
+		}
+
+		template <typename T>
+		T* Find(const FString& RecordedName) const
+		{
+			return Cast<T>(Find(RecordedName));
+		}
+
+		FString ToRecordedName(const FString& ReplayedName) const
+		{
+			const FString* RecordedName = RecordedNames.Find(ReplayedName);
+			return RecordedName ? *RecordedName : ReplayedName;
+		}
+
+	private:
+		const UFlowSubsystem* FlowSubsystem;
+		TMap<FString, TWeakObjectPtr<UObject>> Objects;
+		TMap<FString, FString> RecordedNames;
+	};
+
+	UFlowAsset* LoadTemplate(const FSoftObjectPath& Asset)
+	{
+		UFlowAsset* Template = Cast<UFlowAsset>(Asset.TryLoad());
+		if (Template == nullptr)
+		{
+			UE_LOG(LogFlowTests, Error, TEXT("Flow Replay couldn't load Flow Asset %s"), *Asset.ToString());
+		}
+		return Template;
+	}
+}
+
+UFlowReplayCommandlet::UFlowReplayCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UFlowReplayCommandlet::Main(const FString& Params)
+{
+	using namespace FlowReplay;
+
+	FString RecordingPath;
+	int32 TickRate = 30;
+
+	FParse::Value(*Params, TEXT("Recording="), RecordingPath);
+	FParse::Value(*Params, TEXT("TickRate="), TickRate);
+	TickRate = FMath::Max(1, TickRate);
+
+	FFlowRecording Recording;
+	if (RecordingPath.IsEmpty() || !Recording.LoadFromFile(RecordingPath))
+	{
+		UE_LOG(LogFlowTests, Error, TEXT("Flow Replay requires valid -Recording=<File>"));
+		return 1;
+	}
+
+	FFlowBenchmarkEnvironment Environment;
+	if (!Environment.Initialize())
+	{
+		return 1;
+	}
+
+	UFlowSubsystem* FlowSubsystem = Environment.GetFlowSubsystem();
+	FlowSubsystem->SetVirtualTimeEnabled(Recording.bVirtualTime);
+	FlowSubsystem->SetRandomSeed(Recording.RandomSeed);
+	FlowSubsystem->StartRecording();
+
+	FObjectMap ObjectMap(FlowSubsystem);
+	const float DeltaSeconds = 1.0f / TickRate;
+	double Time = 0.0;
+
+	FFlowBenchmarkResult FrameResult(TEXT("Replay.Frame"));
+	FFlowBenchmarkResult StimulusResult(TEXT("Replay.Stimulus"));
+
+	const auto AdvanceTo = [&](const double TargetTime)
+	{
+		// stimulus is applied on the first frame reaching its time, so timer events are off by one frame at most
+		while (Time + KINDA_SMALL_NUMBER < TargetTime)
+		{
+			const double StartTime = FPlatformTime::Seconds();
+			if (Recording.bVirtualTime)
+			{
+				Environment.AdvanceVirtualTime(DeltaSeconds);
+			}
+			else
+			{
+				Environment.Tick(DeltaSeconds);
+			}
+			FrameResult.Samples.Add(FPlatformTime::Seconds() - StartTime);
+			Time += DeltaSeconds;
+		}
+	};
+
+	const auto FindOrSpawnOwner = [&](const FString& RecordedName) -> UObject*
+	{
+		UObject* Owner = ObjectMap.Find(RecordedName);
+		if (Owner == nullptr)
+		{
+			// owner without Flow Component, or registered before the recording started
+			Owner = Environment.SpawnFlowActor(FGameplayTagContainer());
+			ObjectMap.Add(RecordedName, Owner);
+		}
+		return Owner;
+	};
+
+	int32 Stimuli = 0;
+	for (const FFlowRecordedEvent& Event : Recording.Events)
+	{
+		if (!Event.IsStimulus())
+		{
+			continue;
+		}
+
+		AdvanceTo(Event.Time);
+
+		const double StartTime = FPlatformTime::Seconds();
+		switch (Event.Type)
+		{
+			case EFlowRecordedEventType::StartRootFlow:
+				if (UFlowAsset* Template = LoadTemplate(Event.Asset))
+				{
+					FlowSubsystem->StartRootFlowWithParameters(FindOrSpawnOwner(Event.Object), Template, Event.Parameters, Event.Value != 0);
+				}
+				break;
+			case EFlowRecordedEventType::FinishRootFlow:
+				if (UObject* Owner = ObjectMap.Find(Event.Object))
+				{
+					if (Event.Asset.IsNull())
+					{
+						FlowSubsystem->FinishAllRootFlows(Owner, static_cast<EFlowFinishPolicy>(Event.Value));
+					}
+					else if (UFlowAsset* Template = LoadTemplate(Event.Asset))
+					{
+						FlowSubsystem->FinishRootFlow(Owner, Template, static_cast<EFlowFinishPolicy>(Event.Value));
+					}
+				}
+				break;
+			case EFlowRecordedEventType::CustomInput:
+				if (const UObject* Owner = ObjectMap.Find(Event.Object))
+				{
+					for (UFlowAsset* Instance : FlowSubsystem->GetRootInstancesByOwner(Owner))
+					{
+						if (FSoftObjectPath(Instance->GetTemplateAsset()) == Event.Asset)
+						{
+							Instance->TriggerCustomInput(Event.Name);
+						}
+					}
+				}
+				break;
+			case EFlowRecordedEventType::NotifyGraph:
+				if (UFlowComponent* Component = ObjectMap.Find<UFlowComponent>(Event.Object))
+				{
+					if (Event.Tags.Num() == 1)
+					{
+						Component->NotifyGraph(Event.Tags.First());
+					}
+					else
+					{
+						Component->BulkNotifyGraph(Event.Tags);
+					}
+				}
+				break;
+			case EFlowRecordedEventType::ComponentRegistered:
+				ObjectMap.Add(Event.Object, Environment.SpawnFlowActor(Event.Tags));
+				break;
+			case EFlowRecordedEventType::ComponentUnregistered:
+				if (const UFlowComponent* Component = ObjectMap.Find<UFlowComponent>(Event.Object))
+				{
+					Component->GetOwner()->Destroy();
+				}
+				break;
+			case EFlowRecordedEventType::IdentityTagsAdded:
+				if (UFlowComponent* Component = ObjectMap.Find<UFlowComponent>(Event.Object))
+				{
+					Component->AddIdentityTags(Event.Tags);
+				}
+				break;
+			case EFlowRecordedEventType::IdentityTagsRemoved:
+				if (UFlowComponent* Component = ObjectMap.Find<UFlowComponent>(Event.Object))
+				{
+					Component->RemoveIdentityTags(Event.Tags);
+				}
+				break;
+			default:
+				break;
+		}
+		StimulusResult.Samples.Add(FPlatformTime::Seconds() - StartTime);
+		Stimuli++;
+	}
+
+	AdvanceTo(Recording.Duration);
+	const TSharedPtr<FFlowRecording> Replayed = FlowSubsystem->FinishRecording();
+
+	// graph results are compared in order, with time allowed to differ by the replay frame
+	TArray<FFlowRecordedEvent> Expected = Recording.Events.FilterByPredicate([](const FFlowRecordedEvent& Event) { return !Event.IsStimulus(); });
+	TArray<FFlowRecordedEvent> Actual = Replayed->Events.FilterByPredicate([](const FFlowRecordedEvent& Event) { return !Event.IsStimulus(); });
+	for (FFlowRecordedEvent& Event : Actual)
+	{
+		Event.Object = ObjectMap.ToRecordedName(Event.Object);
+	}
+
+	const double TimeTolerance = DeltaSeconds * 2.0;
+	int32 DivergenceIndex = INDEX_NONE;
+	for (int32 i = 0; i < FMath::Max(Expected.Num(), Actual.Num()); i++)
+	{
+		if (!Expected.IsValidIndex(i) || !Actual.IsValidIndex(i)
+			|| !Expected[i].Matches(Actual[i]) || FMath::Abs(Expected[i].Time - Actual[i].Time) > TimeTolerance)
+		{
+			DivergenceIndex = i;
+			break;
+		}
+	}
+
+	Environment.Shutdown();
+
+	const bool bDeterministic = DivergenceIndex == INDEX_NONE;
+	if (bDeterministic)
+	{
+		UE_LOG(LogFlowTests, Display, TEXT("Flow Replay matched %d recorded events after applying %d stimuli"), Expected.Num(), Stimuli);
+	}
+	else
+	{
+		UE_LOG(LogFlowTests, Error, TEXT("Flow Replay diverged at event %d"), DivergenceIndex);
+		UE_LOG(LogFlowTests, Error, TEXT("Recorded: %s"), Expected.IsValidIndex(DivergenceIndex) ? *Expected[DivergenceIndex].ToString() : TEXT("none"));
+		UE_LOG(LogFlowTests, Error, TEXT("Replayed: %s"), Actual.IsValidIndex(DivergenceIndex) ? *Actual[DivergenceIndex].ToString() : TEXT("none"));
+	}
+
+	const TSharedRef<FJsonObject> Report = MakeShared<FJsonObject>();
+	Report->SetStringField(TEXT("Recording"), RecordingPath);
+	Report->SetNumberField(TEXT("TickRate"), TickRate);
+	Report->SetNumberField(TEXT("Duration"), Recording.Duration);
+	Report->SetNumberField(TEXT("Stimuli"), Stimuli);
+	Report->SetNumberField(TEXT("RecordedEvents"), Expected.Num());
+	Report->SetNumberField(TEXT("ReplayedEvents"), Actual.Num());
+	Report->SetNumberField(TEXT("DivergenceIndex"), DivergenceIndex);
+	Report->SetBoolField(TEXT("Deterministic"), bDeterministic);
+
+	if (!FFlowBenchmarkResult::OutputReport(Params, Report, {FrameResult, StimulusResult}))
+	{
+		return 1;
+	}
+	return bDeterministic ? 0 : 1;
+}
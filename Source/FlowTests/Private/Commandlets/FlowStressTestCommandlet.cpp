@@ -0,0 +1,246 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "Commandlets/FlowStressTestCommandlet.h"
+#include "FlowBenchmarkEnvironment.h"
+#include "FlowTestsModule.h"
+
+#include "FlowAsset.h"
+#include "FlowComponent.h"
+#include "FlowSave.h"
+#include "FlowSubsystem.h"
+
+#include "Dom/JsonObject.h"
+#include "HAL/PlatformMemory.h"
+#include "Math/RandomStream.h"
+#include "UObject/StrongObjectPtr.h"
+#include "UObject/UObjectGlobals.h"
+
+namespace FlowStressTest
+{
+	// Small group of actors sending notifies, so observers don't bind to every owner in the world
+	constexpr int32 NotifiersNum = 16;
+
+	// Owners identity tags are A or B, tag C is added and removed during the run, tag D identifies notifiers
+	constexpr int32 ChurnTagIndex = 2;
+	constexpr int32 NotifierTagIndex = 3;
+
+	struct FFrameBreakdown
+	{
+		int32 Frame = INDEX_NONE;
+		double Notify = 0.0;
+		double TagChurn = 0.0;
+		double Tick = 0.0;
+		double Save = 0.0;
+		double GC = 0.0;
+
+		double GetTotal() const { return Notify + TagChurn + Tick + Save + GC; }
+
+		TSharedRef<FJsonObject> ToJson() const
+		{
+			const TSharedRef<FJsonObject> Json = MakeShared<FJsonObject>();
+			Json->SetNumberField(TEXT("Frame"), Frame);
+			Json->SetNumberField(TEXT("TotalMs"), GetTotal() * 1000.0);
+			Json->SetNumberField(TEXT("NotifyMs"), Notify * 1000.0);
+			Json->SetNumberField(TEXT("TagChurnMs"), TagChurn * 1000.0);
+			Json->SetNumberField(TEXT("TickMs"), Tick * 1000.0);
+			Json->SetNumberField(TEXT("SaveMs"), Save * 1000.0);
+			Json->SetNumberField(TEXT("GCMs"), GC * 1000.0);
+			return Json;
+		}
+	};
+
+	double GetUsedMemoryMB()
+	{
+		return static_cast<double>(FPlatformMemory::GetStats().UsedPhysical) / (1024.0 * 1024.0);
+	}
+}
+
+UFlowStressTestCommandlet::UFlowStressTestCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UFlowStressTestCommandlet::Main(const FString& Params)
+{
+	using namespace FlowStressTest;
+
+	int32 Owners = 10000;
+	int32 Depth = 4;
+	int32 Seconds = 60;
+	int32 TickRate = 30;
+	int32 NotifiesPerTick = 100;
+	int32 TagChurnPerTick = 50;
+	float SaveInterval = 10.0f;
+	float GCInterval = 5.0f;
+	int32 Seed = 0;
+	FString AssetPath;
+
+	FParse::Value(*Params, TEXT("Owners="), Owners);
+	FParse::Value(*Params, TEXT("Depth="), Depth);
+	FParse::Value(*Params, TEXT("Seconds="), Seconds);
+	FParse::Value(*Params, TEXT("TickRate="), TickRate);
+	FParse::Value(*Params, TEXT("NotifiesPerTick="), NotifiesPerTick);
+	FParse::Value(*Params, TEXT("TagChurnPerTick="), TagChurnPerTick);
+	FParse::Value(*Params, TEXT("SaveInterval="), SaveInterval);
+	FParse::Value(*Params, TEXT("GCInterval="), GCInterval);
+	FParse::Value(*Params, TEXT("Seed="), Seed);
+	FParse::Value(*Params, TEXT("Asset="), AssetPath);
+	Owners = FMath::Max(1, Owners);
+	Depth = FMath::Max(0, Depth);
+	Seconds = FMath::Max(1, Seconds);
+	TickRate = FMath::Max(1, TickRate);
+
+	FFlowBenchmarkEnvironment Environment;
+	if (!Environment.Initialize())
+	{
+		return 1;
+	}
+
+	UFlowSubsystem* FlowSubsystem = Environment.GetFlowSubsystem();
+	const FGameplayTag NotifyTag = FFlowBenchmarkEnvironment::GetNotifyTag();
+	const FGameplayTag ChurnTag = FFlowBenchmarkEnvironment::GetIdentityTag(ChurnTagIndex);
+
+	UFlowAsset* RootFlow = nullptr;
+	if (AssetPath.IsEmpty())
+	{
+		UFlowAsset* ObserverGraph = Environment.CreateObserverGraph(2, FFlowBenchmarkEnvironment::GetIdentityTag(NotifierTagIndex), NotifyTag);
+		RootFlow = Depth > 0 ? Environment.CreateNestedGraph(Depth, ObserverGraph) : ObserverGraph;
+	}
+	else
+	{
+		RootFlow = LoadObject<UFlowAsset>(nullptr, *AssetPath);
+		if (RootFlow == nullptr)
+		{
+			UE_LOG(LogFlowTests, Error, TEXT("Flow Stress Test couldn't load Flow Asset %s"), *AssetPath);
+			Environment.Shutdown();
+			return 1;
+		}
+	}
+
+	const double BaselineMemory = GetUsedMemoryMB();
+	double PeakMemory = BaselineMemory;
+
+	TArray<UFlowComponent*> Notifiers;
+	for (int32 i = 0; i < NotifiersNum; i++)
+	{
+		Notifiers.Add(Environment.SpawnFlowActor(FGameplayTagContainer(FFlowBenchmarkEnvironment::GetIdentityTag(NotifierTagIndex))));
+	}
+
+	// every owner starts Root Flow while spawned, so this measures instancing the whole nested hierarchy
+	TArray<UFlowComponent*> OwnerComponents;
+	OwnerComponents.Reserve(Owners);
+	const double SpawnStartTime = FPlatformTime::Seconds();
+	for (int32 i = 0; i < Owners; i++)
+	{
+		OwnerComponents.Add(Environment.SpawnFlowActor(FGameplayTagContainer(FFlowBenchmarkEnvironment::GetIdentityTag(i % 2)), RootFlow));
+	}
+	const double SpawnTime = FPlatformTime::Seconds() - SpawnStartTime;
+	PeakMemory = FMath::Max(PeakMemory, GetUsedMemoryMB());
+
+	UE_LOG(LogFlowTests, Display, TEXT("Flow Stress Test spawned %d owners in %.2f s, running %d s of simulated time"), Owners, SpawnTime, Seconds);
+
+	FFlowBenchmarkResult FrameResult(TEXT("StressTest.Frame"));
+	FFlowBenchmarkResult SaveResult(TEXT("StressTest.SaveGame"));
+	FFlowBenchmarkResult GCResult(TEXT("StressTest.GarbageCollection"));
+
+	FRandomStream RandomStream(Seed);
+	const float DeltaSeconds = 1.0f / TickRate;
+	const int32 Frames = Seconds * TickRate;
+	const int32 SaveFrames = SaveInterval > 0.0f ? FMath::Max(1, FMath::RoundToInt(SaveInterval * TickRate)) : 0;
+	const int32 GCFrames = GCInterval > 0.0f ? FMath::Max(1, FMath::RoundToInt(GCInterval * TickRate)) : 0;
+
+	FFrameBreakdown WorstFrame;
+	double TotalNotifyTime = 0.0;
+	double TotalTagChurnTime = 0.0;
+	int64 TotalNotifies = 0;
+	int64 TotalTagChanges = 0;
+
+	for (int32 Frame = 0; Frame < Frames; Frame++)
+	{
+		FFrameBreakdown Breakdown;
+		Breakdown.Frame = Frame;
+
+		double StartTime = FPlatformTime::Seconds();
+		for (int32 i = 0; i < NotifiesPerTick; i++)
+		{
+			Notifiers[RandomStream.RandHelper(Notifiers.Num())]->NotifyGraph(NotifyTag);
+		}
+		Breakdown.Notify = FPlatformTime::Seconds() - StartTime;
+
+		StartTime = FPlatformTime::Seconds();
+		for (int32 i = 0; i < TagChurnPerTick; i++)
+		{
+			UFlowComponent* Component = OwnerComponents[RandomStream.RandHelper(OwnerComponents.Num())];
+			if (Component->IdentityTags.HasTagExact(ChurnTag))
+			{
+				Component->RemoveIdentityTag(ChurnTag);
+			}
+			else
+			{
+				Component->AddIdentityTag(ChurnTag);
+			}
+		}
+		Breakdown.TagChurn = FPlatformTime::Seconds() - StartTime;
+
+		StartTime = FPlatformTime::Seconds();
+		Environment.Tick(DeltaSeconds);
+		Breakdown.Tick = FPlatformTime::Seconds() - StartTime;
+
+		if (SaveFrames > 0 && (Frame + 1) % SaveFrames == 0)
+		{
+			const TStrongObjectPtr<UFlowSaveGame> SaveGame(NewObject<UFlowSaveGame>());
+
+			StartTime = FPlatformTime::Seconds();
+			FlowSubsystem->OnGameSaved(SaveGame.Get());
+			Breakdown.Save = FPlatformTime::Seconds() - StartTime;
+			SaveResult.Samples.Add(Breakdown.Save);
+		}
+
+		// sample memory before collecting garbage, that's when the peak happens
+		PeakMemory = FMath::Max(PeakMemory, GetUsedMemoryMB());
+
+		if (GCFrames > 0 && (Frame + 1) % GCFrames == 0)
+		{
+			StartTime = FPlatformTime::Seconds();
+			CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+			Breakdown.GC = FPlatformTime::Seconds() - StartTime;
+			GCResult.Samples.Add(Breakdown.GC);
+		}
+
+		FrameResult.Samples.Add(Breakdown.GetTotal());
+		TotalNotifyTime += Breakdown.Notify;
+		TotalTagChurnTime += Breakdown.TagChurn;
+		TotalNotifies += NotifiesPerTick;
+		TotalTagChanges += TagChurnPerTick;
+
+		if (Breakdown.GetTotal() > WorstFrame.GetTotal())
+		{
+			WorstFrame = Breakdown;
+		}
+	}
+
+	FrameResult.Properties.Add(TEXT("TickRate"), TickRate);
+	SaveResult.Properties.Add(TEXT("RootInstances"), FlowSubsystem->GetRootInstances().Num());
+
+	const TSharedRef<FJsonObject> Report = MakeShared<FJsonObject>();
+	Report->SetNumberField(TEXT("Owners"), Owners);
+	Report->SetNumberField(TEXT("Depth"), Depth);
+	Report->SetStringField(TEXT("Asset"), RootFlow->GetPathName());
+	Report->SetNumberField(TEXT("Seconds"), Seconds);
+	Report->SetNumberField(TEXT("Frames"), Frames);
+	Report->SetNumberField(TEXT("SpawnSeconds"), SpawnTime);
+	Report->SetNumberField(TEXT("OwnersPerSecond"), SpawnTime > 0.0 ? Owners / SpawnTime : 0.0);
+	Report->SetNumberField(TEXT("NotifiesPerSecond"), TotalNotifyTime > 0.0 ? TotalNotifies / TotalNotifyTime : 0.0);
+	Report->SetNumberField(TEXT("TagChangesPerSecond"), TotalTagChurnTime > 0.0 ? TotalTagChanges / TotalTagChurnTime : 0.0);
+	Report->SetNumberField(TEXT("BaselineMemoryMB"), BaselineMemory);
+	Report->SetNumberField(TEXT("PeakMemoryMB"), PeakMemory);
+	Report->SetNumberField(TEXT("ProcessPeakMemoryMB"), static_cast<double>(FPlatformMemory::GetStats().PeakUsedPhysical) / (1024.0 * 1024.0));
+	Report->SetObjectField(TEXT("WorstFrame"), WorstFrame.ToJson());
+
+	Environment.Shutdown();
+
+	return FFlowBenchmarkResult::OutputReport(Params, Report, {FrameResult, SaveResult, GCResult}) ? 0 : 1;
+}
@@ -0,0 +1,184 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "FlowAllocationCounter.h"
+#include "FlowBenchmarkEnvironment.h"
+
+#include "FlowAsset.h"
+#include "FlowComponent.h"
+#include "FlowSubsystem.h"
+
+#include "Dom/JsonObject.h"
+#include "Engine/World.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Paths.h"
+#include "UObject/UObjectGlobals.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+struct FFlowAllocationBudgetCase
+{
+	FString Name;
+
+	// Maximum average number of allocations per operation
+	double Budget;
+
+	// Number of operations performed by a single Run, i.e. signals dispatched through a chain
+	int32 Operations;
+
+	TFunction<void()> Run;
+};
+
+/**
+ * Counts heap allocations made by steady-state Flow operations, and fails if any operation exceeds its budget
+ * Usage: UnrealEditor-Cmd <Project> -nullrhi -FlowCountAllocations -ExecCmds="Automation RunTests Flow.AllocationBudget; Quit"
+ * Without -FlowCountAllocations allocations can't be counted, and the test fails instead of reporting a false pass
+ * Budgets are allocations per operation, lower them whenever a path stops allocating, so it stays that way
+ * Measured counts are written in JSON to Saved/Automation/FlowAllocationBudget.json
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFlowAllocationBudgetTest, "Flow.AllocationBudget", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FFlowAllocationBudgetTest::RunTest(const FString& Parameters)
+{
+	// passing without counting anything would hide regressions, so the test fails if it can't measure
+	if (!FFlowScopedAllocationCounter::IsAllocatorInstalled())
+	{
+		AddError(TEXT("Flow allocation budgets weren't checked, the process has to run with -FlowCountAllocations"));
+		return false;
+	}
+
+	int32 Iterations = 100;
+	FParse::Value(FCommandLine::Get(), TEXT("FlowBenchmarkIterations="), Iterations);
+	Iterations = FMath::Max(1, Iterations);
+
+	FFlowBenchmarkEnvironment Environment;
+	if (!Environment.Initialize())
+	{
+		AddError(TEXT("Flow allocation budget test failed to create a world with Flow Subsystem"));
+		return false;
+	}
+
+	UFlowSubsystem* FlowSubsystem = Environment.GetFlowSubsystem();
+	const UWorld* World = Environment.GetWorld();
+	const FGameplayTag TagA = FFlowBenchmarkEnvironment::GetIdentityTag(0);
+	const FGameplayTag TagB = FFlowBenchmarkEnvironment::GetIdentityTag(1);
+	const FGameplayTag NotifierTag = FFlowBenchmarkEnvironment::GetIdentityTag(3);
+	const FGameplayTag ParentTag = FFlowBenchmarkEnvironment::GetIdentityParentTag();
+	const FGameplayTag NotifyTag = FFlowBenchmarkEnvironment::GetNotifyTag();
+
+	// signal dispatch: re-triggering Start of the running chain instance
+	constexpr int32 ChainLength = 10;
+	UFlowComponent* ChainOwner = Environment.SpawnFlowActor(FGameplayTagContainer());
+	FlowSubsystem->StartRootFlow(ChainOwner, Environment.CreateChainGraph(ChainLength));
+	UFlowNode* ChainStart = FlowSubsystem->GetRootFlow(ChainOwner)->GetDefaultEntryNode();
+
+	// registry: every component has two neighbouring tags, like in the Flow.Benchmark test
+	constexpr int32 RegisteredComponents = 100;
+	for (int32 i = 0; i < RegisteredComponents; i++)
+	{
+		FGameplayTagContainer IdentityTags;
+		IdentityTags.AddTag(FFlowBenchmarkEnvironment::GetIdentityTag(i % 2));
+		IdentityTags.AddTag(FFlowBenchmarkEnvironment::GetIdentityTag(i % 2 + 1));
+		Environment.SpawnFlowActor(IdentityTags);
+	}
+
+	FGameplayTagContainer PairTags;
+	PairTags.AddTag(TagA);
+	PairTags.AddTag(TagB);
+
+	// notify delivery: observers waiting for a single notifier
+	constexpr int32 Observers = 10;
+	UFlowComponent* Notifier = Environment.SpawnFlowActor(FGameplayTagContainer(NotifierTag));
+	UFlowAsset* ObserverGraph = Environment.CreateObserverGraph(1, NotifierTag, NotifyTag);
+	for (int32 i = 0; i < Observers; i++)
+	{
+		Environment.SpawnFlowActor(FGameplayTagContainer(), ObserverGraph);
+	}
+
+	TArray<FFlowAllocationBudgetCase> Cases = {
+		{TEXT("SignalDispatch"), 8.0, ChainLength, [&]() { FFlowBenchmarkEnvironment::TriggerInput(ChainStart, UFlowNode::DefaultInputPin.PinName); }},
+		{TEXT("FindComponents.Tag.Exact"), 32.0, 1, [&]() { FlowSubsystem->GetFlowComponentsByTagInWorld(World, TagA, UFlowComponent::StaticClass(), true); }},
+		{TEXT("FindComponents.Tag.Parent"), 32.0, 1, [&]() { FlowSubsystem->GetFlowComponentsByTagInWorld(World, ParentTag, UFlowComponent::StaticClass(), false); }},
+		{TEXT("FindComponents.Tags.Any.Exact"), 32.0, 1, [&]() { FlowSubsystem->GetFlowComponentsByTagsInWorld(World, PairTags, EGameplayContainerMatchType::Any, UFlowComponent::StaticClass(), true); }},
+		{TEXT("FindComponents.Tags.All.Exact"), 32.0, 1, [&]() { FlowSubsystem->GetFlowComponentsByTagsInWorld(World, PairTags, EGameplayContainerMatchType::All, UFlowComponent::StaticClass(), true); }},
+		// steady-state queries through visitors and inline allocated arrays shouldn't touch the heap at all
+		{TEXT("VisitComponents.Tag.Exact"), 0.01, 1, [&]() { FlowSubsystem->ForEachComponent<UFlowComponent>(TagA, [](UFlowComponent*) { return true; }); }},
+		{TEXT("VisitComponents.Tag.Parent"), 0.01, 1, [&]() { FlowSubsystem->ForEachComponent<UFlowComponent>(ParentTag, [](UFlowComponent*) { return true; }, false); }},
+		{TEXT("VisitComponents.Tags.Any.Exact"), 0.01, 1, [&]() { FlowSubsystem->ForEachComponent<UFlowComponent>(PairTags, EGameplayContainerMatchType::Any, [](UFlowComponent*) { return true; }); }},
+		{TEXT("VisitComponents.Tags.All.Exact"), 0.01, 1, [&]() { FlowSubsystem->ForEachComponent<UFlowComponent>(PairTags, EGameplayContainerMatchType::All, [](UFlowComponent*) { return true; }); }},
+		{TEXT("AnyComponentWithTag"), 0.01, 1, [&]() { FlowSubsystem->AnyComponentWithTag(TagA); }},
+		{TEXT("CountComponentsWithTag"), 0.01, 1, [&]() { FlowSubsystem->CountComponentsWithTag(ParentTag, false); }},
+		{TEXT("NotifyDelivery"), 12.0, Observers, [&]() { Notifier->NotifyGraph(NotifyTag); }}
+	};
+
+	// timer ticks: world tick isn't allocation-free on its own, so timers are measured against the tick of the same world without them
+	constexpr int32 Timers = 10;
+	constexpr float TickDelta = 1.0f / 30.0f;
+	FFlowAllocationBudgetCase WorldTick = {TEXT("WorldTick"), 0.0, 1, [&]() { Environment.Tick(TickDelta); }};
+	FFlowAllocationBudgetCase TimerTick = {TEXT("TimerTick"), 16.0, Timers, [&]() { Environment.Tick(TickDelta); }};
+
+	TArray<FFlowBenchmarkResult> Results;
+	bool bWithinBudget = true;
+
+	const auto Measure = [&](const FFlowAllocationBudgetCase& Case, const double BaselineAllocations = 0.0) -> double
+	{
+		// first run isn't measured, it warms up caches and containers
+		Case.Run();
+
+		FFlowBenchmarkResult Result(TEXT("Allocations.") + Case.Name);
+		uint64 Allocations = 0;
+		for (int32 i = 0; i < Iterations; i++)
+		{
+			const double StartTime = FPlatformTime::Seconds();
+			{
+				const FFlowScopedAllocationCounter Counter;
+				Case.Run();
+				Allocations += Counter.GetAllocations();
+			}
+			Result.Samples.Add(FPlatformTime::Seconds() - StartTime);
+		}
+
+		const double AllocationsPerRun = static_cast<double>(Allocations) / Iterations;
+		const double AllocationsPerOperation = FMath::Max(0.0, AllocationsPerRun - BaselineAllocations) / Case.Operations;
+
+		Result.Properties.Add(TEXT("Operations"), Case.Operations);
+		Result.Properties.Add(TEXT("AllocationsPerOperation"), AllocationsPerOperation);
+		Result.Properties.Add(TEXT("Budget"), Case.Budget);
+		Results.Add(MoveTemp(Result));
+
+		if (Case.Budget > 0.0 && AllocationsPerOperation > Case.Budget)
+		{
+			AddError(FString::Printf(TEXT("%s allocates %.2f times per operation, budget is %.2f"), *Case.Name, AllocationsPerOperation, Case.Budget));
+			bWithinBudget = false;
+		}
+		else
+		{
+			AddInfo(FString::Printf(TEXT("%s allocates %.2f times per operation"), *Case.Name, AllocationsPerOperation));
+		}
+
+		return AllocationsPerRun;
+	};
+
+	for (const FFlowAllocationBudgetCase& Case : Cases)
+	{
+		Measure(Case);
+	}
+
+	const double WorldTickAllocations = Measure(WorldTick);
+	for (int32 i = 0; i < Timers; i++)
+	{
+		Environment.SpawnFlowActor(FGameplayTagContainer(), Environment.CreateTimerGraph(TickDelta, 1));
+	}
+	Measure(TimerTick, WorldTickAllocations);
+
+	Environment.Shutdown();
+
+	const TSharedRef<FJsonObject> Report = MakeShared<FJsonObject>();
+	Report->SetNumberField(TEXT("Iterations"), Iterations);
+	Report->SetBoolField(TEXT("WithinBudget"), bWithinBudget);
+
+	const FString OutputFile = FPaths::Combine(FPaths::AutomationDir(), TEXT("FlowAllocationBudget.json"));
+	return FFlowBenchmarkResult::SaveReport(OutputFile, Report, Results) && bWithinBudget;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
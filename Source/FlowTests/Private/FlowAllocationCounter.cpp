@@ -0,0 +1,111 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "FlowAllocationCounter.h"
+
+#include "HAL/MemoryBase.h"
+
+static thread_local FFlowScopedAllocationCounter* ActiveCounter = nullptr;
+
+/**
+ * Forwards everything to the allocator it wraps, counting allocations of threads with an active counter
+ * It holds no per-block state, so blocks allocated before it was installed can be freed through it and the other way around
+ */
+class FFlowCountingMalloc final : public FMalloc
+{
+public:
+	explicit FFlowCountingMalloc(FMalloc* InInnerMalloc)
+		: InnerMalloc(InInnerMalloc)
+	{
+	}
+
+	virtual void* Malloc(SIZE_T Count, uint32 Alignment) override
+	{
+		CountAllocation();
+		return InnerMalloc->Malloc(Count, Alignment);
+	}
+
+	virtual void* TryMalloc(SIZE_T Count, uint32 Alignment) override
+	{
+		CountAllocation();
+		return InnerMalloc->TryMalloc(Count, Alignment);
+	}
+
+	virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override
+	{
+		// shrinking to zero is a free
+		if (Count > 0)
+		{
+			CountAllocation();
+		}
+		return InnerMalloc->Realloc(Original, Count, Alignment);
+	}
+
+	virtual void* TryRealloc(void* Original, SIZE_T Count, uint32 Alignment) override
+	{
+		if (Count > 0)
+		{
+			CountAllocation();
+		}
+		return InnerMalloc->TryRealloc(Original, Count, Alignment);
+	}
+
+	virtual void Free(void* Original) override { InnerMalloc->Free(Original); }
+	virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override { return InnerMalloc->QuantizeSize(Count, Alignment); }
+	virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override { return InnerMalloc->GetAllocationSize(Original, SizeOut); }
+	virtual void Trim(bool bTrimThreadCaches) override { InnerMalloc->Trim(bTrimThreadCaches); }
+	virtual void SetupTLSCachesOnCurrentThread() override { InnerMalloc->SetupTLSCachesOnCurrentThread(); }
+	virtual void ClearAndDisableTLSCachesOnCurrentThread() override { InnerMalloc->ClearAndDisableTLSCachesOnCurrentThread(); }
+	virtual void InitializeStatsMetadata() override { InnerMalloc->InitializeStatsMetadata(); }
+	virtual void UpdateStats() override { InnerMalloc->UpdateStats(); }
+	virtual void GetAllocatorStats(FGenericMemoryStats& OutStats) override { InnerMalloc->GetAllocatorStats(OutStats); }
+	virtual void DumpAllocatorStats(FOutputDevice& Ar) override { InnerMalloc->DumpAllocatorStats(Ar); }
+	virtual bool IsInternallyThreadSafe() const override { return InnerMalloc->IsInternallyThreadSafe(); }
+	virtual bool ValidateHeap() override { return InnerMalloc->ValidateHeap(); }
+	virtual const TCHAR* GetDescriptiveName() override { return InnerMalloc->GetDescriptiveName(); }
+
+private:
+	static void CountAllocation()
+	{
+		for (FFlowScopedAllocationCounter* Counter = ActiveCounter; Counter; Counter = Counter->OuterCounter)
+		{
+			Counter->Allocations++;
+		}
+	}
+
+	FMalloc* InnerMalloc;
+};
+
+static FFlowCountingMalloc* CountingMalloc = nullptr;
+
+FFlowScopedAllocationCounter::FFlowScopedAllocationCounter()
+	: Allocations(0)
+	, OuterCounter(ActiveCounter)
+{
+	ensureMsgf(IsAllocatorInstalled(), TEXT("Counting allocations requires -FlowCountAllocations"));
+	ActiveCounter = this;
+}
+
+FFlowScopedAllocationCounter::~FFlowScopedAllocationCounter()
+{
+	check(ActiveCounter == this);
+	ActiveCounter = OuterCounter;
+}
+
+void FFlowScopedAllocationCounter::InstallAllocator()
+{
+	check(IsInGameThread());
+
+	if (CountingMalloc == nullptr)
+	{
+		// never deleted, global allocator has to outlive every allocation made through it
+		CountingMalloc = new FFlowCountingMalloc(GMalloc);
+
+		// exchange publishes the fully constructed wrapper to threads allocating right now
+		FPlatformAtomics::InterlockedExchangePtr(reinterpret_cast<void**>(&GMalloc), CountingMalloc);
+	}
+}
+
+bool FFlowScopedAllocationCounter::IsAllocatorInstalled()
+{
+	return CountingMalloc != nullptr;
+}
@@ -0,0 +1,513 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "FlowBenchmarkEnvironment.h"
+#include "FlowTestsModule.h"
+
+#include "FlowAsset.h"
+#include "FlowComponent.h"
+#include "FlowSubsystem.h"
+#include "Nodes/Route/FlowNode_Counter.h"
+#include "Nodes/Route/FlowNode_ExecutionSequence.h"
+#include "Nodes/Route/FlowNode_Reroute.h"
+#include "Nodes/Route/FlowNode_Start.h"
+#include "Nodes/Route/FlowNode_SubGraph.h"
+#include "Nodes/Route/FlowNode_Timer.h"
+#include "Nodes/World/FlowNode_OnNotifyFromActor.h"
+
+#include "Dom/JsonObject.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/ViewportStatsSubsystem.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "GameFramework/WorldSettings.h"
+#include "Misc/EngineVersion.h"
+#include "Misc/FileHelper.h"
+#include "NativeGameplayTags.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "UObject/Package.h"
+
+UE_DEFINE_GAMEPLAY_TAG_STATIC(FlowBenchmark_Identity, "Flow.Benchmark.Identity");
+UE_DEFINE_GAMEPLAY_TAG_STATIC(FlowBenchmark_Identity_A, "Flow.Benchmark.Identity.A");
+UE_DEFINE_GAMEPLAY_TAG_STATIC(FlowBenchmark_Identity_B, "Flow.Benchmark.Identity.B");
+UE_DEFINE_GAMEPLAY_TAG_STATIC(FlowBenchmark_Identity_C, "Flow.Benchmark.Identity.C");
+UE_DEFINE_GAMEPLAY_TAG_STATIC(FlowBenchmark_Identity_D, "Flow.Benchmark.Identity.D");
+UE_DEFINE_GAMEPLAY_TAG_STATIC(FlowBenchmark_Notify, "Flow.Benchmark.Notify");
+
+//////////////////////////////////////////////////////////////////////////
+// Result
+
+double FFlowBenchmarkResult::GetPercentile(const double Percentile) const
+{
+	if (Samples.Num() == 0)
+	{
+		return 0.0;
+	}
+
+	TArray<double> Sorted = Samples;
+	Sorted.Sort();
+
+	const int32 Index = FMath::Clamp(FMath::CeilToInt(Percentile * Sorted.Num()) - 1, 0, Sorted.Num() - 1);
+	return Sorted[Index];
+}
+
+TSharedRef<FJsonObject> FFlowBenchmarkResult::ToJson() const
+{
+	double Sum = 0.0;
+	for (const double Sample : Samples)
+	{
+		Sum += Sample;
+	}
+
+	// reported in microseconds
+	const TSharedRef<FJsonObject> Json = MakeShared<FJsonObject>();
+	Json->SetStringField(TEXT("Name"), Name);
+	Json->SetNumberField(TEXT("Samples"), Samples.Num());
+	Json->SetNumberField(TEXT("MeanUs"), Samples.Num() > 0 ? Sum / Samples.Num() * 1000000.0 : 0.0);
+	Json->SetNumberField(TEXT("MinUs"), GetPercentile(0.0) * 1000000.0);
+	Json->SetNumberField(TEXT("P50Us"), GetPercentile(0.5) * 1000000.0);
+	Json->SetNumberField(TEXT("P90Us"), GetPercentile(0.9) * 1000000.0);
+	Json->SetNumberField(TEXT("P99Us"), GetPercentile(0.99) * 1000000.0);
+	Json->SetNumberField(TEXT("MaxUs"), GetPercentile(1.0) * 1000000.0);
+
+	for (const TPair<FString, double>& Property : Properties)
+	{
+		Json->SetNumberField(Property.Key, Property.Value);
+	}
+
+	return Json;
+}
+
+bool FFlowBenchmarkResult::OutputReport(const FString& Params, const TSharedRef<FJsonObject>& Report, const TArray<FFlowBenchmarkResult>& Results)
+{
+	FString OutputFile;
+	FParse::Value(*Params, TEXT("Output="), OutputFile);
+
+	return SaveReport(OutputFile, Report, Results);
+}
+
+bool FFlowBenchmarkResult::SaveReport(const FString& OutputFile, const TSharedRef<FJsonObject>& Report, const TArray<FFlowBenchmarkResult>& Results)
+{
+	Report->SetStringField(TEXT("EngineVersion"), FEngineVersion::Current().ToString());
+
+	TArray<TSharedPtr<FJsonValue>> ResultValues;
+	for (const FFlowBenchmarkResult& Result : Results)
+	{
+		ResultValues.Add(MakeShared<FJsonValueObject>(Result.ToJson()));
+	}
+	Report->SetArrayField(TEXT("Results"), ResultValues);
+
+	FString ReportString;
+	const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&ReportString);
+	FJsonSerializer::Serialize(Report, Writer);
+
+	if (!OutputFile.IsEmpty())
+	{
+		if (!FFileHelper::SaveStringToFile(ReportString, *OutputFile))
+		{
+			UE_LOG(LogFlowTests, Error, TEXT("Failed to write Flow benchmark report to %s"), *OutputFile);
+			return false;
+		}
+
+		UE_LOG(LogFlowTests, Display, TEXT("Flow benchmark report written to %s"), *OutputFile);
+	}
+	else
+	{
+		UE_LOG(LogFlowTests, Display, TEXT("%s"), *ReportString);
+	}
+
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Environment
+
+FFlowBenchmarkEnvironment::FFlowBenchmarkEnvironment()
+	: GameInstance(nullptr)
+{
+}
+
+FFlowBenchmarkEnvironment::~FFlowBenchmarkEnvironment()
+{
+	Shutdown();
+}
+
+bool FFlowBenchmarkEnvironment::Initialize()
+{
+	if (GEngine == nullptr)
+	{
+		UE_LOG(LogFlowTests, Error, TEXT("Flow benchmark requires the engine to be initialized"));
+		return false;
+	}
+
+	// creates a Game world without rendering, and initializes Game Instance subsystems
+	GameInstance = NewObject<UGameInstance>(GEngine);
+	GameInstance->InitializeStandalone();
+
+	UWorld* World = GameInstance->GetWorld();
+	if (World == nullptr || GetFlowSubsystem() == nullptr)
+	{
+		UE_LOG(LogFlowTests, Error, TEXT("Flow benchmark failed to create a world with Flow Subsystem"));
+		Shutdown();
+		return false;
+	}
+
+	// there's no Game Mode, so actors begin play directly
+	World->InitializeActorsForPlay(FURL());
+	World->GetWorldSettings()->NotifyBeginPlay();
+
+	return true;
+}
+
+void FFlowBenchmarkEnvironment::Shutdown()
+{
+	if (GameInstance)
+	{
+		UWorld* World = GameInstance->GetWorld();
+		GameInstance->Shutdown();
+
+		if (World)
+		{
+			World->BeginTearingDown();
+			GEngine->DestroyWorldContext(World);
+			World->DestroyWorld(false);
+		}
+
+		GameInstance = nullptr;
+	}
+
+	Assets.Empty();
+}
+
+UWorld* FFlowBenchmarkEnvironment::GetWorld() const
+{
+	return GameInstance ? GameInstance->GetWorld() : nullptr;
+}
+
+UFlowSubsystem* FFlowBenchmarkEnvironment::GetFlowSubsystem() const
+{
+	return GameInstance ? GameInstance->GetSubsystem<UFlowSubsystem>() : nullptr;
+}
+
+void FFlowBenchmarkEnvironment::Tick(const float DeltaSeconds) const
+{
+	if (UWorld* World = GetWorld())
+	{
+		// engine loop doesn't run while a commandlet or a test is running, and timer managers tick only once per frame
+		GFrameCounter++;
+		World->Tick(LEVELTICK_All, DeltaSeconds);
+	}
+}
+
+void FFlowBenchmarkEnvironment::AdvanceVirtualTime(const float DeltaSeconds) const
+{
+	if (UFlowSubsystem* FlowSubsystem = GetFlowSubsystem())
+	{
+		GFrameCounter++;
+		FlowSubsystem->AdvanceVirtualTime(DeltaSeconds);
+	}
+}
+
+void FFlowBenchmarkEnvironment::SampleRuntimeContainers(TMap<FString, FFlowBenchmarkMemorySample>& OutSamples) const
+{
+	FFlowBenchmarkMemorySample& RecordedNodes = OutSamples.Add(TEXT("RecordedNodes"));
+	FFlowBenchmarkMemorySample& PinRecords = OutSamples.Add(TEXT("PinRecords"));
+	FFlowBenchmarkMemorySample& ExecutedConnections = OutSamples.Add(TEXT("ExecutedConnections"));
+	FFlowBenchmarkMemorySample& DisplayDelegates = OutSamples.Add(TEXT("ViewportStatsDisplayDelegates"));
+
+	const UFlowSubsystem* FlowSubsystem = GetFlowSubsystem();
+	if (const TArray<UFlowAsset*>* InstancedTemplates = FlowSubsystem ? GetPropertyValue<TArray<UFlowAsset*>>(FlowSubsystem, TEXT("InstancedTemplates")) : nullptr)
+	{
+		for (const UFlowAsset* Template : *InstancedTemplates)
+		{
+			for (const UFlowAsset* Instance : Template->GetInstances())
+			{
+				RecordedNodes.Elements += Instance->GetRecordedNodes().Num();
+				RecordedNodes.Bytes += Instance->GetRecordedNodes().GetAllocatedSize();
+
+				for (const TPair<FGuid, UFlowNode*>& Node : Instance->GetNodes())
+				{
+#if !UE_BUILD_SHIPPING
+					for (const TMap<FName, TArray<FPinRecord>>* Records : {&Node.Value->GetInputRecords(), &Node.Value->GetOutputRecords()})
+					{
+						PinRecords.Bytes += Records->GetAllocatedSize();
+						for (const TPair<FName, TArray<FPinRecord>>& Record : *Records)
+						{
+							PinRecords.Elements += Record.Value.Num();
+							PinRecords.Bytes += Record.Value.GetAllocatedSize();
+						}
+					}
+#endif
+
+					if (const UFlowNode_ExecutionSequence* Sequence = Cast<UFlowNode_ExecutionSequence>(Node.Value))
+					{
+						const TSet<FGuid>& Executed = *GetPropertyValue<TSet<FGuid>>(Sequence, TEXT("ExecutedConnections"));
+						ExecutedConnections.Elements += Executed.Num();
+						ExecutedConnections.Bytes += Executed.GetAllocatedSize();
+					}
+				}
+			}
+		}
+	}
+
+	// subsystem doesn't expose its delegates, but a newly added delegate is appended at index equal to their number
+	if (UViewportStatsSubsystem* StatsSubsystem = GetWorld() ? GetWorld()->GetSubsystem<UViewportStatsSubsystem>() : nullptr)
+	{
+		const int32 ProbeIndex = StatsSubsystem->AddDisplayDelegate([](FText& OutText, FLinearColor& OutColor)
+		{
+			return false;
+		});
+		StatsSubsystem->RemoveDisplayDelegate(ProbeIndex);
+
+		DisplayDelegates.Elements = ProbeIndex;
+	}
+}
+
+void FFlowBenchmarkEnvironment::AddReferencedObjects(FReferenceCollector& Collector)
+{
+	Collector.AddReferencedObject(GameInstance);
+	Collector.AddReferencedObjects(Assets);
+}
+
+FString FFlowBenchmarkEnvironment::GetReferencerName() const
+{
+	return TEXT("FFlowBenchmarkEnvironment");
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Graphs
+
+UFlowAsset* FFlowBenchmarkEnvironment::CreateAsset(const FString& BaseName)
+{
+	const FName AssetName = MakeUniqueObjectName(GetTransientPackage(), UFlowAsset::StaticClass(), *BaseName);
+	UFlowAsset* FlowAsset = NewObject<UFlowAsset>(GetTransientPackage(), AssetName, RF_Transient);
+	Assets.Add(FlowAsset);
+	return FlowAsset;
+}
+
+UFlowNode* FFlowBenchmarkEnvironment::AddNode(UFlowAsset* FlowAsset, const TSubclassOf<UFlowNode> NodeClass) const
+{
+	UFlowNode* NewNode = NewObject<UFlowNode>(FlowAsset, NodeClass, NAME_None, RF_Transient);
+	NewNode->SetGuid(FGuid::NewGuid());
+	GetPropertyValue<TMap<FGuid, UFlowNode*>>(FlowAsset, TEXT("Nodes"))->Emplace(NewNode->GetGuid(), NewNode);
+	return NewNode;
+}
+
+void FFlowBenchmarkEnvironment::Connect(UFlowNode* From, const FName& OutputPin, const UFlowNode* To, const FName& InputPin)
+{
+	GetPropertyValue<TMap<FName, FConnectedPin>>(From, TEXT("Connections"))->Emplace(OutputPin, FConnectedPin(To->GetGuid(), InputPin));
+}
+
+void FFlowBenchmarkEnvironment::TriggerInput(UFlowNode* Node, const FName& PinName)
+{
+	Node->GetFlowAsset()->TriggerInput(Node->GetGuid(), PinName);
+}
+
+UFlowAsset* FFlowBenchmarkEnvironment::CreateChainGraph(const int32 Length)
+{
+	UFlowAsset* FlowAsset = CreateAsset(TEXT("FlowBenchmark_Chain"));
+
+	UFlowNode* Previous = AddNode(FlowAsset, UFlowNode_Start::StaticClass());
+	for (int32 i = 0; i < Length; i++)
+	{
+		UFlowNode* Reroute = AddNode(FlowAsset, UFlowNode_Reroute::StaticClass());
+		Connect(Previous, UFlowNode::DefaultOutputPin.PinName, Reroute, UFlowNode::DefaultInputPin.PinName);
+		Previous = Reroute;
+	}
+
+	return FlowAsset;
+}
+
+UFlowAsset* FFlowBenchmarkEnvironment::CreateFanGraph(const int32 Width)
+{
+	UFlowAsset* FlowAsset = CreateAsset(TEXT("FlowBenchmark_Fan"));
+
+	UFlowNode* Start = AddNode(FlowAsset, UFlowNode_Start::StaticClass());
+	UFlowNode* Sequence = AddNode(FlowAsset, UFlowNode_ExecutionSequence::StaticClass());
+	SetNodeProperty(Sequence, TEXT("bSavePinExecutionState"), false);
+	Connect(Start, UFlowNode::DefaultOutputPin.PinName, Sequence, UFlowNode::DefaultInputPin.PinName);
+
+	TArray<FFlowPin>& OutputPins = *GetPropertyValue<TArray<FFlowPin>>(Sequence, TEXT("OutputPins"));
+	OutputPins.Empty();
+	for (int32 i = 0; i < Width; i++)
+	{
+		const FName PinName = *FString::FromInt(i);
+		OutputPins.Emplace(PinName);
+
+		UFlowNode* Reroute = AddNode(FlowAsset, UFlowNode_Reroute::StaticClass());
+		Connect(Sequence, PinName, Reroute, UFlowNode::DefaultInputPin.PinName);
+	}
+
+	return FlowAsset;
+}
+
+UFlowAsset* FFlowBenchmarkEnvironment::CreateLoopGraph(const int32 Iterations)
+{
+	UFlowAsset* FlowAsset = CreateAsset(TEXT("FlowBenchmark_Loop"));
+
+	UFlowNode* Start = AddNode(FlowAsset, UFlowNode_Start::StaticClass());
+	UFlowNode* Counter = AddNode(FlowAsset, UFlowNode_Counter::StaticClass());
+	UFlowNode* Reroute = AddNode(FlowAsset, UFlowNode_Reroute::StaticClass());
+	SetNodeProperty(Counter, TEXT("Goal"), FMath::Max(2, Iterations));
+
+	Connect(Start, UFlowNode::DefaultOutputPin.PinName, Counter, TEXT("Increment"));
+	Connect(Counter, TEXT("Step"), Reroute, UFlowNode::DefaultInputPin.PinName);
+	Connect(Reroute, UFlowNode::DefaultOutputPin.PinName, Counter, TEXT("Increment"));
+
+	return FlowAsset;
+}
+
+UFlowAsset* FFlowBenchmarkEnvironment::CreateNestedGraph(const int32 Depth, const int32 Length)
+{
+	return CreateNestedGraph(Depth, CreateChainGraph(Length));
+}
+
+UFlowAsset* FFlowBenchmarkEnvironment::CreateNestedGraph(const int32 Depth, UFlowAsset* DeepestGraph)
+{
+	UFlowAsset* Child = DeepestGraph;
+
+	for (int32 Level = 0; Level < Depth; Level++)
+	{
+		UFlowAsset* FlowAsset = CreateAsset(TEXT("FlowBenchmark_Nested"));
+
+		UFlowNode* Start = AddNode(FlowAsset, UFlowNode_Start::StaticClass());
+		UFlowNode* SubGraph = AddNode(FlowAsset, UFlowNode_SubGraph::StaticClass());
+		SetNodeProperty(SubGraph, TEXT("Asset"), TSoftObjectPtr<UFlowAsset>(Child));
+		Connect(Start, UFlowNode::DefaultOutputPin.PinName, SubGraph, TEXT("Start"));
+
+		Child = FlowAsset;
+	}
+
+	return Child;
+}
+
+UFlowAsset* FFlowBenchmarkEnvironment::CreateObserverGraph(const int32 Observers, const FGameplayTag& IdentityTag, const FGameplayTag& NotifyTag)
+{
+	UFlowAsset* FlowAsset = CreateAsset(TEXT("FlowBenchmark_Observer"));
+
+	UFlowNode* Start = AddNode(FlowAsset, UFlowNode_Start::StaticClass());
+	UFlowNode* Sequence = AddNode(FlowAsset, UFlowNode_ExecutionSequence::StaticClass());
+	SetNodeProperty(Sequence, TEXT("bSavePinExecutionState"), false);
+	Connect(Start, UFlowNode::DefaultOutputPin.PinName, Sequence, UFlowNode::DefaultInputPin.PinName);
+
+	TArray<FFlowPin>& OutputPins = *GetPropertyValue<TArray<FFlowPin>>(Sequence, TEXT("OutputPins"));
+	OutputPins.Empty();
+	for (int32 i = 0; i < Observers; i++)
+	{
+		const FName PinName = *FString::FromInt(i);
+		OutputPins.Emplace(PinName);
+
+		UFlowNode* Observer = AddNode(FlowAsset, UFlowNode_OnNotifyFromActor::StaticClass());
+		SetNodeProperty(Observer, TEXT("IdentityTags"), FGameplayTagContainer(IdentityTag));
+		SetNodeProperty(Observer, TEXT("NotifyTags"), FGameplayTagContainer(NotifyTag));
+		SetNodeProperty(Observer, TEXT("SuccessLimit"), 0);
+		Connect(Sequence, PinName, Observer, UFlowNode::DefaultInputPin.PinName);
+	}
+
+	return FlowAsset;
+}
+
+UFlowAsset* FFlowBenchmarkEnvironment::CreateTimerGraph(const float StepTime, const int32 Length)
+{
+	UFlowAsset* FlowAsset = CreateAsset(TEXT("FlowBenchmark_Timer"));
+
+	UFlowNode* Start = AddNode(FlowAsset, UFlowNode_Start::StaticClass());
+	UFlowNode* Timer = AddNode(FlowAsset, UFlowNode_Timer::StaticClass());
+	SetNodeProperty(Timer, TEXT("CompletionTime"), MAX_flt);
+	SetNodeProperty(Timer, TEXT("StepTime"), StepTime);
+	Connect(Start, UFlowNode::DefaultOutputPin.PinName, Timer, UFlowNode::DefaultInputPin.PinName);
+
+	UFlowNode* Previous = Timer;
+	FName PreviousPin = TEXT("Step");
+	for (int32 i = 0; i < Length; i++)
+	{
+		UFlowNode* Reroute = AddNode(FlowAsset, UFlowNode_Reroute::StaticClass());
+		Connect(Previous, PreviousPin, Reroute, UFlowNode::DefaultInputPin.PinName);
+
+		Previous = Reroute;
+		PreviousPin = UFlowNode::DefaultOutputPin.PinName;
+	}
+
+	return FlowAsset;
+}
+
+UFlowAsset* FFlowBenchmarkEnvironment::CreateSequenceGraph(const float StepTime, const int32 Outputs)
+{
+	UFlowAsset* FlowAsset = CreateAsset(TEXT("FlowBenchmark_Sequence"));
+
+	UFlowNode* Start = AddNode(FlowAsset, UFlowNode_Start::StaticClass());
+	UFlowNode* Timer = AddNode(FlowAsset, UFlowNode_Timer::StaticClass());
+	UFlowNode* Sequence = AddNode(FlowAsset, UFlowNode_ExecutionSequence::StaticClass());
+	SetNodeProperty(Timer, TEXT("CompletionTime"), MAX_flt);
+	SetNodeProperty(Timer, TEXT("StepTime"), StepTime);
+	Connect(Start, UFlowNode::DefaultOutputPin.PinName, Timer, UFlowNode::DefaultInputPin.PinName);
+	Connect(Timer, TEXT("Step"), Sequence, UFlowNode::DefaultInputPin.PinName);
+
+	TArray<FFlowPin>& OutputPins = *GetPropertyValue<TArray<FFlowPin>>(Sequence, TEXT("OutputPins"));
+	OutputPins.Empty();
+	for (int32 i = 0; i < Outputs; i++)
+	{
+		const FName PinName = *FString::FromInt(i);
+		OutputPins.Emplace(PinName);
+
+		UFlowNode* Reroute = AddNode(FlowAsset, UFlowNode_Reroute::StaticClass());
+		Connect(Sequence, PinName, Reroute, UFlowNode::DefaultInputPin.PinName);
+	}
+
+	return FlowAsset;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Actors
+
+UFlowComponent* FFlowBenchmarkEnvironment::SpawnFlowActor(const FGameplayTagContainer& IdentityTags, UFlowAsset* RootFlow) const
+{
+	UWorld* World = GetWorld();
+	if (World == nullptr)
+	{
+		return nullptr;
+	}
+
+	AActor* Actor = World->SpawnActor<AActor>();
+	UFlowComponent* FlowComponent = NewObject<UFlowComponent>(Actor);
+	FlowComponent->IdentityTags = IdentityTags;
+	FlowComponent->RootFlow = RootFlow;
+	FlowComponent->bAutoStartRootFlow = RootFlow != nullptr;
+
+	// actor already begun play, so registering component calls its Begin Play
+	Actor->AddInstanceComponent(FlowComponent);
+	FlowComponent->RegisterComponent();
+
+	return FlowComponent;
+}
+
+int32 FFlowBenchmarkEnvironment::GetIdentityTagsNum()
+{
+	return 4;
+}
+
+FGameplayTag FFlowBenchmarkEnvironment::GetIdentityTag(const int32 Index)
+{
+	switch (Index % GetIdentityTagsNum())
+	{
+		case 0:
+			return FlowBenchmark_Identity_A;
+		case 1:
+			return FlowBenchmark_Identity_B;
+		case 2:
+			return FlowBenchmark_Identity_C;
+		default:
+			return FlowBenchmark_Identity_D;
+	}
+}
+
+FGameplayTag FFlowBenchmarkEnvironment::GetIdentityParentTag()
+{
+	return FlowBenchmark_Identity;
+}
+
+FGameplayTag FFlowBenchmarkEnvironment::GetNotifyTag()
+{
+	return FlowBenchmark_Notify;
+}
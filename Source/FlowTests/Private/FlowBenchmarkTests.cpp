@@ -0,0 +1,455 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "FlowBenchmarkEnvironment.h"
+
+#include "FlowAsset.h"
+#include "FlowComponent.h"
+#include "FlowSave.h"
+#include "FlowSubsystem.h"
+
+#include "Dom/JsonObject.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Paths.h"
+#include "UObject/StrongObjectPtr.h"
+#include "UObject/UObjectGlobals.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/**
+ * Size of benchmark cases, overridden from the command line
+ * i.e. -FlowBenchmarkIterations=1000 -FlowBenchmarkNodes=500 -FlowBenchmarkComponents=10000 -FlowBenchmarkGCNodes=100000
+ */
+struct FFlowBenchmarkSettings
+{
+	int32 Iterations = 200;
+	int32 Nodes = 100;
+	int32 Components = 1000;
+
+	// Nodes of running instances resident while measuring garbage collection
+	int32 GCNodes = 100000;
+
+	FFlowBenchmarkSettings()
+	{
+		const TCHAR* CommandLine = FCommandLine::Get();
+		FParse::Value(CommandLine, TEXT("FlowBenchmarkIterations="), Iterations);
+		FParse::Value(CommandLine, TEXT("FlowBenchmarkNodes="), Nodes);
+		FParse::Value(CommandLine, TEXT("FlowBenchmarkComponents="), Components);
+		FParse::Value(CommandLine, TEXT("FlowBenchmarkGCNodes="), GCNodes);
+		Iterations = FMath::Max(1, Iterations);
+		Nodes = FMath::Max(1, Nodes);
+		Components = FMath::Max(1, Components);
+		GCNodes = FMath::Max(1, GCNodes);
+	}
+};
+
+static void BenchmarkStartRootFlow(FFlowBenchmarkEnvironment& Environment, const FFlowBenchmarkSettings& Settings, TArray<FFlowBenchmarkResult>& OutResults)
+{
+	UFlowSubsystem* FlowSubsystem = Environment.GetFlowSubsystem();
+	UFlowComponent* Owner = Environment.SpawnFlowActor(FGameplayTagContainer());
+
+	const TArray<TPair<FString, UFlowAsset*>> Graphs = {
+		{TEXT("Chain"), Environment.CreateChainGraph(Settings.Nodes)},
+		{TEXT("Fan"), Environment.CreateFanGraph(FMath::Min(Settings.Nodes, 255))},
+		{TEXT("Nested"), Environment.CreateNestedGraph(4, FMath::Max(1, Settings.Nodes / 4))}
+	};
+
+	for (const TPair<FString, UFlowAsset*>& Graph : Graphs)
+	{
+		FFlowBenchmarkResult StartResult(TEXT("StartRootFlow.") + Graph.Key);
+		FFlowBenchmarkResult FinishResult(TEXT("FinishRootFlow.") + Graph.Key);
+
+		// first run isn't measured, it warms up caches and lazily created data
+		FlowSubsystem->StartRootFlow(Owner, Graph.Value);
+		FlowSubsystem->FinishRootFlow(Owner, Graph.Value, EFlowFinishPolicy::Keep);
+
+		for (int32 i = 0; i < Settings.Iterations; i++)
+		{
+			double StartTime = FPlatformTime::Seconds();
+			FlowSubsystem->StartRootFlow(Owner, Graph.Value);
+			StartResult.Samples.Add(FPlatformTime::Seconds() - StartTime);
+
+			StartTime = FPlatformTime::Seconds();
+			FlowSubsystem->FinishRootFlow(Owner, Graph.Value, EFlowFinishPolicy::Keep);
+			FinishResult.Samples.Add(FPlatformTime::Seconds() - StartTime);
+		}
+
+		OutResults.Add(MoveTemp(StartResult));
+		OutResults.Add(MoveTemp(FinishResult));
+
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	}
+
+	Owner->GetOwner()->Destroy();
+}
+
+static void BenchmarkSignals(FFlowBenchmarkEnvironment& Environment, const FFlowBenchmarkSettings& Settings, TArray<FFlowBenchmarkResult>& OutResults)
+{
+	UFlowSubsystem* FlowSubsystem = Environment.GetFlowSubsystem();
+	UFlowComponent* Owner = Environment.SpawnFlowActor(FGameplayTagContainer());
+
+	const TArray<TPair<FString, TPair<UFlowAsset*, int32>>> Graphs = {
+		{TEXT("Chain"), {Environment.CreateChainGraph(Settings.Nodes), FFlowBenchmarkEnvironment::GetChainSignals(Settings.Nodes)}},
+		{TEXT("Loop"), {Environment.CreateLoopGraph(Settings.Nodes), FFlowBenchmarkEnvironment::GetLoopSignals(FMath::Max(2, Settings.Nodes))}}
+	};
+
+	for (const TPair<FString, TPair<UFlowAsset*, int32>>& Graph : Graphs)
+	{
+		UFlowAsset* FlowAsset = Graph.Value.Key;
+		const int32 Signals = Graph.Value.Value;
+
+		FFlowBenchmarkResult Result(TEXT("Signals.") + Graph.Key);
+
+		// instance is created outside of measured region, and these graphs never finish it
+		// so every sample re-triggers the node connected to Start, the same signal Start would send
+		FlowSubsystem->StartRootFlow(Owner, FlowAsset);
+		const UFlowAsset* Instance = FlowSubsystem->GetRootFlow(Owner);
+		const FConnectedPin FirstSignal = Instance->GetDefaultEntryNode()->GetConnection(UFlowNode::DefaultOutputPin.PinName);
+		UFlowNode* FirstNode = Instance->GetNode(FirstSignal.NodeGuid);
+
+		for (int32 i = 0; i < Settings.Iterations; i++)
+		{
+			const double StartTime = FPlatformTime::Seconds();
+			FFlowBenchmarkEnvironment::TriggerInput(FirstNode, FirstSignal.PinName);
+			Result.Samples.Add(FPlatformTime::Seconds() - StartTime);
+		}
+
+		FlowSubsystem->FinishRootFlow(Owner, FlowAsset, EFlowFinishPolicy::Keep);
+
+		Result.Properties.Add(TEXT("Signals"), Signals);
+		Result.Properties.Add(TEXT("P50NsPerSignal"), Result.GetPercentile(0.5) / Signals * 1000000000.0);
+		OutResults.Add(MoveTemp(Result));
+
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	}
+
+	Owner->GetOwner()->Destroy();
+}
+
+static void BenchmarkRegistry(FFlowBenchmarkEnvironment& Environment, const FFlowBenchmarkSettings& Settings, TArray<FFlowBenchmarkResult>& OutResults)
+{
+	UFlowSubsystem* FlowSubsystem = Environment.GetFlowSubsystem();
+	const UWorld* World = Environment.GetWorld();
+
+	// every component has two neighbouring tags, so All queries have something to match
+	TArray<UFlowComponent*> SpawnedComponents;
+	for (int32 i = 0; i < Settings.Components; i++)
+	{
+		FGameplayTagContainer IdentityTags;
+		IdentityTags.AddTag(FFlowBenchmarkEnvironment::GetIdentityTag(i));
+		IdentityTags.AddTag(FFlowBenchmarkEnvironment::GetIdentityTag(i + 1));
+		SpawnedComponents.Add(Environment.SpawnFlowActor(IdentityTags));
+	}
+
+	const FGameplayTag TagA = FFlowBenchmarkEnvironment::GetIdentityTag(0);
+	const FGameplayTag TagC = FFlowBenchmarkEnvironment::GetIdentityTag(2);
+	const FGameplayTag ParentTag = FFlowBenchmarkEnvironment::GetIdentityParentTag();
+
+	FGameplayTagContainer PairTags;
+	PairTags.AddTag(TagA);
+	PairTags.AddTag(FFlowBenchmarkEnvironment::GetIdentityTag(1));
+
+	FGameplayTagContainer DisjointTags;
+	DisjointTags.AddTag(TagA);
+	DisjointTags.AddTag(TagC);
+
+	struct FRegistryQuery
+	{
+		FString Name;
+		TFunction<int32()> Run;
+
+		// Reference result, computed from Identity Tags of every spawned component
+		TFunction<bool(const FGameplayTagContainer&)> Matches;
+	};
+
+	const TArray<FRegistryQuery> Queries = {
+		{TEXT("Tag.Exact"), [&]() { return FlowSubsystem->GetFlowComponentsByTagInWorld(World, TagA, UFlowComponent::StaticClass(), true).Num(); }, [&](const FGameplayTagContainer& Tags) { return Tags.HasTagExact(TagA); }},
+		{TEXT("Tag.Parent"), [&]() { return FlowSubsystem->GetFlowComponentsByTagInWorld(World, ParentTag, UFlowComponent::StaticClass(), false).Num(); }, [&](const FGameplayTagContainer& Tags) { return Tags.HasTag(ParentTag); }},
+		{TEXT("Tags.Any.Exact"), [&]() { return FlowSubsystem->GetFlowComponentsByTagsInWorld(World, DisjointTags, EGameplayContainerMatchType::Any, UFlowComponent::StaticClass(), true).Num(); }, [&](const FGameplayTagContainer& Tags) { return Tags.HasAnyExact(DisjointTags); }},
+		{TEXT("Tags.All.Exact"), [&]() { return FlowSubsystem->GetFlowComponentsByTagsInWorld(World, PairTags, EGameplayContainerMatchType::All, UFlowComponent::StaticClass(), true).Num(); }, [&](const FGameplayTagContainer& Tags) { return Tags.HasAllExact(PairTags); }},
+		{TEXT("Tags.Any.Parent"), [&]() { return FlowSubsystem->GetFlowComponentsByTagsInWorld(World, FGameplayTagContainer(ParentTag), EGameplayContainerMatchType::Any, UFlowComponent::StaticClass(), false).Num(); }, [&](const FGameplayTagContainer& Tags) { return Tags.HasTag(ParentTag); }},
+		{TEXT("Actors.Tag.Exact"), [&]() { return FlowSubsystem->GetFlowActorsByTagInWorld(World, TagA, AActor::StaticClass(), true).Num(); }, [&](const FGameplayTagContainer& Tags) { return Tags.HasTagExact(TagA); }},
+		{TEXT("Count.Tag.Exact"), [&]() { return FlowSubsystem->CountComponentsWithTag(TagA, true); }, [&](const FGameplayTagContainer& Tags) { return Tags.HasTagExact(TagA); }},
+		{TEXT("Count.Tag.Parent"), [&]() { return FlowSubsystem->CountComponentsWithTag(ParentTag, false); }, [&](const FGameplayTagContainer& Tags) { return Tags.HasTag(ParentTag); }}
+	};
+
+	for (const FRegistryQuery& Query : Queries)
+	{
+		int32 Expected = 0;
+		for (const UFlowComponent* Component : SpawnedComponents)
+		{
+			Expected += Query.Matches(Component->IdentityTags) ? 1 : 0;
+		}
+
+		FFlowBenchmarkResult Result(TEXT("FindComponents.") + Query.Name);
+		int32 Found = Query.Run();
+
+		for (int32 i = 0; i < Settings.Iterations; i++)
+		{
+			const double StartTime = FPlatformTime::Seconds();
+			Found = Query.Run();
+			Result.Samples.Add(FPlatformTime::Seconds() - StartTime);
+		}
+
+		Result.Properties.Add(TEXT("Components"), Settings.Components);
+		Result.Properties.Add(TEXT("Found"), Found);
+		Result.Properties.Add(TEXT("Expected"), Expected);
+		OutResults.Add(MoveTemp(Result));
+	}
+
+	for (UFlowComponent* Component : SpawnedComponents)
+	{
+		Component->GetOwner()->Destroy();
+	}
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+}
+
+static void BenchmarkSaveGame(FFlowBenchmarkEnvironment& Environment, const FFlowBenchmarkSettings& Settings, TArray<FFlowBenchmarkResult>& OutResults)
+{
+	UFlowSubsystem* FlowSubsystem = Environment.GetFlowSubsystem();
+	const FGameplayTag IdentityTag = FFlowBenchmarkEnvironment::GetIdentityTag(0);
+
+	// every owner runs a graph with nodes waiting for notifies, so there's some active state to save
+	UFlowAsset* ObserverGraph = Environment.CreateObserverGraph(8, IdentityTag, FFlowBenchmarkEnvironment::GetNotifyTag());
+	const int32 Owners = FMath::Min(Settings.Components, 100);
+
+	TArray<UFlowComponent*> SpawnedComponents;
+	for (int32 i = 0; i < Owners; i++)
+	{
+		SpawnedComponents.Add(Environment.SpawnFlowActor(FGameplayTagContainer(IdentityTag), ObserverGraph));
+	}
+
+	FFlowBenchmarkResult SaveResult(TEXT("OnGameSaved"));
+	FFlowBenchmarkResult LoadResult(TEXT("LoadRootFlow"));
+	int32 SavedBytes = 0;
+
+	for (int32 i = 0; i < Settings.Iterations; i++)
+	{
+		// garbage is collected between saving and loading
+		const TStrongObjectPtr<UFlowSaveGame> SaveGame(NewObject<UFlowSaveGame>());
+
+		double StartTime = FPlatformTime::Seconds();
+		FlowSubsystem->OnGameSaved(SaveGame.Get());
+		SaveResult.Samples.Add(FPlatformTime::Seconds() - StartTime);
+
+		SavedBytes = 0;
+		for (const FFlowAssetSaveData& AssetRecord : SaveGame->FlowInstances)
+		{
+			SavedBytes += AssetRecord.AssetData.Num();
+			for (const FFlowNodeSaveData& NodeRecord : AssetRecord.NodeRecords)
+			{
+				SavedBytes += NodeRecord.NodeData.Num();
+			}
+		}
+
+		// loaded instances reuse saved names, so previous instances have to be gone
+		for (UFlowComponent* Component : SpawnedComponents)
+		{
+			Component->FinishRootFlow(ObserverGraph, EFlowFinishPolicy::Keep);
+		}
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+
+		StartTime = FPlatformTime::Seconds();
+		FlowSubsystem->OnGameLoaded(SaveGame.Get());
+		for (UFlowComponent* Component : SpawnedComponents)
+		{
+			Component->LoadInstance();
+			Component->LoadRootFlow();
+		}
+		LoadResult.Samples.Add(FPlatformTime::Seconds() - StartTime);
+	}
+
+	SaveResult.Properties.Add(TEXT("Owners"), Owners);
+	SaveResult.Properties.Add(TEXT("SavedBytes"), SavedBytes);
+	LoadResult.Properties.Add(TEXT("Owners"), Owners);
+	OutResults.Add(MoveTemp(SaveResult));
+	OutResults.Add(MoveTemp(LoadResult));
+
+	for (UFlowComponent* Component : SpawnedComponents)
+	{
+		Component->GetOwner()->Destroy();
+	}
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+}
+
+static void BenchmarkContextAccess(FFlowBenchmarkEnvironment& Environment, const FFlowBenchmarkSettings& Settings, TArray<FFlowBenchmarkResult>& OutResults)
+{
+	UFlowSubsystem* FlowSubsystem = Environment.GetFlowSubsystem();
+	UFlowComponent* Owner = Environment.SpawnFlowActor(FGameplayTagContainer());
+	UFlowAsset* FlowAsset = Environment.CreateChainGraph(1);
+	FlowSubsystem->StartRootFlow(Owner, FlowAsset);
+	const UFlowNode* Node = FlowSubsystem->GetRootFlow(Owner)->GetDefaultEntryNode();
+
+	// single access is too short to be timed, so every sample repeats it
+	constexpr int32 Accesses = 10000;
+
+	// cached accessors compared with walking object relationships, like accessors did before caching
+	const TArray<TPair<FString, TFunction<const void*()>>> Accessors = {
+		{TEXT("Node.GetWorld"), [Node]() -> const void* { return Node->GetWorld(); }},
+		{TEXT("Node.GetWorld.Walk"), [Node]() -> const void* { return Node->GetFlowAsset()->GetFlowSubsystem()->GetWorld(); }},
+		{TEXT("Node.GetFlowSubsystem"), [Node]() -> const void* { return Node->GetFlowSubsystem(); }},
+		{TEXT("Node.GetFlowSubsystem.Walk"), [Node]() -> const void* { return Node->GetFlowAsset()->GetFlowSubsystem(); }},
+		{TEXT("Node.GetFlowOwnerInterface"), [Node]() -> const void* { return Node->GetFlowOwnerInterface(); }},
+		{TEXT("Component.GetFlowSubsystem"), [Owner]() -> const void* { return Owner->GetFlowSubsystem(); }},
+		{TEXT("Component.GetFlowSubsystem.Walk"), [Owner]() -> const void* { return Owner->GetWorld()->GetGameInstance()->GetSubsystem<UFlowSubsystem>(); }}
+	};
+
+	for (const TPair<FString, TFunction<const void*()>>& Accessor : Accessors)
+	{
+		FFlowBenchmarkResult Result(TEXT("Context.") + Accessor.Key);
+		const void* volatile Found = Accessor.Value();
+
+		for (int32 i = 0; i < Settings.Iterations; i++)
+		{
+			const double StartTime = FPlatformTime::Seconds();
+			for (int32 j = 0; j < Accesses; j++)
+			{
+				Found = Accessor.Value();
+			}
+			Result.Samples.Add(FPlatformTime::Seconds() - StartTime);
+		}
+
+		Result.Properties.Add(TEXT("Accesses"), Accesses);
+		Result.Properties.Add(TEXT("P50NsPerAccess"), Result.GetPercentile(0.5) / Accesses * 1000000000.0);
+		OutResults.Add(MoveTemp(Result));
+	}
+
+	FlowSubsystem->FinishRootFlow(Owner, FlowAsset, EFlowFinishPolicy::Keep);
+	Owner->GetOwner()->Destroy();
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+}
+
+static void BenchmarkGarbageCollection(FFlowBenchmarkEnvironment& Environment, const FFlowBenchmarkSettings& Settings, TArray<FFlowBenchmarkResult>& OutResults)
+{
+	// timer graphs never complete, so every instance and its nodes stay resident while collecting garbage
+	constexpr float StepTime = 1000.0f;
+	const int32 NodesPerGraph = FMath::Clamp(Settings.Nodes, 1, Settings.GCNodes);
+	UFlowAsset* FlowAsset = Environment.CreateTimerGraph(StepTime, NodesPerGraph);
+	const int32 InstanceNodes = FlowAsset->GetNodes().Num();
+	const int32 Instances = FMath::Max(1, Settings.GCNodes / InstanceNodes);
+
+	// baseline of the same world without Flow instances, so the result isolates objects added by Flow
+	FFlowBenchmarkResult BaselineResult(TEXT("GarbageCollection.Baseline"));
+	for (int32 i = 0; i < Settings.Iterations; i++)
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+		BaselineResult.Samples.Add(FPlatformTime::Seconds() - StartTime);
+	}
+	OutResults.Add(MoveTemp(BaselineResult));
+
+	TArray<UFlowComponent*> Owners;
+	for (int32 i = 0; i < Instances; i++)
+	{
+		Owners.Add(Environment.SpawnFlowActor(FGameplayTagContainer(), FlowAsset));
+	}
+
+	// nothing is unreachable, so the collection time is the cost of reachability analysis
+	FFlowBenchmarkResult Result(TEXT("GarbageCollection.Instances"));
+	for (int32 i = 0; i < Settings.Iterations; i++)
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+		Result.Samples.Add(FPlatformTime::Seconds() - StartTime);
+	}
+
+	Result.Properties.Add(TEXT("Instances"), Instances);
+	Result.Properties.Add(TEXT("Nodes"), Instances * InstanceNodes);
+	Result.Properties.Add(TEXT("Objects"), GUObjectArray.GetObjectArrayNumMinusAvailable());
+	OutResults.Add(MoveTemp(Result));
+
+	for (UFlowComponent* Owner : Owners)
+	{
+		Owner->GetOwner()->Destroy();
+	}
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Tests
+
+typedef void (*FFlowBenchmarkCase)(FFlowBenchmarkEnvironment&, const FFlowBenchmarkSettings&, TArray<FFlowBenchmarkResult>&);
+
+static const TArray<TPair<FString, FFlowBenchmarkCase>>& GetBenchmarkCases()
+{
+	static const TArray<TPair<FString, FFlowBenchmarkCase>> Cases = {
+		{TEXT("StartRootFlow"), &BenchmarkStartRootFlow},
+		{TEXT("Signals"), &BenchmarkSignals},
+		{TEXT("Registry"), &BenchmarkRegistry},
+		{TEXT("SaveGame"), &BenchmarkSaveGame},
+		{TEXT("ContextAccess"), &BenchmarkContextAccess},
+		{TEXT("GarbageCollection"), &BenchmarkGarbageCollection}
+	};
+	return Cases;
+}
+
+/**
+ * Measures cost of Flow runtime operations on synthetic graphs, in a game world without rendering
+ * Usage: UnrealEditor-Cmd <Project> -nullrhi -ExecCmds="Automation RunTests Flow.Benchmark; Quit"
+ * Every case writes percentiles in JSON to Saved/Automation/FlowBenchmark/<Case>.json
+ */
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(FFlowBenchmarkTest, "Flow.Benchmark", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+void FFlowBenchmarkTest::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+	for (const TPair<FString, FFlowBenchmarkCase>& Case : GetBenchmarkCases())
+	{
+		OutBeautifiedNames.Add(Case.Key);
+		OutTestCommands.Add(Case.Key);
+	}
+}
+
+bool FFlowBenchmarkTest::RunTest(const FString& Parameters)
+{
+	const TPair<FString, FFlowBenchmarkCase>* Case = GetBenchmarkCases().FindByPredicate([&Parameters](const TPair<FString, FFlowBenchmarkCase>& Entry)
+	{
+		return Entry.Key == Parameters;
+	});
+	if (Case == nullptr)
+	{
+		AddError(FString::Printf(TEXT("Unknown Flow benchmark case %s"), *Parameters));
+		return false;
+	}
+
+	FFlowBenchmarkEnvironment Environment;
+	if (!Environment.Initialize())
+	{
+		AddError(TEXT("Flow benchmark failed to create a world with Flow Subsystem"));
+		return false;
+	}
+
+	const FFlowBenchmarkSettings Settings;
+	TArray<FFlowBenchmarkResult> Results;
+	Case->Value(Environment, Settings, Results);
+
+	Environment.Shutdown();
+
+	bool bResultsValid = true;
+	for (const FFlowBenchmarkResult& Result : Results)
+	{
+		// timing of a query is meaningless if the query returns wrong results
+		const double* Found = Result.Properties.Find(TEXT("Found"));
+		const double* Expected = Result.Properties.Find(TEXT("Expected"));
+		if (Found && Expected && *Found != *Expected)
+		{
+			AddError(FString::Printf(TEXT("%s found %d results, expected %d"), *Result.Name, static_cast<int32>(*Found), static_cast<int32>(*Expected)));
+			bResultsValid = false;
+		}
+
+		AddInfo(FString::Printf(TEXT("%s: P50 %.2f us, P90 %.2f us, P99 %.2f us"), *Result.Name, Result.GetPercentile(0.5) * 1000000.0, Result.GetPercentile(0.9) * 1000000.0, Result.GetPercentile(0.99) * 1000000.0));
+	}
+
+	const TSharedRef<FJsonObject> Report = MakeShared<FJsonObject>();
+	Report->SetNumberField(TEXT("Iterations"), Settings.Iterations);
+	Report->SetNumberField(TEXT("Nodes"), Settings.Nodes);
+	Report->SetNumberField(TEXT("Components"), Settings.Components);
+	Report->SetNumberField(TEXT("GCNodes"), Settings.GCNodes);
+
+	const FString OutputFile = FPaths::Combine(FPaths::AutomationDir(), TEXT("FlowBenchmark"), Case->Key + TEXT(".json"));
+	return FFlowBenchmarkResult::SaveReport(OutputFile, Report, Results) && bResultsValid;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,157 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "FlowBenchmarkEnvironment.h"
+
+#include "FlowComponent.h"
+#include "FlowComponentRegistry.h"
+#include "FlowSubsystem.h"
+
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/**
+ * Verifies results of Flow Component registry queries against a few components with known Identity Tags
+ * Usage: UnrealEditor-Cmd <Project> -nullrhi -ExecCmds="Automation RunTests Flow.Registry; Quit"
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFlowRegistryTest, "Flow.Registry", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FFlowRegistryTest::RunTest(const FString& Parameters)
+{
+	FFlowBenchmarkEnvironment Environment;
+	if (!Environment.Initialize())
+	{
+		AddError(TEXT("Flow registry test failed to create a world with Flow Subsystem"));
+		return false;
+	}
+
+	UFlowSubsystem* FlowSubsystem = Environment.GetFlowSubsystem();
+	const UWorld* World = Environment.GetWorld();
+	const FGameplayTag TagA = FFlowBenchmarkEnvironment::GetIdentityTag(0);
+	const FGameplayTag TagB = FFlowBenchmarkEnvironment::GetIdentityTag(1);
+	const FGameplayTag TagC = FFlowBenchmarkEnvironment::GetIdentityTag(2);
+	const FGameplayTag TagD = FFlowBenchmarkEnvironment::GetIdentityTag(3);
+	const FGameplayTag ParentTag = FFlowBenchmarkEnvironment::GetIdentityParentTag();
+
+	// A and B are siblings, so SiblingsOwner is indexed twice under their parent
+	FGameplayTagContainer SiblingTags;
+	SiblingTags.AddTag(TagA);
+	SiblingTags.AddTag(TagB);
+
+	UFlowComponent* OwnerA = Environment.SpawnFlowActor(FGameplayTagContainer(TagA));
+	UFlowComponent* SiblingsOwner = Environment.SpawnFlowActor(SiblingTags);
+	UFlowComponent* OwnerC = Environment.SpawnFlowActor(FGameplayTagContainer(TagC));
+
+	const auto MakeTags = [](const FGameplayTag& First, const FGameplayTag& Second)
+	{
+		FGameplayTagContainer Tags(First);
+		Tags.AddTag(Second);
+		return Tags;
+	};
+
+	const auto TestComponents = [this](const TCHAR* Query, const TSet<UFlowComponent*>& Found, const TSet<UFlowComponent*>& Expected)
+	{
+		if (Found.Num() != Expected.Num() || Found.Difference(Expected).Num() > 0)
+		{
+			AddError(FString::Printf(TEXT("%s found %d components, expected %d"), Query, Found.Num(), Expected.Num()));
+		}
+	};
+
+	const auto TestCount = [this](const TCHAR* Query, const int32 Found, const int32 Expected)
+	{
+		if (Found != Expected)
+		{
+			AddError(FString::Printf(TEXT("%s returned %d, expected %d"), Query, Found, Expected));
+		}
+	};
+
+	const TSubclassOf<UFlowComponent> ComponentClass = UFlowComponent::StaticClass();
+
+	// single tag
+	TestComponents(TEXT("Tag A exact"), FlowSubsystem->GetFlowComponentsByTagInWorld(World, TagA, ComponentClass, true), {OwnerA, SiblingsOwner});
+	TestComponents(TEXT("Tag B exact"), FlowSubsystem->GetFlowComponentsByTagInWorld(World, TagB, ComponentClass, true), {SiblingsOwner});
+	TestComponents(TEXT("Tag D exact"), FlowSubsystem->GetFlowComponentsByTagInWorld(World, TagD, ComponentClass, true), {});
+	TestComponents(TEXT("Parent tag exact"), FlowSubsystem->GetFlowComponentsByTagInWorld(World, ParentTag, ComponentClass, true), {});
+	TestComponents(TEXT("Parent tag"), FlowSubsystem->GetFlowComponentsByTagInWorld(World, ParentTag, ComponentClass, false), {OwnerA, SiblingsOwner, OwnerC});
+	TestComponents(TEXT("Tag A"), FlowSubsystem->GetFlowComponentsByTagInWorld(World, TagA, ComponentClass, false), {OwnerA, SiblingsOwner});
+
+	// component with sibling tags is counted once under the parent
+	TestCount(TEXT("Count of parent tag"), FlowSubsystem->CountComponentsWithTag(ParentTag, false), 3);
+	TestCount(TEXT("Bucket of parent tag"), FlowSubsystem->GetBucketSize(ParentTag, false), 3);
+	TestCount(TEXT("Bucket of tag A exact"), FlowSubsystem->GetBucketSize(TagA, true), 2);
+
+	// Any
+	TestComponents(TEXT("Any of A, B exact"), FlowSubsystem->GetFlowComponentsByTagsInWorld(World, SiblingTags, EGameplayContainerMatchType::Any, ComponentClass, true), {OwnerA, SiblingsOwner});
+	TestComponents(TEXT("Any of A, C exact"), FlowSubsystem->GetFlowComponentsByTagsInWorld(World, MakeTags(TagA, TagC), EGameplayContainerMatchType::Any, ComponentClass, true), {OwnerA, SiblingsOwner, OwnerC});
+	TestComponents(TEXT("Any of parent, D exact"), FlowSubsystem->GetFlowComponentsByTagsInWorld(World, MakeTags(ParentTag, TagD), EGameplayContainerMatchType::Any, ComponentClass, true), {});
+	TestComponents(TEXT("Any of parent, A"), FlowSubsystem->GetFlowComponentsByTagsInWorld(World, MakeTags(ParentTag, TagA), EGameplayContainerMatchType::Any, ComponentClass, false), {OwnerA, SiblingsOwner, OwnerC});
+
+	// All
+	TestComponents(TEXT("All of A, B exact"), FlowSubsystem->GetFlowComponentsByTagsInWorld(World, SiblingTags, EGameplayContainerMatchType::All, ComponentClass, true), {SiblingsOwner});
+	TestComponents(TEXT("All of A, C exact"), FlowSubsystem->GetFlowComponentsByTagsInWorld(World, MakeTags(TagA, TagC), EGameplayContainerMatchType::All, ComponentClass, true), {});
+	TestComponents(TEXT("All of parent, A exact"), FlowSubsystem->GetFlowComponentsByTagsInWorld(World, MakeTags(ParentTag, TagA), EGameplayContainerMatchType::All, ComponentClass, true), {});
+	TestComponents(TEXT("All of parent, A"), FlowSubsystem->GetFlowComponentsByTagsInWorld(World, MakeTags(ParentTag, TagA), EGameplayContainerMatchType::All, ComponentClass, false), {OwnerA, SiblingsOwner});
+	TestComponents(TEXT("All of parent, B"), FlowSubsystem->GetFlowComponentsByTagsInWorld(World, MakeTags(ParentTag, TagB), EGameplayContainerMatchType::All, ComponentClass, false), {SiblingsOwner});
+
+	// removing one of sibling tags keeps the component under the parent
+	SiblingsOwner->RemoveIdentityTag(TagB);
+	TestComponents(TEXT("Tag B exact after removal"), FlowSubsystem->GetFlowComponentsByTagInWorld(World, TagB, ComponentClass, true), {});
+	TestComponents(TEXT("Parent tag after removal of B"), FlowSubsystem->GetFlowComponentsByTagInWorld(World, ParentTag, ComponentClass, false), {OwnerA, SiblingsOwner, OwnerC});
+	TestCount(TEXT("Bucket of parent tag after removal of B"), FlowSubsystem->GetBucketSize(ParentTag, false), 3);
+
+	SiblingsOwner->RemoveIdentityTag(TagA);
+	TestComponents(TEXT("Parent tag after removal of A"), FlowSubsystem->GetFlowComponentsByTagInWorld(World, ParentTag, ComponentClass, false), {OwnerA, OwnerC});
+	TestCount(TEXT("Bucket of parent tag after removal of A"), FlowSubsystem->GetBucketSize(ParentTag, false), 2);
+
+	// unregistered components leave no entries behind
+	OwnerA->GetOwner()->Destroy();
+	OwnerC->GetOwner()->Destroy();
+	TestCount(TEXT("Count of parent tag after unregistering"), FlowSubsystem->CountComponentsWithTag(ParentTag, false), 0);
+	TestCount(TEXT("Bucket of parent tag after unregistering"), FlowSubsystem->GetBucketSize(ParentTag, false), 0);
+	TestCount(TEXT("Bucket of tag A exact after unregistering"), FlowSubsystem->GetBucketSize(TagA, true), 0);
+	if (FlowSubsystem->AnyComponentWithTag(ParentTag, false))
+	{
+		AddError(TEXT("Component with parent tag found after unregistering all components"));
+	}
+
+	// query matching All tags scans only the smallest bucket, and none if any tag has no components
+	{
+		// bucket of A holds three components, bucket of B only one
+		FFlowComponentRegistry Registry;
+		Registry.Add(SiblingTags, Environment.SpawnFlowActor(SiblingTags));
+		Registry.Add(TagA, Environment.SpawnFlowActor(FGameplayTagContainer(TagA)));
+		Registry.Add(TagA, Environment.SpawnFlowActor(FGameplayTagContainer(TagA)));
+
+		const auto TestSmallestBucket = [this, &Registry](const TCHAR* Query, const FGameplayTagContainer& Tags, const bool bExactMatch, const FGameplayTag& ExpectedTag)
+		{
+			const int32 Index = Registry.FindSmallestBucket(Tags, bExactMatch);
+			const FGameplayTag ScannedTag = Index == INDEX_NONE ? FGameplayTag() : Tags.GetByIndex(Index);
+			if (ScannedTag != ExpectedTag)
+			{
+				AddError(FString::Printf(TEXT("%s scans bucket of %s, expected %s"), Query, *ScannedTag.ToString(), *ExpectedTag.ToString()));
+			}
+		};
+
+		TestSmallestBucket(TEXT("All of A, B exact"), MakeTags(TagA, TagB), true, TagB);
+		TestSmallestBucket(TEXT("All of B, A exact"), MakeTags(TagB, TagA), true, TagB);
+		TestSmallestBucket(TEXT("All of parent, B"), MakeTags(ParentTag, TagB), false, TagB);
+		TestSmallestBucket(TEXT("All of A, D exact"), MakeTags(TagA, TagD), true, FGameplayTag());
+		TestSmallestBucket(TEXT("All of parent, A exact"), MakeTags(ParentTag, TagA), true, FGameplayTag());
+
+		int32 Visited = 0;
+		Registry.ForEachComponent(MakeTags(TagA, TagD), EGameplayContainerMatchType::All, true, [&Visited](UFlowComponent*)
+		{
+			Visited++;
+			return true;
+		});
+		TestCount(TEXT("Visited components of All of A, D exact"), Visited, 0);
+	}
+
+	Environment.Shutdown();
+
+	return !HasAnyErrors();
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
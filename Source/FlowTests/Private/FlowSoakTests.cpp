@@ -0,0 +1,236 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "FlowBenchmarkEnvironment.h"
+
+#include "FlowAsset.h"
+#include "FlowComponent.h"
+#include "Nodes/Route/FlowNode_Timer.h"
+
+#include "Dom/JsonObject.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Paths.h"
+#include "UObject/UObjectGlobals.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace FlowSoakTest
+{
+	// Timer nodes step once per simulated second, so every graph keeps signalling during the whole run
+	constexpr float StepTime = 1.0f;
+
+	// Samples taken before this fraction of the run aren't used, containers are allowed to fill up while graphs warm up
+	constexpr double WarmUpFraction = 0.25;
+
+	// Least squares slope of Values sampled at Hours
+	double GetSlope(const TArray<double>& Hours, const TArray<double>& Values, const int32 FirstSample)
+	{
+		const int32 Num = Hours.Num() - FirstSample;
+		if (Num < 2)
+		{
+			return 0.0;
+		}
+
+		double MeanHours = 0.0;
+		double MeanValue = 0.0;
+		for (int32 i = FirstSample; i < Hours.Num(); i++)
+		{
+			MeanHours += Hours[i];
+			MeanValue += Values[i];
+		}
+		MeanHours /= Num;
+		MeanValue /= Num;
+
+		double Covariance = 0.0;
+		double Variance = 0.0;
+		for (int32 i = FirstSample; i < Hours.Num(); i++)
+		{
+			Covariance += (Hours[i] - MeanHours) * (Values[i] - MeanValue);
+			Variance += FMath::Square(Hours[i] - MeanHours);
+		}
+
+		return Variance > 0.0 ? Covariance / Variance : 0.0;
+	}
+
+	struct FStructureSamples
+	{
+		TArray<double> Elements;
+		SIZE_T LastBytes = 0;
+	};
+}
+
+/**
+ * Keeps looping graphs running for hours of simulated time, and detects runtime containers growing without bound
+ * Usage: UnrealEditor-Cmd <Project> -nullrhi -ExecCmds="Automation RunTests Flow.Soak; Quit"
+ *        [-FlowSoakHours=4] [-FlowSoakTickRate=10] [-FlowSoakOwners=10] [-FlowSoakAsset=<Flow Asset path>]
+ *        [-FlowSoakSampleInterval=60] [-FlowSoakMaxGrowthPerHour=100] [-FlowSoakRealTime]
+ * Fails if growth of any sampled structure exceeds the threshold, given in elements per simulated hour, naming the structure
+ * Flow timers follow the virtual clock of Flow Subsystem and the world isn't ticked, so hours pass in minutes
+ * With -FlowSoakRealTime, the world is ticked instead, so timers run on the world timer manager
+ * Results are written in JSON to Saved/Automation/FlowSoak.json
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFlowSoakTest, "Flow.Soak", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::StressFilter)
+
+bool FFlowSoakTest::RunTest(const FString& Parameters)
+{
+	using namespace FlowSoakTest;
+
+	float Hours = 4.0f;
+	int32 TickRate = 10;
+	int32 Owners = 10;
+	float SampleInterval = 60.0f;
+	float MaxGrowthPerHour = 100.0f;
+	FString AssetPath;
+
+	const TCHAR* CommandLine = FCommandLine::Get();
+	FParse::Value(CommandLine, TEXT("FlowSoakHours="), Hours);
+	FParse::Value(CommandLine, TEXT("FlowSoakTickRate="), TickRate);
+	FParse::Value(CommandLine, TEXT("FlowSoakOwners="), Owners);
+	FParse::Value(CommandLine, TEXT("FlowSoakSampleInterval="), SampleInterval);
+	FParse::Value(CommandLine, TEXT("FlowSoakMaxGrowthPerHour="), MaxGrowthPerHour);
+	FParse::Value(CommandLine, TEXT("FlowSoakAsset="), AssetPath);
+	TickRate = FMath::Max(1, TickRate);
+	Owners = FMath::Max(1, Owners);
+	SampleInterval = FMath::Max(StepTime, SampleInterval);
+	const bool bVirtualTime = !FParse::Param(CommandLine, TEXT("FlowSoakRealTime"));
+
+	FFlowBenchmarkEnvironment Environment;
+	if (!Environment.Initialize())
+	{
+		AddError(TEXT("Flow soak test failed to create a world with Flow Subsystem"));
+		return false;
+	}
+
+	// enabled before starting graphs, so their timers are set on the virtual clock
+	Environment.GetFlowSubsystem()->SetVirtualTimeEnabled(bVirtualTime);
+
+	const FGameplayTag NotifierTag = FFlowBenchmarkEnvironment::GetIdentityTag(3);
+	const FGameplayTag NotifyTag = FFlowBenchmarkEnvironment::GetNotifyTag();
+
+	// representative graphs: recurring signals, re-triggered sequence, observers, and a content error repeated every step
+	TArray<UFlowAsset*> Graphs = {
+		Environment.CreateTimerGraph(StepTime, 4),
+		Environment.CreateSequenceGraph(StepTime, 2),
+		Environment.CreateObserverGraph(2, NotifierTag, NotifyTag)
+	};
+
+	UFlowAsset* ErrorGraph = Environment.CreateTimerGraph(StepTime, 1);
+	for (const TPair<FGuid, UFlowNode*>& Node : ErrorGraph->GetNodes())
+	{
+		if (Node.Value->IsA<UFlowNode_Timer>())
+		{
+			// "Timer already active"
+			FFlowBenchmarkEnvironment::Connect(Node.Value, TEXT("Step"), Node.Value, UFlowNode::DefaultInputPin.PinName);
+		}
+	}
+	Graphs.Add(ErrorGraph);
+
+	if (!AssetPath.IsEmpty())
+	{
+		UFlowAsset* Asset = LoadObject<UFlowAsset>(nullptr, *AssetPath);
+		if (Asset == nullptr)
+		{
+			AddError(FString::Printf(TEXT("Flow soak test couldn't load Flow Asset %s"), *AssetPath));
+			Environment.Shutdown();
+			return false;
+		}
+		Graphs.Add(Asset);
+	}
+
+	UFlowComponent* Notifier = Environment.SpawnFlowActor(FGameplayTagContainer(NotifierTag));
+	for (UFlowAsset* Graph : Graphs)
+	{
+		for (int32 i = 0; i < Owners; i++)
+		{
+			Environment.SpawnFlowActor(FGameplayTagContainer(), Graph);
+		}
+	}
+
+	const float DeltaSeconds = 1.0f / TickRate;
+	const int64 Frames = static_cast<int64>(Hours * 3600.0f * TickRate);
+	const int64 SampleFrames = FMath::Max<int64>(1, FMath::RoundToInt(SampleInterval * TickRate));
+	const int64 StepFrames = FMath::Max<int64>(1, FMath::RoundToInt(StepTime * TickRate));
+
+	AddInfo(FString::Printf(TEXT("Running %d graphs on %d owners each, for %.1f hours of simulated time"), Graphs.Num(), Owners, Hours));
+
+	FFlowBenchmarkResult FrameResult(TEXT("Soak.Frame"));
+	const double RunStartTime = FPlatformTime::Seconds();
+	TArray<double> SampleHours;
+	TMap<FString, FStructureSamples> Structures;
+	TMap<FString, FFlowBenchmarkMemorySample> Sample;
+
+	for (int64 Frame = 1; Frame <= Frames; Frame++)
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		if (Frame % StepFrames == 0)
+		{
+			Notifier->NotifyGraph(NotifyTag);
+		}
+		if (bVirtualTime)
+		{
+			Environment.AdvanceVirtualTime(DeltaSeconds);
+		}
+		else
+		{
+			Environment.Tick(DeltaSeconds);
+		}
+		FrameResult.Samples.Add(FPlatformTime::Seconds() - StartTime);
+
+		if (Frame % SampleFrames == 0)
+		{
+			Sample.Reset();
+			Environment.SampleRuntimeContainers(Sample);
+
+			SampleHours.Add(static_cast<double>(Frame) / TickRate / 3600.0);
+			for (const TPair<FString, FFlowBenchmarkMemorySample>& Structure : Sample)
+			{
+				FStructureSamples& Samples = Structures.FindOrAdd(Structure.Key);
+				Samples.Elements.Add(Structure.Value.Elements);
+				Samples.LastBytes = Structure.Value.Bytes;
+			}
+		}
+	}
+
+	const double RunTime = FPlatformTime::Seconds() - RunStartTime;
+	const int32 FirstSample = FMath::FloorToInt(SampleHours.Num() * WarmUpFraction);
+	bool bBounded = true;
+
+	TArray<TSharedPtr<FJsonValue>> StructureValues;
+	for (const TPair<FString, FStructureSamples>& Structure : Structures)
+	{
+		const double Slope = GetSlope(SampleHours, Structure.Value.Elements, FirstSample);
+		const bool bGrowing = Slope > MaxGrowthPerHour;
+
+		const TSharedRef<FJsonObject> Json = MakeShared<FJsonObject>();
+		Json->SetStringField(TEXT("Name"), Structure.Key);
+		Json->SetNumberField(TEXT("Elements"), Structure.Value.Elements.Num() > 0 ? Structure.Value.Elements.Last() : 0.0);
+		Json->SetNumberField(TEXT("Bytes"), Structure.Value.LastBytes);
+		Json->SetNumberField(TEXT("GrowthPerHour"), Slope);
+		Json->SetBoolField(TEXT("Bounded"), !bGrowing);
+		StructureValues.Add(MakeShared<FJsonValueObject>(Json));
+
+		if (bGrowing)
+		{
+			AddError(FString::Printf(TEXT("%s grows by %.1f elements per hour, threshold is %.1f"), *Structure.Key, Slope, MaxGrowthPerHour));
+			bBounded = false;
+		}
+	}
+
+	Environment.Shutdown();
+
+	const TSharedRef<FJsonObject> Report = MakeShared<FJsonObject>();
+	Report->SetNumberField(TEXT("Hours"), Hours);
+	Report->SetNumberField(TEXT("TickRate"), TickRate);
+	Report->SetNumberField(TEXT("Owners"), Owners);
+	Report->SetNumberField(TEXT("Graphs"), Graphs.Num());
+	Report->SetNumberField(TEXT("MaxGrowthPerHour"), MaxGrowthPerHour);
+	Report->SetBoolField(TEXT("VirtualTime"), bVirtualTime);
+	Report->SetNumberField(TEXT("SimulatedToRealTime"), RunTime > 0.0 ? Hours * 3600.0 / RunTime : 0.0);
+	Report->SetBoolField(TEXT("Bounded"), bBounded);
+	Report->SetArrayField(TEXT("Structures"), StructureValues);
+
+	const FString OutputFile = FPaths::Combine(FPaths::AutomationDir(), TEXT("FlowSoak.json"));
+	return FFlowBenchmarkResult::SaveReport(OutputFile, Report, {FrameResult}) && bBounded;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,23 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "FlowTestsModule.h"
+#include "FlowAllocationCounter.h"
+
+#include "Misc/CommandLine.h"
+#include "Modules/ModuleManager.h"
+
+void FFlowTestsModule::StartupModule()
+{
+	// wrapping the allocator costs every allocation in the process, so it's done only by processes measuring them
+	if (FParse::Param(FCommandLine::Get(), TEXT("FlowCountAllocations")))
+	{
+		FFlowScopedAllocationCounter::InstallAllocator();
+	}
+}
+
+void FFlowTestsModule::ShutdownModule()
+{
+}
+
+IMPLEMENT_MODULE(FFlowTestsModule, FlowTests)
+DEFINE_LOG_CATEGORY(LogFlowTests);
@@ -0,0 +1,22 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#pragma once
+
+#include "Commandlets/Commandlet.h"
+#include "FlowReplayCommandlet.generated.h"
+
+/**
+ * Re-executes Flow recording in a headless world, and compares graph results with the recorded ones
+ * Usage: UnrealEditor-Cmd <Project> -run=FlowReplay -nullrhi -Recording=<File> [-TickRate=30] [-Output=<File.json>]
+ * Recording is made by UFlowSubsystem::StartRecording and StopRecording, start it before starting Root Flows
+ */
+UCLASS()
+class FLOWTESTS_API UFlowReplayCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UFlowReplayCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
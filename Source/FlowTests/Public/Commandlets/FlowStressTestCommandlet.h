@@ -0,0 +1,23 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#pragma once
+
+#include "Commandlets/Commandlet.h"
+#include "FlowStressTestCommandlet.generated.h"
+
+/**
+ * Runs Flow Subsystem with many owners, nested SubGraphs and a busy component registry over simulated time
+ * Usage: UnrealEditor-Cmd <Project> -run=FlowStressTest -nullrhi [-Owners=10000] [-Depth=4] [-Asset=<Flow Asset path>]
+ *        [-Seconds=60] [-TickRate=30] [-NotifiesPerTick=100] [-TagChurnPerTick=50] [-SaveInterval=10] [-GCInterval=5] [-Seed=0] [-Output=<File.json>]
+ * Reports throughput, peak memory, percentiles of frame, save and garbage collection time, and breakdown of the worst frame
+ */
+UCLASS()
+class FLOWTESTS_API UFlowStressTestCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UFlowStressTestCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
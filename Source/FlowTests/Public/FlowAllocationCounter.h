@@ -0,0 +1,31 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Counts heap allocations made by the current thread for the lifetime of the scope
+ * Allocations made by other threads aren't counted, as they aren't caused by the measured code
+ * Requires the counting allocator, installed on startup of the FlowTests module with the -FlowCountAllocations switch
+ */
+class FLOWTESTS_API FFlowScopedAllocationCounter
+{
+public:
+	FFlowScopedAllocationCounter();
+	~FFlowScopedAllocationCounter();
+
+	uint64 GetAllocations() const { return Allocations; }
+
+	// Wraps the global allocator, the wrapper stays installed until process exit
+	static void InstallAllocator();
+	static bool IsAllocatorInstalled();
+
+private:
+	uint64 Allocations;
+
+	// Counter of the enclosing scope, it gets allocations of this scope too
+	FFlowScopedAllocationCounter* OuterCounter;
+
+	friend class FFlowCountingMalloc;
+};
@@ -0,0 +1,174 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#pragma once
+
+#include "GameplayTagContainer.h"
+#include "Templates/SubclassOf.h"
+#include "UObject/GCObject.h"
+#include "UObject/UnrealType.h"
+
+#include "Nodes/FlowNode.h"
+
+class AActor;
+class FJsonObject;
+class UFlowAsset;
+class UFlowComponent;
+class UFlowSubsystem;
+class UGameInstance;
+class UWorld;
+
+/**
+ * Timings of a single benchmark case, reported as percentiles
+ */
+struct FLOWTESTS_API FFlowBenchmarkResult
+{
+	FString Name;
+	TArray<double> Samples;
+
+	// Optional values describing the case, i.e. number of signals dispatched during a single sample
+	TMap<FString, double> Properties;
+
+	explicit FFlowBenchmarkResult(const FString& InName)
+		: Name(InName)
+	{
+	}
+
+	double GetPercentile(const double Percentile) const;
+	TSharedRef<FJsonObject> ToJson() const;
+
+	// Adds results to the report, and writes it to file given as -Output=<File.json> or to the log
+	static bool OutputReport(const FString& Params, const TSharedRef<FJsonObject>& Report, const TArray<FFlowBenchmarkResult>& Results);
+
+	// Adds results to the report, and writes it to the given file or to the log if the path is empty
+	static bool SaveReport(const FString& OutputFile, const TSharedRef<FJsonObject>& Report, const TArray<FFlowBenchmarkResult>& Results);
+};
+
+/**
+ * Size of a runtime container summed over all Flow instances
+ */
+struct FLOWTESTS_API FFlowBenchmarkMemorySample
+{
+	int64 Elements = 0;
+	SIZE_T Bytes = 0;
+};
+
+/**
+ * Headless game world with Flow Subsystem and synthetic Flow Assets, shared by Flow automation tests and commandlets
+ * Graphs are built directly from runtime nodes, without editor graph, so they can be created in any amount
+ */
+class FLOWTESTS_API FFlowBenchmarkEnvironment final : public FGCObject
+{
+public:
+	FFlowBenchmarkEnvironment();
+	virtual ~FFlowBenchmarkEnvironment() override;
+
+	// Creates game instance with a world without rendering, and begins play in it
+	bool Initialize();
+	void Shutdown();
+
+	UWorld* GetWorld() const;
+	UFlowSubsystem* GetFlowSubsystem() const;
+
+	void Tick(const float DeltaSeconds) const;
+
+	// Advances Flow virtual time without ticking the world, requires UFlowSubsystem::SetVirtualTimeEnabled
+	void AdvanceVirtualTime(const float DeltaSeconds) const;
+
+	// Samples runtime containers which aren't bounded by the graph itself, and may grow while instances keep running
+	void SampleRuntimeContainers(TMap<FString, FFlowBenchmarkMemorySample>& OutSamples) const;
+
+	// FGCObject
+	virtual void AddReferencedObjects(FReferenceCollector& Collector) override;
+	virtual FString GetReferencerName() const override;
+	// --
+
+//////////////////////////////////////////////////////////////////////////
+// Graphs
+
+	// Start -> Reroute x Length
+	UFlowAsset* CreateChainGraph(const int32 Length);
+
+	// Start -> Sequence -> Reroute x Width
+	UFlowAsset* CreateFanGraph(const int32 Width);
+
+	// Start -> Counter, with Step output leading back to Counter through Reroute, until Goal is reached
+	UFlowAsset* CreateLoopGraph(const int32 Iterations);
+
+	// Start -> SubGraph -> ... nested Depth times, the deepest graph is a chain of Length
+	UFlowAsset* CreateNestedGraph(const int32 Depth, const int32 Length);
+	UFlowAsset* CreateNestedGraph(const int32 Depth, UFlowAsset* DeepestGraph);
+
+	// Start -> Sequence -> On Notify From Actor x Observers, waiting for Notify Tag sent by actor with Identity Tag
+	UFlowAsset* CreateObserverGraph(const int32 Observers, const FGameplayTag& IdentityTag, const FGameplayTag& NotifyTag);
+
+	// Start -> Timer, never completing, with Step output leading to Reroute x Length every StepTime
+	UFlowAsset* CreateTimerGraph(const float StepTime, const int32 Length);
+
+	// Start -> Timer, never completing, with Step output re-triggering Sequence -> Reroute x Outputs
+	UFlowAsset* CreateSequenceGraph(const float StepTime, const int32 Outputs);
+
+	// Number of signals dispatched by a single run of graphs above
+	static int32 GetChainSignals(const int32 Length) { return Length; }
+	static int32 GetLoopSignals(const int32 Iterations) { return Iterations * 2 - 1; }
+
+	UFlowNode* AddNode(UFlowAsset* FlowAsset, const TSubclassOf<UFlowNode> NodeClass) const;
+	static void Connect(UFlowNode* From, const FName& OutputPin, const UFlowNode* To, const FName& InputPin);
+
+	template <typename T>
+	static void SetNodeProperty(UFlowNode* Node, const FName& PropertyName, const T& Value);
+
+	// Runtime fields aren't exposed to other modules, synthetic graphs access them just like the details panel would
+	template <typename T>
+	static T* GetPropertyValue(UObject* Object, const FName& PropertyName);
+
+	template <typename T>
+	static const T* GetPropertyValue(const UObject* Object, const FName& PropertyName)
+	{
+		return GetPropertyValue<T>(const_cast<UObject*>(Object), PropertyName);
+	}
+
+	// Signals node of running instance, as if the connected node triggered its output
+	static void TriggerInput(UFlowNode* Node, const FName& PinName);
+
+private:
+	UFlowAsset* CreateAsset(const FString& BaseName);
+
+//////////////////////////////////////////////////////////////////////////
+// Actors
+
+public:
+	// Spawns actor with Flow Component, optionally starting Root Flow on Begin Play
+	UFlowComponent* SpawnFlowActor(const FGameplayTagContainer& IdentityTags, UFlowAsset* RootFlow = nullptr) const;
+
+	// Tags registered by the benchmark module, so registry queries don't depend on project tags
+	static int32 GetIdentityTagsNum();
+	static FGameplayTag GetIdentityTag(const int32 Index);
+	static FGameplayTag GetIdentityParentTag();
+	static FGameplayTag GetNotifyTag();
+
+private:
+	UGameInstance* GameInstance;
+	TArray<UFlowAsset*> Assets;
+};
+
+template <typename T>
+void FFlowBenchmarkEnvironment::SetNodeProperty(UFlowNode* Node, const FName& PropertyName, const T& Value)
+{
+	// node properties are protected, synthetic graphs set them just like the details panel would
+	if (T* PropertyValue = GetPropertyValue<T>(Node, PropertyName))
+	{
+		*PropertyValue = Value;
+	}
+}
+
+template <typename T>
+T* FFlowBenchmarkEnvironment::GetPropertyValue(UObject* Object, const FName& PropertyName)
+{
+	const FProperty* Property = Object->GetClass()->FindPropertyByName(PropertyName);
+	if (ensure(Property && Property->GetElementSize() == sizeof(T)))
+	{
+		return Property->ContainerPtrToValuePtr<T>(Object);
+	}
+
+	return nullptr;
+}
@@ -0,0 +1,19 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#pragma once
+
+#include "Logging/LogMacros.h"
+#include "Modules/ModuleInterface.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogFlowTests, Log, All)
+
+/**
+ * Automation tests and headless commandlets measuring the Flow runtime
+ * Run tests with: UnrealEditor-Cmd <Project> -nullrhi -ExecCmds="Automation RunTests Flow.; Quit"
+ */
+class FFlowTestsModule final : public IModuleInterface
+{
+public:
+	virtual void StartupModule() override;
+	virtual void ShutdownModule() override;
+};